@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _CLOCKSYNC_H_
+#define _CLOCKSYNC_H_
+
+#include <ctime>
+#include <deque>
+#include <mutex>
+
+/**
+ * Class that estimates the offset of the sailonline.org clock against the
+ * local clock. Every sample bounds the offset to an interval: the server
+ * stamped its time (whole seconds, e.g. the HTTP Date header) at some moment
+ * between sending the request and receiving the answer. The estimate is the
+ * middle of the intersection of the recent intervals, so several samples are
+ * more precise than the one second resolution of each. Samples that don't
+ * fit the newer ones, e.g. after the local clock was set, are dropped.
+ * Thread safe.
+ */
+class ClockSync {
+public:
+  explicit ClockSync(size_t max_samples = 16);
+
+  /// Local clock, seconds since the epoch
+  static double LocalNow();
+
+  /// The server answered a request sent at local_send and received at
+  /// local_receive (local clock) with its time server_time
+  void AddSample(std::time_t server_time, double local_send,
+                 double local_receive);
+  /// The server had reached server_time when the answer arrived at
+  /// local_receive, e.g. the time of a boat state
+  void AddLowerBound(std::time_t server_time, double local_receive);
+
+  bool HasOffset() const;
+  /// Server clock minus local clock, seconds
+  double GetOffset() const;
+  /// Half the width of the interval of possible offsets, seconds
+  double GetUncertainty() const;
+  /// Shortest round trip time of the samples, seconds
+  double GetRoundTrip() const;
+
+  /// Server time for a local time
+  double ToServer(double local) const { return local + GetOffset(); }
+  /// Current time of the server, seconds since the epoch
+  std::time_t Now() const;
+
+private:
+  struct Sample {
+    double m_low;
+    double m_high;
+    double m_round_trip;  // Negative for lower bounds
+  };
+
+  size_t m_max_samples;
+  mutable std::mutex m_mutex;
+  std::deque<Sample> m_samples;
+
+  bool m_has_offset = false;
+  double m_low = 0.0;
+  double m_high = 0.0;
+  double m_round_trip = 0.0;
+
+  void Add(const Sample& sample);
+};
+
+#endif
@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DC_H_
+#define _DC_H_
+
+#include <ctime>
+
+/**
+ * Class that handles SOL delayed commands
+ */
+class Dc {
+public:
+  std::time_t m_timestamp;  // UTC, seconds since the epoch
+  double m_lat_start;
+  double m_lon_start;
+  double m_course;
+  double m_tws;           // True wind speed
+  double m_twa;           // True wind angle
+  double m_stw;           // Boat speed through water
+  double m_opt_upwind;    // Optimal angle for going upwind
+  double m_opt_downwind;  // Optimal angle for going downwind
+  double m_perf_begin;    // Performance directly after course change
+  double m_perf_end;      // Performance directly before next course change
+  bool m_is_twa;
+
+  Dc(const std::time_t m_timestamp, const double m_lat_start,
+     const double m_lon_start, const double m_course, const bool m_is_twa);
+};
+
+#endif
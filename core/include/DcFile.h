@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DCFILE_H_
+#define _DCFILE_H_
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Dc.h"
+#include "Providers.h"
+
+/**
+ * Namespace for reading and writing DC lists and tracks as files.
+ *
+ * DC lists use the format of the "Copy DCs" button, one DC per line:
+ *   YYYY/MM/DD HH:MM:SS cc|twa <course or TWA>
+ * optionally followed by the start position (latitude and longitude in
+ * degrees). Times are UTC. Empty lines and lines starting with '#' are
+ * ignored. Tracks are read and written as GPX 1.1.
+ *
+ * DC plans are stored in a compact binary format, see FormatDcPlan().
+ */
+namespace DcFile {
+/// Parse a DC list. DCs without start position get -1.0 (see
+/// DcModel::EnrichDcs()). Returns false and sets error on failure
+bool ParseDcList(const std::string& text, std::list<Dc>& dcs,
+                 std::string& error);
+
+/// Format a DC list, with the start positions that are known if positions
+/// is set
+std::string FormatDcList(const std::list<Dc>& dcs, bool positions = false);
+
+/// Format a DC list as binary plan: "SOLDCPLN", the format version and the
+/// number of DCs as uint32, then per DC the time (int64), a flag byte (TWA,
+/// start position known), the course or TWA and the start position if known
+/// (doubles). Little endian. Only what is planned is stored, the rest is
+/// derived by DcModel::EnrichDcs()
+std::string FormatDcPlan(const std::list<Dc>& dcs);
+
+/// Parse a binary plan. Returns false and sets error if data is not a plan,
+/// of another version or damaged
+bool ParseDcPlan(const std::string& data, std::list<Dc>& dcs,
+                 std::string& error);
+
+/// Parse the track points (<trkpt>) of a GPX file, all of which need a
+/// <time>. Returns false and sets error on failure
+bool ParseGpxTrack(const std::string& xml, std::vector<TrackPoint>& track,
+                   std::string& error);
+
+/// Format a GPX file with one track
+std::string FormatGpxTrack(const std::vector<TrackPoint>& track,
+                           const std::string& name);
+
+/// Collects the points delivered by DcModel::MakeTrack()
+class TrackRecorder : public TrackSink {
+public:
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    m_track.push_back({t, lat, lon});
+  }
+
+  std::vector<TrackPoint> m_track;
+};
+}  // namespace DcFile
+
+#endif
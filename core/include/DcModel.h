@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DCMODEL_H_
+#define _DCMODEL_H_
+
+#include <ctime>
+#include <list>
+#include <vector>
+
+#include "Dc.h"
+#include "Providers.h"
+
+/**
+ * Class that implements the algorithms on DC lists. Wind and boat data are
+ * requested from the providers, which must outlive the model.
+ */
+class DcModel {
+public:
+  /// Default distance (nm) the DCs of CompileDcs() may stray from the route
+  static constexpr double kRouteTolerance = 0.5;
+
+  /// Actual state of the boat, see SetAnchor()
+  struct Anchor {
+    std::time_t m_time;    // UTC
+    double m_lat;
+    double m_lon;
+    double m_course;       // Degrees
+    double m_twa;          // Degrees, positive: starboard tack
+    bool m_is_twa;         // Steering by TWA, otherwise by course
+    double m_performance;  // 0..1
+  };
+
+  /// The legs MakeTrack() sails: the DCs, or with an anchor the current leg
+  /// of the boat followed by the DCs after it
+  struct Plan {
+    std::list<Dc> m_legs;
+    double m_performance;   // Before the first leg, 0..1
+    double m_previous_twa;  // Degrees, sailed before the first leg
+  };
+
+  /// State of the boat at the start of a leg, before its course change
+  struct LegStart {
+    double m_lat;
+    double m_lon;
+    double m_performance;   // 0..1
+    double m_previous_twa;  // Degrees
+  };
+
+  DcModel(const WindProvider& wind, const PolarProvider& polar);
+
+  /// Simulate the DCs after the anchor time from the actual state of the
+  /// boat instead of their planned positions with full performance. DCs up
+  /// to the anchor time are history and left alone
+  void SetAnchor(const Anchor& anchor);
+
+  /// Replace the DC list by the fewest cc and twa DCs that keep the boat
+  /// within tolerance (nm) of the route, e.g. a weather routing track. TWA
+  /// legs are preferred where the wind allows the same or a longer leg. Linear
+  /// in the number of route points
+  void CompileDcs(const std::vector<TrackPoint>& route, double tolerance,
+                  std::list<Dc>& dcs) const;
+
+  /// Enrich the DC list with calculated values for diagnostic purposes
+  void EnrichDcs(std::list<Dc>& dcs) const;
+  /// Enrich only the DCs from first on, the ones before are up to date
+  void EnrichDcs(std::list<Dc>& dcs, std::list<Dc>::iterator first) const;
+  /// Try to shorten the DC list by joining legs with almost identical courses
+  void SimplifyDcs(std::list<Dc>& dcs) const;
+  /// Try to minimize performance loss when tacking and jibing
+  void OptimizeManeuvers(std::list<Dc>& dcs) const;
+  /// Create a track from the DC list
+  void MakeTrack(const std::list<Dc>& dcs, TrackSink& track) const;
+  /// The legs MakeTrack() would sail, e.g. to simulate them repeatedly
+  void MakePlan(const std::list<Dc>& dcs, Plan& plan) const;
+  /// Create a track from a plan, which may have been made by a model with
+  /// other providers. Doesn't allocate
+  void MakeTrack(const Plan& plan, TrackSink& track) const;
+  /// Continue a track at leg first of a plan, e.g. after changing the legs
+  /// from there on, with the state the boat had at its start (see
+  /// TrackSink::SetLegStart()). Doesn't allocate
+  void ContinueTrack(std::list<Dc>::const_iterator first,
+                     std::list<Dc>::const_iterator last, const LegStart& start,
+                     TrackSink& track) const;
+
+private:
+  const WindProvider& m_wind;
+  const PolarProvider& m_polar;
+  bool m_has_anchor = false;
+  Anchor m_anchor;
+
+  /// Sail the DCs [first, last) from start
+  void Simulate(std::list<Dc>::const_iterator first,
+                std::list<Dc>::const_iterator last, LegStart start,
+                TrackSink& track) const;
+};
+
+#endif
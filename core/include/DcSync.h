@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DCSYNC_H_
+#define _DCSYNC_H_
+
+#include <ctime>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Dc.h"
+#include "SolXml.h"
+
+/**
+ * Namespace for synchronizing the DC list of a race with the DC list on the
+ * server. Changes between two downloads are applied to the local list, so
+ * that unchanged DCs keep their enrichment and DCs planned locally are kept.
+ * DCs are identified by their time, as SOL allows only one DC per second.
+ */
+namespace DcSync {
+struct Change {
+  enum Kind { kAdded, kRemoved, kModified };
+  Kind m_kind;
+  // New state, old state for kRemoved. The ID is the one on the server, if
+  // the new state has none
+  SolXml::ServerDc m_dc;
+};
+
+/// The DCs after now as the server stores them, for Diff() against the
+/// server's list. Returns false and sets error if one of them can't be sent:
+/// more than one DC per second, or an invalid course or TWA
+bool ToServer(const std::list<Dc>& dcs, std::time_t now,
+              std::vector<SolXml::ServerDc>& server_dcs, std::string& error);
+
+/// Changes from old_dcs to new_dcs, both sorted by time
+std::vector<Change> Diff(const std::vector<SolXml::ServerDc>& old_dcs,
+                         const std::vector<SolXml::ServerDc>& new_dcs);
+
+/// Changes that turn the server's list into planned_dcs (see ToServer() at
+/// the same now). The DCs up to now were executed and stay as they are
+std::vector<Change> DiffUpload(const std::vector<SolXml::ServerDc>& server_dcs,
+                               const std::vector<SolXml::ServerDc>& planned_dcs,
+                               std::time_t now);
+
+/// Apply the changes (sorted by time) to dcs (sorted by time). Positions
+/// after the first change are reset, because the boat sails differently from
+/// there. Returns the first DC whose enrichment is outdated, dcs.end() if
+/// nothing changed
+std::list<Dc>::iterator Apply(const std::vector<Change>& changes,
+                              std::list<Dc>& dcs);
+}  // namespace DcSync
+
+#endif
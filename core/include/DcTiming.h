@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DCTIMING_H_
+#define _DCTIMING_H_
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "DcModel.h"
+#include "Providers.h"
+
+class ThreadPool;
+
+/// Bounds and steps of the DC timing optimizer
+struct DcTimingSettings {
+  double m_max_shift = 3600.0;       // Seconds a DC may move from its time
+  double m_time_step = 600.0;        // Seconds, first step
+  double m_min_time_step = 5.0;      // Seconds, last step
+  double m_max_course_change = 0.0;  // Degrees, 0 keeps courses and TWAs
+  double m_course_step = 2.0;        // Degrees, first step
+  double m_arrival_radius = 0.5;     // Nm
+  size_t m_max_simulations = 20000;
+  std::time_t m_min_time = 0;        // UTC, e.g. now plus the upload lead
+};
+
+struct DcTimingResult {
+  double m_eta_before;  // UTC, seconds since the epoch
+  double m_eta_after;
+  bool m_reached;       // The target within the arrival radius
+  size_t m_changed;     // DCs moved or turned
+  size_t m_simulations;
+};
+
+/**
+ * Class that moves the DCs of a plan in time, and optionally changes their
+ * courses and TWAs, so that the boat reaches a target (e.g. the next course
+ * waypoint) as early as possible. The ETA is the closest approach of the
+ * simulated track to the target once it comes within the arrival radius,
+ * otherwise the end of the track plus the time to sail the remaining
+ * distance there.
+ *
+ * Coordinate descent: for every DC a line of candidates, multiples of the
+ * step in either direction, is simulated in parallel on the thread pool and
+ * the best one is kept. When a pass over the DCs finds nothing better the
+ * steps are halved. Candidates only simulate the plan from the leg before
+ * the changed DC on, from the boat state cached there, and DCs after the
+ * arrival are left alone. The first leg (the start, or the current leg of
+ * the boat) and the DCs up to the minimum time are never changed, no DC is
+ * moved to or before it, and the DCs keep their order.
+ */
+class DcTiming {
+public:
+  /// Without pool the candidates are simulated on the calling thread
+  DcTiming(const WindProvider& wind, const PolarProvider& polar,
+           const DcTimingSettings& settings, ThreadPool* pool = nullptr);
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Optimize the legs of the plan (see DcModel::MakePlan()) for the
+  /// earliest arrival at the target
+  bool Optimize(DcModel::Plan& plan, double target_lat, double target_lon,
+                DcTimingResult& result);
+
+  /// ETA (UTC, seconds since the epoch) of a simulated track at the target,
+  /// as optimized. Segment receives the segment of the track that comes
+  /// within the radius, or the number of track points if none does
+  static double GetEta(const std::vector<TrackPoint>& points, double lat,
+                       double lon, double radius, size_t& segment);
+
+private:
+  const WindProvider& m_wind;
+  const PolarProvider& m_polar;
+  DcTimingSettings m_settings;
+  ThreadPool* m_pool;
+
+  std::vector<std::string> m_errors;
+};
+
+#endif
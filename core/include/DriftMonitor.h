@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DRIFTMONITOR_H_
+#define _DRIFTMONITOR_H_
+
+#include <cstddef>
+#include <ctime>
+#include <list>
+#include <vector>
+
+#include "Dc.h"
+#include "DcModel.h"
+#include "Providers.h"
+
+/**
+ * Class that compares the actual state of the boat with the plan. The plan
+ * is the track simulated from the DCs when they were set (see SetPlan()).
+ * Every update also checks the projection, the track simulated from the
+ * latest actual state forward (see DcModel::SetAnchor()). The projection is
+ * simulated again only if the boat left it, so an update costs a lookup
+ * while the boat sails as projected, and a simulation of the future DCs
+ * otherwise. Not thread safe.
+ */
+class DriftMonitor {
+public:
+  /// Deviation of the actual state from the plan
+  struct Drift {
+    std::time_t m_time;    // Of the actual state
+    double m_distance;     // nm, NAN if the plan doesn't cover m_time
+    double m_performance;  // Actual minus planned performance
+    bool m_exceeded;       // One of them beyond its limit
+  };
+
+  /// Default limits, nm and performance (0..1)
+  static constexpr double kMaxDistance = 1.0;
+  static constexpr double kMaxPerformance = 0.02;
+  /// Deviations from the projection that don't need a new simulation
+  static constexpr double kProjectionDistance = 0.05;
+  static constexpr double kProjectionPerformance = 0.002;
+
+  explicit DriftMonitor(double max_distance = kMaxDistance,
+                        double max_performance = kMaxPerformance);
+
+  /// The DCs changed: plan and projection start at the actual state
+  void SetPlan(const DcModel& model, const std::list<Dc>& dcs,
+               const DcModel::Anchor& actual);
+  bool HasPlan() const { return !m_plan.m_points.empty(); }
+
+  /// Compare the actual state with the plan, and simulate the DCs from it
+  /// again if it left the projection. Sets the plan if there is none
+  Drift Update(const DcModel& model, const std::list<Dc>& dcs,
+               const DcModel::Anchor& actual);
+
+  /// Track from the latest actual state forward
+  std::vector<TrackPoint> GetProjection() const;
+  /// Number of simulations since the plan was set
+  size_t GetSimulations() const { return m_simulations; }
+
+private:
+  /// Simulated track with the performance at the track points
+  class Track : public TrackSink {
+  public:
+    struct Point {
+      TrackPoint m_point;
+      double m_performance = 1.0;
+      double m_stw = 0.0;
+    };
+    std::vector<Point> m_points;
+
+    void AddTrackPoint(std::time_t t, double lat, double lon) override;
+    void SetPerformance(double performance, double stw) override;
+
+    /// Position and performance at time t, false if t is not covered
+    bool At(std::time_t t, TrackPoint& point, double& performance) const;
+  };
+
+  double m_max_distance;
+  double m_max_performance;
+  Track m_plan;
+  Track m_projection;
+  size_t m_simulations = 0;
+
+  void Project(const DcModel& model, const std::list<Dc>& dcs,
+               const DcModel::Anchor& actual);
+  /// Distance (nm) and performance difference of actual from track
+  static bool Compare(const Track& track, const DcModel::Anchor& actual,
+                      double& distance, double& performance);
+};
+
+#endif
@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _GEODESY_H_
+#define _GEODESY_H_
+
+#include <cmath>
+#include <cstddef>
+
+/**
+ * Namespace that encapsulates navigation on the earth sphere. Replaces the
+ * OpenCPN functions PositionBearingDistanceMercator_Plugin() and
+ * DistanceBearingMercator_Plugin(), with the same argument conventions.
+ * Distances are in nautical miles, angles in degrees.
+ *
+ * As on sailonline.org, boats sail rhumb lines (constant course), distances
+ * to marks are great circles. The batch function handles a whole track at
+ * once and shares the expensive terms between the points.
+ */
+namespace Geodesy {
+static constexpr double kDegToRad = M_PI / 180.0;
+static constexpr double kEarthRadiusNm = 3440.065;
+
+/// Normalize longitude difference to [-180, 180)
+inline double NormalizeLonDelta(double dlon) {
+  if (dlon >= 180.0) return dlon - 360.0;
+  if (dlon < -180.0) return dlon + 360.0;
+  return dlon;
+}
+
+/// Meridional part of a latitude (radians)
+inline double MercatorPsi(double lat) {
+  return std::log(std::tan(M_PI / 4 + lat * kDegToRad / 2));
+}
+
+/// Ratio of latitude difference to meridional parts difference. Falls back
+/// to cos(lat) on east-west courses
+inline double MercatorQ(double lat0, double lat1, double psi0, double psi1) {
+  double dlat = (lat1 - lat0) * kDegToRad;
+  double dpsi = psi1 - psi0;
+  return std::fabs(dpsi) > 1E-12 ? dlat / dpsi : std::cos(lat0 * kDegToRad);
+}
+
+inline double MercatorQ(double lat0, double lat1) {
+  return MercatorQ(lat0, lat1, MercatorPsi(lat0), MercatorPsi(lat1));
+}
+
+/// Position reached from (lat, lon) by sailing dist on rhumb line brg
+inline void PositionBearingDistanceMercator(double lat, double lon, double brg,
+                                            double dist, double* dlat,
+                                            double* dlon) {
+  double lat1 = lat + dist * std::cos(brg * kDegToRad) / kEarthRadiusNm /
+                          kDegToRad;
+  double q = MercatorQ(lat, lat1);
+  double dlon_deg =
+      dist * std::sin(brg * kDegToRad) / q / kEarthRadiusNm / kDegToRad;
+  *dlat = lat1;
+  *dlon = lon + dlon_deg;
+  if (*dlon >= 180.0)
+    *dlon -= 360.0;
+  else if (*dlon < -180.0)
+    *dlon += 360.0;
+}
+
+/// Rhumb line bearing and distance from (lat0, lon0) to (lat1, lon1).
+/// Note the argument order: destination first, as in OpenCPN
+inline void DistanceBearingMercator(double lat1, double lon1, double lat0,
+                                    double lon0, double* brg, double* dist) {
+  double dlat = (lat1 - lat0) * kDegToRad;
+  double dlon = NormalizeLonDelta(lon1 - lon0) * kDegToRad;
+  double q = MercatorQ(lat0, lat1);
+  double dpsi = std::fabs(q) > 0.0 ? dlat / q : 0.0;
+  double course = std::atan2(dlon, dpsi) / kDegToRad;
+  *brg = course < 0.0 ? course + 360.0 : course;
+  *dist = std::sqrt(dlat * dlat + q * q * dlon * dlon) * kEarthRadiusNm;
+}
+
+/// Great circle distance from (lat0, lon0) to (lat1, lon1), haversine
+/// formula
+inline double DistanceGreatCircle(double lat1, double lon1, double lat0,
+                                  double lon0) {
+  double sin_dlat = std::sin((lat1 - lat0) * kDegToRad / 2);
+  double sin_dlon = std::sin(NormalizeLonDelta(lon1 - lon0) * kDegToRad / 2);
+  double h = sin_dlat * sin_dlat + std::cos(lat0 * kDegToRad) *
+                                       std::cos(lat1 * kDegToRad) *
+                                       sin_dlon * sin_dlon;
+  return 2.0 * std::asin(std::sqrt(std::fmin(h, 1.0))) * kEarthRadiusNm;
+}
+
+/// Distance (nm) of the closest approach of the segment from (lat0, lon0) to
+/// (lat1, lon1) to (lat, lon), on a flat earth around (lat0, lon0). Fraction
+/// receives the point of the closest approach along the segment, 0..1
+inline double ClosestApproachFlat(double lat0, double lon0, double lat1,
+                                  double lon1, double lat, double lon,
+                                  double* fraction) {
+  double scale = 60.0 * std::cos(lat0 * kDegToRad);
+  double x1 = NormalizeLonDelta(lon1 - lon0) * scale;
+  double y1 = (lat1 - lat0) * 60.0;
+  double x = NormalizeLonDelta(lon - lon0) * scale;
+  double y = (lat - lat0) * 60.0;
+
+  double length2 = x1 * x1 + y1 * y1;
+  double f = length2 > 0.0
+                 ? std::fmin(std::fmax((x * x1 + y * y1) / length2, 0.0), 1.0)
+                 : 0.0;
+  *fraction = f;
+  return std::hypot(x - f * x1, y - f * y1);
+}
+
+/// DistanceBearingMercator() of the segments of a track of n points: brg[i]
+/// and dist[i] lead from point i to point i + 1, n - 1 each
+void TrackDistanceBearingMercator(size_t n, const double* lat,
+                                  const double* lon, double* brg,
+                                  double* dist);
+}  // namespace Geodesy
+
+#endif
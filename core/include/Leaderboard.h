@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _LEADERBOARD_H_
+#define _LEADERBOARD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Class that ranks the fleet of a race by the distance to finish (DTF) along
+ * the course. The cumulative distances of the legs are computed once, so the
+ * DTF of a boat is its great circle distance to its next waypoint plus the
+ * distance from there to the finish. Positions are kept as unit vectors,
+ * which makes that distance a chord and a single asin per boat. Their sines
+ * and cosines are carried from update to update, so that boats that moved
+ * a few miles need no trigonometry.
+ *
+ * Boats keep their next waypoint between updates: boats seen for the first
+ * time start on the leg they are closest to, the others only advance. A
+ * waypoint counts as rounded within the rounding radius, or once the boat is
+ * beyond the line through the waypoint across the leg leading to it.
+ * Finished boats rank first, in the order of the updates they finished in.
+ *
+ * The positions are passed as arrays. Parsing the fleet feed at the race
+ * <url> is left to the caller, its boat format is not pinned down yet. Not
+ * thread safe.
+ */
+class Leaderboard {
+public:
+  /// Nm
+  static constexpr double kRoundingRadius = 1.0;
+
+  /// Boat as ranked
+  struct Entry {
+    int64_t m_id;
+    double m_dtf;   // Nm, 0 if finished
+    size_t m_next;  // Index of the next waypoint, course size if finished
+  };
+
+  /// Course waypoints (latitude, longitude) from start to finish
+  explicit Leaderboard(const std::vector<std::pair<double, double>>& course,
+                       double radius = kRoundingRadius);
+
+  /// Positions of n boats, e.g. of a fleet refresh, identified by their ID.
+  /// Boats that are not updated keep their last position
+  void Update(size_t n, const int64_t* ids, const double* lat,
+              const double* lon);
+
+  size_t GetSize() const { return m_ids.size(); }
+
+  /// The first n boats of the ranking, leader first
+  void GetTop(size_t n, std::vector<Entry>& top);
+
+  /// Next waypoint of a boat seen for the first time at (lat, lon)
+  size_t GetNextWaypoint(double lat, double lon) const;
+  /// DTF (nm) at (lat, lon), heading for waypoint next
+  double GetDtf(double lat, double lon, size_t next) const;
+  /// Rank (1 = leader) of a boat with the given DTF among the fleet, e.g. of
+  /// our boat on the plan
+  size_t GetRank(double dtf) const;
+
+private:
+  double m_radius;
+  // Squared chord of the rounding radius
+  double m_radius_chord2;
+  // Waypoints, also as unit vectors with a sentinel behind the finish, the
+  // direction of the leg to them and their distance to the finish
+  std::vector<double> m_lat, m_lon;
+  std::vector<double> m_wx, m_wy, m_wz;
+  std::vector<double> m_tx, m_ty, m_tz;
+  std::vector<double> m_to_finish;
+
+  // Boats, in order of appearance
+  std::unordered_map<int64_t, uint32_t> m_index;
+  std::vector<int64_t> m_ids;
+  // Last position, its sines and cosines, and as unit vector
+  std::vector<double> m_pos_lat, m_pos_lon;
+  std::vector<double> m_sin_lat, m_cos_lat, m_sin_lon, m_cos_lon;
+  std::vector<double> m_x, m_y, m_z;
+  std::vector<uint32_t> m_next;
+  std::vector<double> m_dtf;
+  // Ranking key: DTF, below all DTFs for finished boats
+  std::vector<double> m_key;
+  uint32_t m_finished = 0;
+  // Boats by rank, as far as GetTop() sorted them
+  std::vector<uint32_t> m_order;
+
+  void Add(int64_t id, double lat, double lon);
+  /// Update the position of boat i. Small moves don't need trigonometry
+  void Move(uint32_t i, double lat, double lon);
+  /// Next waypoint at the end of the leg closest to (lat, lon)
+  size_t GetClosestLeg(double lat, double lon) const;
+  /// Advance boat i past the waypoints it has rounded
+  void Advance(uint32_t i);
+  /// Whether the unit vector (x, y, z) has rounded waypoint j
+  bool HasRounded(double x, double y, double z, size_t j) const;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _PERFORMANCE_H_
+#define _PERFORMANCE_H_
+
+/**
+ * Namespace that encapsulates the SOL performance model: Loss of performance
+ * on course changes, tacks and jibes, and recovery afterwards.
+ * Performance is a factor applied to the polar boat speed (1.0 = 100%).
+ */
+namespace Performance {
+// TODO duplicate code with WR plugin
+
+/// Use this to approximate zero TWA
+static constexpr double kTwaZero = 1E-3;
+
+/// Step width of the simulation (seconds)
+static constexpr double kStepSeconds = 30.0;
+
+// Performance loss is half the boat speed after the tack/jibe, in percent.
+double get_performance_loss_tack_jibe(const double stw);
+
+// Performance loss is ca. 0.07% per degree
+// Assumes that first_twa and next_twa have the same sign
+double get_performance_loss_course_change(const double first_twa,
+                                          const double next_twa);
+
+/// Performance after changing from first_twa to next_twa
+double get_performance(const double performance, const double theoretical_stw,
+                       const double first_twa, const double next_twa);
+
+/// Performance after recovering for step_seconds at the given boat speed
+double get_recovery_step(const double performance, const double step_seconds,
+                         const double stw);
+
+/// Performance after recovering for time_seconds
+double get_recovery(const double performance, const double time_seconds,
+                    const double theoretical_stw);
+}  // namespace Performance
+
+#endif
@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _PERFORMANCELEDGER_H_
+#define _PERFORMANCELEDGER_H_
+
+#include <ctime>
+#include <vector>
+
+#include "Providers.h"
+
+/**
+ * Track sink that accounts for the distance a simulation loses to the
+ * performance penalties of course changes, tacks and jibes and the recovery
+ * from them, leg by leg against a boat at full performance. Everything is
+ * passed on to the next sink, if there is one, so the ledger can be attached
+ * to any simulation (see DcModel::MakeTrack()) without extra lookups.
+ */
+class PerformanceLedger : public TrackSink {
+public:
+  /// Leg of a DC
+  struct Entry {
+    std::time_t m_time;    // Of the DC, UTC
+    double m_performance;  // After the course change, 0..1
+    double m_stw;          // Knots at full performance
+    double m_sailed;       // Nm
+    double m_ideal;        // Nm at full performance
+
+    /// Nm lost on the leg
+    double GetLoss() const { return m_ideal - m_sailed; }
+    /// Seconds the loss takes to sail at full performance
+    double GetLossSeconds() const {
+      return m_stw > 0.0 ? GetLoss() / m_stw * 3600.0 : 0.0;
+    }
+  };
+
+  explicit PerformanceLedger(TrackSink* next = nullptr) : m_next(next) {}
+
+  /// Forget the entries, e.g. before the next simulation
+  void Clear() { m_entries.clear(); }
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+  /// Entry of the DC at time t, nullptr if there is none
+  const Entry* Find(std::time_t t) const;
+  /// Nm and seconds lost on all legs
+  double GetTotalLoss() const;
+  double GetTotalLossSeconds() const;
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override;
+  void SetPerformance(double performance, double stw) override;
+  void SetLegStart(double performance, double previous_twa) override;
+  void SetLegDistance(double sailed, double ideal) override;
+
+private:
+  TrackSink* m_next;
+  std::vector<Entry> m_entries;
+  std::time_t m_time = 0;  // Of the last track point
+};
+
+#endif
@@ -0,0 +1,136 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _PLANHISTORY_H_
+#define _PLANHISTORY_H_
+
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Dc.h"
+#include "DcModel.h"
+
+/// A DC as planned, without the values DcModel::EnrichDcs() derives from
+/// the wind and the polar
+struct PlannedDc {
+  std::time_t m_timestamp;  // UTC
+  double m_value;           // Course or TWA
+  bool m_is_twa;
+  double m_lat_start;       // -1.0 if placed by DcModel::EnrichDcs()
+  double m_lon_start;
+
+  bool operator==(const PlannedDc& other) const {
+    return m_timestamp == other.m_timestamp && m_value == other.m_value &&
+           m_is_twa == other.m_is_twa && m_lat_start == other.m_lat_start &&
+           m_lon_start == other.m_lon_start;
+  }
+};
+
+/**
+ * Immutable DC plan. The DCs are stored in chunks that are shared by all
+ * snapshots of a PlanHistory that contain them, so copies are cheap and a
+ * changed plan only costs the chunks around its changes. Chunks end at DCs
+ * picked by their time, so inserting or removing a DC doesn't move the
+ * boundaries of the chunks around it.
+ */
+class PlanSnapshot {
+public:
+  size_t GetSize() const { return m_size; }
+  bool IsEmpty() const { return m_size == 0; }
+
+  /// The DCs of the plan with their start positions
+  void GetDcs(std::list<Dc>& dcs) const;
+  /// Same DCs as other, whatever the start position of the first DC
+  bool IsSame(const PlanSnapshot& other) const;
+
+private:
+  friend class PlanHistory;
+  using Chunk = std::vector<PlannedDc>;
+  using ChunkPtr = std::shared_ptr<const Chunk>;
+
+  std::vector<ChunkPtr> m_chunks;
+  size_t m_size = 0;
+  // Of the first DC, which follows the boat. Its chunk has -1.0 instead
+  double m_lat_start = -1.0;
+  double m_lon_start = -1.0;
+};
+
+/**
+ * Class that keeps the versions of a DC plan for undo and redo, and
+ * alternative plans the user wants to keep for comparison (see GetEtas()).
+ * All of them are PlanSnapshots, so the memory they take grows with the
+ * changes between them, not with the length of the plan.
+ */
+class PlanHistory {
+public:
+  static constexpr size_t kMaxUndo = 100;
+
+  /// Snapshot of dcs, sharing the chunks that are unchanged with the current
+  /// plan
+  PlanSnapshot MakeSnapshot(const std::list<Dc>& dcs) const;
+
+  /// Make dcs the current plan after an edit. The previous plan can be
+  /// restored by Undo(), undone plans can't be restored anymore. Returns
+  /// false if the DCs are the ones of the current plan
+  bool Commit(const std::list<Dc>& dcs);
+  const PlanSnapshot& GetCurrent() const { return m_current; }
+
+  bool CanUndo() const { return !m_undo.empty(); }
+  bool CanRedo() const { return !m_redo.empty(); }
+  /// Go back to the previous plan, whose DCs (see PlanSnapshot::GetDcs())
+  /// dcs receives. Returns false if there is none
+  bool Undo(std::list<Dc>& dcs);
+  /// Go forward to the plan undone last
+  bool Redo(std::list<Dc>& dcs);
+
+  /// Keep the current plan under name, replacing a plan kept under the same
+  /// name
+  void Keep(const std::string& name);
+  const std::vector<std::pair<std::string, PlanSnapshot>>& GetKept() const {
+    return m_kept;
+  }
+  /// Commit the plan kept as index i, so that it can be undone like an edit
+  bool Restore(size_t i, std::list<Dc>& dcs);
+
+  /// DCs stored for all plans, shared chunks counted once
+  size_t GetStoredDcs() const;
+
+  /// Simulated ETAs (UTC, seconds since the epoch) of a plan at the
+  /// waypoints (latitude, longitude) in order of the course: the closest
+  /// approach on the first segment of its track that comes within radius
+  /// (nm) of the waypoint, after the previous one is reached. NAN for the
+  /// waypoints it doesn't reach
+  static void GetEtas(const DcModel& model, const PlanSnapshot& plan,
+                      const std::vector<std::pair<double, double>>& waypoints,
+                      double radius, std::vector<double>& etas);
+
+private:
+  PlanSnapshot m_current;
+  std::deque<PlanSnapshot> m_undo;
+  std::vector<PlanSnapshot> m_redo;
+  std::vector<std::pair<std::string, PlanSnapshot>> m_kept;
+};
+
+#endif
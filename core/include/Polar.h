@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _POLAR_H_
+#define _POLAR_H_
+
+#include <string>
+#include <vector>
+
+#include "Providers.h"
+#include "SolXml.h"
+
+/**
+ * Class that handles the boat polar of a SOL race, as a matrix of boat speeds
+ * over TWA (rows) and TWS (columns)
+ */
+class Polar : public PolarProvider {
+public:
+  Polar() = default;
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Fill the matrix from the race polar. Returns false on format errors,
+  /// the polar is then empty
+  bool Parse(const SolXml::Vpp& vpp);
+
+  /// Export as CSV for the weather routing plugin ("twa/tws;<tws>..." header
+  /// line, then "<twa>;<bs>..." per row, TWS in knots)
+  bool WriteCsv(const std::string& path);
+
+  /// Compact binary cache of the matrix, see Polar.cpp for the format
+  bool SaveBinary(const std::string& path);
+  bool LoadBinary(const std::string& path);
+
+  bool IsEmpty() const { return m_bs.empty(); }
+
+  /// True wind speeds of the columns (knots)
+  const std::vector<double>& GetTws() const { return m_tws; }
+  /// True wind angles of the rows (degrees)
+  const std::vector<double>& GetTwa() const { return m_twa; }
+  /// Boat speed at row i_twa, column i_tws (knots)
+  double GetBs(size_t i_twa, size_t i_tws) const {
+    return m_bs[i_twa * m_tws.size() + i_tws];
+  }
+
+  // PolarProvider
+  /// Bilinear interpolation, clamped to the range of the polar
+  double GetSpeedThroughWater(double tws, double twa) const override;
+  /// Angles of best VMG, resolved on the TWA rows of the polar
+  std::pair<double, double> GetBoatOptimalAngles(double tws) const override;
+
+private:
+  std::vector<std::string> m_errors;
+
+  std::vector<double> m_tws;
+  std::vector<double> m_twa;
+  std::vector<double> m_bs;  // Row-major
+};
+
+#endif
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _PROVIDERS_H_
+#define _PROVIDERS_H_
+
+#include <cstddef>
+#include <ctime>
+#include <tuple>
+#include <utility>
+
+/**
+ * Interfaces through which the DC algorithms get wind and boat data, and
+ * deliver tracks. In the plugin they are implemented by messaging to the GRIB
+ * and weather routing plugins, elsewhere by the core classes (e.g. Polar).
+ */
+
+class WindProvider {
+public:
+  virtual ~WindProvider() = default;
+
+  /// True wind speed (knots) and true wind direction (degrees) at time t
+  /// (UTC). Returns {-1.0, -1.0} if no wind data is available
+  virtual std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                                double lon) const = 0;
+  /// GetWindData() of n points at once, e.g. of a whole track. Implemented
+  /// point by point unless overridden
+  virtual void GetWindDataBatch(size_t n, const std::time_t* t,
+                                const double* lat, const double* lon,
+                                double* tws, double* twd) const {
+    for (size_t i = 0; i < n; ++i)
+      std::tie(tws[i], twd[i]) = GetWindData(t[i], lat[i], lon[i]);
+  }
+};
+
+class PolarProvider {
+public:
+  virtual ~PolarProvider() = default;
+
+  /// Boat speed (knots). Returns -1.0 if no boat data is available
+  virtual double GetSpeedThroughWater(double tws, double twa) const = 0;
+  /// Optimal upwind angle (degrees), optimal downwind angle (degrees).
+  /// Returns {-1.0, -1.0} if no boat data is available
+  virtual std::pair<double, double> GetBoatOptimalAngles(double tws) const = 0;
+};
+
+/// Point of a track, e.g. as read from a GPX file
+struct TrackPoint {
+  std::time_t m_time;  // UTC
+  double m_lat;
+  double m_lon;
+};
+
+class TrackSink {
+public:
+  virtual ~TrackSink() = default;
+
+  /// Receives the track points in chronological order
+  virtual void AddTrackPoint(std::time_t t, double lat, double lon) = 0;
+  /// Receives the performance (0..1) after the course change at the last
+  /// track point and the boat speed (knots) at full performance from there.
+  /// Called by simulations only, ignored by default
+  virtual void SetPerformance(double performance, double stw) {}
+  /// Receives the performance (0..1) and the TWA (degrees) the boat had at
+  /// the last track point before its course change, see
+  /// DcModel::ContinueTrack(). Called by simulations only, ignored by default
+  virtual void SetLegStart(double performance, double previous_twa) {}
+  /// Receives the distance (nm) sailed on the leg from the last track point
+  /// and the distance at full performance. Called by simulations only,
+  /// ignored by default
+  virtual void SetLegDistance(double sailed, double ideal) {}
+};
+
+#endif
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _ROBUSTNESS_H_
+#define _ROBUSTNESS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DcModel.h"
+#include "Providers.h"
+
+class ThreadPool;
+
+/// Perturbations of the forecast, drawn from normal distributions per run
+struct RobustnessSettings {
+  size_t m_runs = 1000;
+  uint64_t m_seed = 1;
+  double m_speed_sigma = 0.1;       // Relative to the TWS
+  double m_direction_sigma = 10.0;  // Degrees
+  double m_time_sigma = 3.0;        // Hours the weather comes early or late
+  double m_wave_period = 12.0;      // Hours, of the varying part of the noise
+  double m_waypoint_radius = 1.0;   // Nm, closer counts as reached
+};
+
+/// ETA distribution at a waypoint. The ETA of a run is the time of its
+/// closest approach after the previous waypoint
+struct RobustnessEta {
+  std::time_t m_min;  // UTC
+  std::time_t m_p10;
+  std::time_t m_p50;
+  std::time_t m_p90;
+  std::time_t m_max;
+  double m_distance;  // Nm, median closest approach
+  size_t m_reached;   // Runs within the waypoint radius
+};
+
+/// Spread of the simulated boats (nm, standard deviation of the positions)
+/// over a leg of the plan
+struct RobustnessLeg {
+  std::time_t m_time;  // Of the DC, UTC
+  double m_spread_begin;
+  double m_spread_end;
+};
+
+struct RobustnessResult {
+  std::vector<RobustnessEta> m_etas;  // Per waypoint
+  std::vector<RobustnessLeg> m_legs;  // Per leg of the plan
+  /// Indices of m_legs, the DCs whose legs spread the boats most first
+  std::vector<size_t> m_sensitive;
+};
+
+/**
+ * Class that tests how robust a DC plan is against forecast errors (Monte
+ * Carlo). The plan is sailed many times, every run in its own perturbation
+ * of the forecast: the TWS is scaled and the TWD turned by a constant plus a
+ * slowly varying part, and the weather is shifted in time, so that fronts
+ * arrive early or late.
+ *
+ * Runs are spread over the thread pool, so the providers must be thread
+ * safe. Every run draws its perturbation from a generator seeded with the
+ * seed of the settings and the number of the run, so the result doesn't
+ * depend on the number of threads. Runs don't allocate.
+ */
+class Robustness {
+public:
+  /// Without pool the runs are sailed on the calling thread
+  Robustness(const WindProvider& wind, const PolarProvider& polar,
+             const RobustnessSettings& settings, ThreadPool* pool = nullptr);
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Sail the plan (see DcModel::MakePlan()) in every run and collect the
+  /// ETAs at the waypoints (latitude, longitude), in order of the course
+  bool Evaluate(const DcModel::Plan& plan,
+                const std::vector<std::pair<double, double>>& waypoints,
+                RobustnessResult& result);
+
+private:
+  const WindProvider& m_wind;
+  const PolarProvider& m_polar;
+  RobustnessSettings m_settings;
+  ThreadPool* m_pool;
+
+  std::vector<std::string> m_errors;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _ROUTER_H_
+#define _ROUTER_H_
+
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Providers.h"
+
+class ThreadPool;
+
+/// Parameters of the isochrone router
+struct RouterSettings {
+  double m_time_step = 3600.0;     // Seconds between isochrones
+  double m_heading_step = 5.0;     // Degrees between the headings of a fan
+  double m_sector = 1.0;           // Degrees, one node per bearing sector
+  double m_max_spread = 100.0;     // Degrees off the rhumb line to the target
+  double m_cell_size = 1.0;        // Nm, resolution of the reached grid
+  double m_arrival_radius = 0.5;   // Nm
+  size_t m_max_isochrones = 2000;  // Per leg
+};
+
+/// Point of a route, with the course sailed from there to the next point
+struct RoutePoint {
+  std::time_t m_time;    // UTC
+  double m_lat;
+  double m_lon;
+  double m_course;       // Degrees
+  double m_twa;          // Degrees, positive: starboard tack
+  double m_performance;  // At m_time, after a course change there
+};
+
+/**
+ * Class that calculates the fastest route through a list of waypoints with
+ * the isochrone method, including the SOL performance loss on course changes,
+ * tacks and jibes (see Performance).
+ *
+ * Each isochrone is expanded by a fan of headings, plus the direct course to
+ * the waypoint, from every node of the previous one. Expansion runs on the
+ * thread pool, so the providers must be thread safe. The new isochrone keeps
+ * the farthest node per bearing sector from the leg start, and drops nodes in
+ * cells of a grid that was reached by an earlier isochrone already. There is
+ * no land avoidance.
+ */
+class Router {
+public:
+  /// Without pool the expansion runs on the calling thread
+  Router(const WindProvider& wind, const PolarProvider& polar,
+         const RouterSettings& settings, ThreadPool* pool = nullptr);
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Route from start through all waypoints (latitude, longitude). The route
+  /// contains a point per isochrone and ends at the last waypoint. Returns
+  /// false if a waypoint can't be reached
+  bool Route(const TrackPoint& start,
+             const std::vector<std::pair<double, double>>& waypoints,
+             std::vector<RoutePoint>& route);
+
+private:
+  const WindProvider& m_wind;
+  const PolarProvider& m_polar;
+  RouterSettings m_settings;
+  ThreadPool* m_pool;
+
+  std::vector<std::string> m_errors;
+
+  /// Route a single leg from the last point of route, which contains the
+  /// TWA and performance on arrival there. Sets its course, TWA and
+  /// performance for the leg and appends the points of the leg
+  bool RouteLeg(double lat, double lon, std::vector<RoutePoint>& route);
+};
+
+#endif
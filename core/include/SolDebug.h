@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SOLDEBUG_H_
+#define _SOLDEBUG_H_
+
+// Debug output that is compiled in for DEBUG_BUILD only
+
+#ifdef DEBUG_BUILD
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#define DEBUGSL(x)                                 \
+  do {                                             \
+    time_t now = time(0);                          \
+    tm* localtm = localtime(&now);                 \
+    char* stime = asctime(localtm);                \
+    stime[strlen(stime) - 1] = 0;                  \
+    std::cout << stime << " : " << x << std::endl; \
+  } while (0)
+
+#define DEBUGST(x)                    \
+  do {                                \
+    time_t now = time(0);             \
+    tm* localtm = localtime(&now);    \
+    char* stime = asctime(localtm);   \
+    stime[strlen(stime) - 1] = 0;     \
+    std::cout << stime << " : " << x; \
+  } while (0)
+
+#define DEBUGCONT(x) \
+  do {               \
+    std::cout << x;  \
+  } while (0)
+
+#define DEBUGEND(x)              \
+  do {                           \
+    std::cout << x << std::endl; \
+  } while (0)
+#else
+#define DEBUGSL(x) \
+  do {             \
+  } while (0)
+#define DEBUGST(x) \
+  do {             \
+  } while (0)
+#define DEBUGCONT(x) \
+  do {               \
+  } while (0)
+#define DEBUGEND(x) \
+  do {              \
+  } while (0)
+#endif
+
+#endif
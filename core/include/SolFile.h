@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SOLFILE_H_
+#define _SOLFILE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Namespace for whole-file I/O of the caches and exports. Files are written
+ * to a temporary file next to the target and renamed, so readers never see a
+ * half-written file, even if the plugin crashes while writing.
+ */
+namespace SolFile {
+/// Read the whole file. Returns false if it can't be read
+bool Read(const std::string& path, std::string& contents);
+
+/// Create the directory path and its missing parents. Returns false if it
+/// doesn't exist afterwards
+bool CreateDirectories(const std::string& path);
+
+/// Write contents to a temporary file next to path, unique per write, flush it
+/// to disk and rename it to path. Returns false and sets error on failure,
+/// path is then unchanged
+bool WriteAtomic(const std::string& path, const std::string& contents,
+                 std::string& error);
+
+/**
+ * Read-only memory mapping of a whole file, for caches that are used in
+ * place instead of being parsed. The data are page aligned.
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// Map the file. Returns false if it can't be mapped
+  bool Open(const std::string& path);
+  void Close();
+
+  const char* GetData() const { return m_data; }
+  size_t GetSize() const { return m_size; }
+
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  void* m_mapping = nullptr;
+#endif
+};
+
+/**
+ * Writes files with WriteAtomic() on a worker thread, so that saving after
+ * every edit costs the caller only a copy of the contents. A newer version of
+ * a file replaces the one still queued, and contents that are already on disk
+ * are not written again. Only their size and hash are kept for that.
+ */
+class BackgroundWriter {
+public:
+  BackgroundWriter();
+  /// Writes what is queued before returning
+  ~BackgroundWriter();
+
+  BackgroundWriter(const BackgroundWriter&) = delete;
+  BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+  /// Queue contents for path
+  void Write(const std::string& path, std::string contents);
+  /// Wait until everything queued is written
+  void Flush();
+
+  /// Return error messages of the writes so far and clear the error store
+  std::vector<std::string> GetErrors();
+
+private:
+  void Run();
+
+  std::mutex m_mutex;
+  std::condition_variable m_queued;
+  std::condition_variable m_idle;
+  std::map<std::string, std::string> m_queue;
+  // Size and hash of the last contents written per path
+  std::map<std::string, std::pair<size_t, uint64_t>> m_written;
+  // Path being written, empty if none
+  std::string m_writing;
+  bool m_stop = false;
+  std::vector<std::string> m_errors;
+  std::thread m_thread;
+};
+}  // namespace SolFile
+
+#endif
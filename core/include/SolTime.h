@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SOLTIME_H_
+#define _SOLTIME_H_
+
+#include <ctime>
+#include <string>
+
+/**
+ * Namespace for the timestamps used by sailonline.org, which are always UTC
+ * and formatted as "YYYY/MM/DD HH:MM:SS". Does not depend on the time zone of
+ * the machine.
+ */
+namespace SolTime {
+/// Seconds since the epoch for a UTC calendar date and time
+std::time_t FromUtc(int year, int month, int day, int hour, int minute,
+                    int second);
+
+/// Parse "YYYY/MM/DD HH:MM:SS" (also accepts '-' and 'T' as in ISO 8601).
+/// Returns false if the string is not a timestamp
+bool ParseUtc(const std::string& text, std::time_t& t);
+
+/// Format as "YYYY/MM/DD HH:MM:SS"
+std::string FormatUtc(std::time_t t);
+
+/// Format as ISO 8601, e.g. for GPX: "YYYY-MM-DDTHH:MM:SSZ"
+std::string FormatIso8601(std::time_t t);
+}  // namespace SolTime
+
+#endif
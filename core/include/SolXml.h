@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SOLXML_H_
+#define _SOLXML_H_
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * Namespace that encapsulates parsing of the XML files served by
+ * sailonline.org. See Race::GetRaceInfo() for a description of the contents.
+ */
+namespace SolXml {
+/// Entry of races.xml
+struct RaceEntry {
+  std::string m_id;
+  std::string m_name;
+  std::string m_description;
+  std::string m_message;
+  std::string m_start;
+  std::string m_url;
+};
+
+/// Course waypoint of auth_raceinfo_<id>.xml
+struct Waypoint {
+  std::string m_order;
+  std::string m_name;
+  double m_lat;
+  double m_lon;
+};
+
+/// Boat polar of auth_raceinfo_<id>.xml, unparsed
+struct Vpp {
+  std::string m_name;
+  // TWS: Space-separated list of true wind speeds (columns, integer, m/s)
+  std::string m_tws_splined;
+  // TWA: Space-separated list of true wind angles (rows, integer, degrees)
+  std::string m_twa_splined;
+  // BS: Semicolon-separated list of space-separated lists of boat speeds
+  std::string m_bs_splined;
+};
+
+/// Contents of auth_raceinfo_<id>.xml
+struct RaceInfo {
+  Vpp m_vpp;
+  std::vector<Waypoint> m_course;
+  std::string m_url;
+  std::string m_weatherurl;
+  std::string m_traceurl;
+  std::string m_boaturl;
+};
+
+/// DC of the logged in boat, as stored on the server
+struct ServerDc {
+  std::string m_id;
+  std::time_t m_time;  // UTC
+  bool m_is_twa;
+  double m_value;  // Course or TWA, degrees
+};
+
+/// Current state of the logged in boat, from the text file at <boaturl>
+struct BoatState {
+  std::time_t m_time;    // UTC, when the server calculated the state
+  double m_lat;
+  double m_lon;
+  double m_stw;          // Boat speed (knots)
+  double m_performance;  // 0..1
+  bool m_is_twa;         // Steering by TWA, otherwise by course
+  double m_value;        // TWA or course, degrees
+};
+
+/// Latest forecast of the race, from the text file at <weatherurl>
+struct WeatherInfo {
+  std::string m_id;
+  std::time_t m_time;  // UTC, when the forecast was published
+  std::string m_url;   // Weather XML, see WindGrid
+};
+
+/// Parse the list of races. Returns false and sets error on failure
+bool ParseRaceList(const std::string& xml, std::vector<RaceEntry>& races,
+                   std::string& error);
+
+/// Parse the detailed race information. Returns false and sets error on
+/// failure
+bool ParseRaceInfo(const std::string& xml, RaceInfo& info, std::string& error);
+
+/// Parse the DC list of the boat, sorted by time. Returns false and sets
+/// error on failure
+bool ParseDcList(const std::string& xml, std::vector<ServerDc>& dcs,
+                 std::string& error);
+
+/// Parse the boat state. Not XML, but a single line of text. Returns false
+/// and sets error on failure
+bool ParseBoatState(const std::string& text, BoatState& state,
+                    std::string& error);
+
+/// Parse the weather info. Not XML, but an id, a time stamp and a URL.
+/// Returns false and sets error on failure
+bool ParseWeatherInfo(const std::string& text, WeatherInfo& info,
+                      std::string& error);
+
+/// Parse the number at p in the C locale, whatever the locale of the
+/// application, and advance p behind it. Numbers of up to 15 significant
+/// digits and small exponents, like those of polars and forecasts, are
+/// converted exactly with a single rounding, the others by a stream in the
+/// classic locale. Returns false if there is no number at p
+bool ParseNumber(const char*& p, const char* end, double& value);
+}  // namespace SolXml
+
+#endif
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _STARTSWEEP_H_
+#define _STARTSWEEP_H_
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DcModel.h"
+#include "Providers.h"
+#include "Router.h"
+
+class ThreadPool;
+
+struct StartSweepSettings {
+  std::time_t m_interval = 1800;  // Seconds between departures
+  double m_arrival_radius = 0.5;  // Nm, of the target of DC lists
+  RouterSettings m_router;        // Of the routes through the course
+};
+
+/// Result of a departure. The arrival is NAN if the wind data ran out, or no
+/// route was found
+struct Departure {
+  std::time_t m_time;  // UTC
+  double m_arrival;    // UTC, seconds since the epoch
+
+  double GetDuration() const { return m_arrival - m_time; }
+};
+
+/**
+ * Class that finds the best start window of a race with a flexible start,
+ * e.g. a record. Departures every interval of a time window are sailed in
+ * parallel on the thread pool, either with a DC list as template, shifted
+ * to the departure, or by routing through the course (see Router). The
+ * providers are shared by all departures and must be thread safe.
+ */
+class StartSweep {
+public:
+  /// Without pool the departures are sailed on the calling thread
+  StartSweep(const WindProvider& wind, const PolarProvider& polar,
+             const StartSweepSettings& settings, ThreadPool* pool = nullptr);
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Sail the legs of the plan (see DcModel::MakePlan()), shifted to every
+  /// departure from begin to end, to the target. The arrival is the ETA of
+  /// DcTiming
+  bool SweepDcs(const DcModel::Plan& plan, std::time_t begin, std::time_t end,
+                double target_lat, double target_lon,
+                std::vector<Departure>& departures);
+  /// Route from start through the waypoints (latitude, longitude) for every
+  /// departure from begin to end
+  bool SweepRoutes(double start_lat, double start_lon,
+                   const std::vector<std::pair<double, double>>& waypoints,
+                   std::time_t begin, std::time_t end,
+                   std::vector<Departure>& departures);
+
+  /// Index of the departure with the shortest duration, the size of
+  /// departures if none arrives
+  static size_t GetBest(const std::vector<Departure>& departures);
+
+private:
+  const WindProvider& m_wind;
+  const PolarProvider& m_polar;
+  StartSweepSettings m_settings;
+  ThreadPool* m_pool;
+
+  std::vector<std::string> m_errors;
+
+  /// Departures from begin to end, false if there are none
+  bool MakeDepartures(std::time_t begin, std::time_t end,
+                      std::vector<Departure>& departures);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Class that runs tasks on a fixed number of worker threads. Tasks still
+ * queued when the pool is destroyed are run before the workers are joined.
+ * A pool without workers runs every task immediately in the submitting
+ * thread.
+ */
+class ThreadPool {
+public:
+  /// Start the given number of workers, by default one per core
+  explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t GetSize() const { return m_workers.size(); }
+
+  /// Queue a task. The future delivers its result
+  template <typename F>
+  auto Submit(F&& task) -> std::future<decltype(task())> {
+    auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(
+        std::forward<F>(task));
+    auto result = packaged->get_future();
+    Push([packaged]() { (*packaged)(); });
+    return result;
+  }
+
+  /// Call body(i) for every i in [0, n) on the workers and the calling thread.
+  /// Returns when all calls have finished. May be nested, because the calling
+  /// thread takes part in the work instead of only waiting
+  template <typename F>
+  void ParallelFor(size_t n, F&& body) {
+    if (n == 0) return;
+
+    struct State {
+      std::atomic<size_t> m_next{0};
+      size_t m_done = 0;
+      std::mutex m_mutex;
+      std::condition_variable m_finished;
+    };
+    auto state = std::make_shared<State>();
+    auto run = [state, n, &body]() {
+      size_t done = 0;
+      for (size_t i = state->m_next++; i < n; i = state->m_next++) {
+        body(i);
+        ++done;
+      }
+      if (done == 0) return;
+      std::lock_guard<std::mutex> lock(state->m_mutex);
+      state->m_done += done;
+      if (state->m_done == n) state->m_finished.notify_all();
+    };
+
+    // Helpers that start after all indices are taken return immediately, so
+    // body is never called after ParallelFor has returned
+    size_t helpers = std::min(GetSize(), n - 1);
+    for (size_t i = 0; i < helpers; ++i) Push(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(state->m_mutex);
+    state->m_finished.wait(lock, [&]() { return state->m_done == n; });
+  }
+
+private:
+  std::vector<std::thread> m_workers;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_stopping = false;
+
+  void Push(std::function<void()> task);
+  void Work();
+};
+
+#endif
@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _TRACESTORE_H_
+#define _TRACESTORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Providers.h"
+
+/**
+ * Class that keeps the traces of the fleet of a race compactly, e.g. for
+ * playback or analysis of a race of several weeks. Positions are quantized to
+ * kResolution (about a meter) and times to seconds. Every point is stored as
+ * the change of its difference to the previous point of the boat, zigzag
+ * encoded as varints. At a steady refresh rate a boat on a steady course
+ * needs about three bytes per point, instead of the 24 of a TrackPoint or the
+ * dozens of the server's XML.
+ *
+ * Every kBlockPoints points of a trace start a block with an absolute first
+ * point. The blocks are indexed by their first time, so that a point in time
+ * is found by binary search and only the blocks covering the requested times
+ * are decoded, up to the last point needed. Nothing is decoded when loading.
+ *
+ * The points are appended by the caller. The plugin doesn't download the
+ * traces of the fleet yet, so reading the server's trace format is left to
+ * that download. Not thread safe.
+ */
+class TraceStore {
+public:
+  /// Points per block
+  static constexpr size_t kBlockPoints = 64;
+  /// Degrees per quantization step
+  static constexpr double kResolution = 1e-5;
+
+  std::vector<std::string> GetErrors();
+
+  void Clear() { m_traces.clear(); }
+
+  /// Append a point to the trace of a boat. Points not after the last point
+  /// of the boat are skipped and return false, so that overlapping refreshes
+  /// of the traces can be appended as they are
+  bool Append(int64_t id, const TrackPoint& point);
+
+  /// IDs of the boats, ascending
+  std::vector<int64_t> GetBoats() const;
+  size_t GetPointCount(int64_t id) const;
+  /// Times of the first and last point of a trace. Returns false for unknown
+  /// boats
+  bool GetTimeRange(int64_t id, std::time_t& first, std::time_t& last) const;
+  /// Append the points of a trace from begin to end (inclusive) to points
+  void GetTrace(int64_t id, std::time_t begin, std::time_t end,
+                std::vector<TrackPoint>& points) const;
+  /// Position of a boat at time t, interpolated between the points around
+  /// it. Returns false outside the trace
+  bool GetPosition(int64_t id, std::time_t t, double& lat, double& lon) const;
+  /// Bytes used by the encoded traces and their block indexes
+  size_t GetEncodedSize() const;
+
+  /// Binary file with the encoded traces as they are in memory
+  bool Save(const std::string& path);
+  bool Load(const std::string& path);
+
+private:
+  /// Index entry of a block, with its first point
+  struct Block {
+    int64_t m_time;
+    int32_t m_lat;  // In units of kResolution
+    int32_t m_lon;
+    uint32_t m_offset;  // Of the second point in the data of the trace
+    uint32_t m_count;   // Points including the first
+  };
+
+  struct Trace {
+    std::vector<Block> m_blocks;
+    std::string m_data;
+    size_t m_count = 0;
+    // Last point, quantized, and its differences to the point before, the
+    // base of the next point
+    int64_t m_time = 0;
+    int32_t m_lat = 0;
+    int32_t m_lon = 0;
+    int64_t m_dt = 0;
+    int64_t m_dlat = 0;
+    int64_t m_dlon = 0;
+  };
+
+  std::vector<std::string> m_errors;
+  std::map<int64_t, Trace> m_traces;
+
+  /// Decode block b of trace up to the point for which visit(time, lat, lon)
+  /// returns false, or up to the end of its data if that is damaged
+  template <typename Visitor>
+  static void Decode(const Trace& trace, size_t b, Visitor&& visit);
+  /// Index of the block containing time t, or the number of blocks if t is
+  /// before the trace
+  static size_t FindBlock(const Trace& trace, std::time_t t);
+};
+
+#endif
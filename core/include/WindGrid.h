@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _WINDGRID_H_
+#define _WINDGRID_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Providers.h"
+#include "WindKernel.h"
+
+/**
+ * Class that holds the wind forecast of a race on a regular latitude /
+ * longitude grid, as served by sailonline.org in the weather XML file (see
+ * Race::GetRaceInfo()). The file contains the grid geometry
+ *   <lat_n_points>, <lon_n_points>, <lat_start>, <lon_start>,
+ *   <lat_increment>, <lon_increment> (degrees)
+ * and a list of <frame target_time="YYYY/MM/DD HH:MM:SS"> elements with the
+ * wind components <U> and <V> (m/s), one row of longitudes per latitude, rows
+ * separated by ';'.
+ *
+ * Wind data are interpolated linearly in space and time, in batches by
+ * WindKernel. The class is immutable after Parse() or LoadBinary(), so
+ * GetWindData() can be called from many threads. Copies share the wind data.
+ */
+class WindGrid : public WindProvider {
+public:
+  std::vector<std::string> GetErrors();
+
+  /// Parse the weather XML file. Returns false on failure, see GetErrors()
+  bool Parse(const std::string& xml);
+
+  /// Binary cache of the grid. The cache is mapped into memory by
+  /// LoadBinary() and used in place, so loading takes no parsing and no
+  /// copying of the wind data
+  bool SaveBinary(const std::string& path);
+  bool LoadBinary(const std::string& path);
+
+  bool IsEmpty() const { return m_times.empty(); }
+  /// Time of the first and the last forecast frame (UTC)
+  std::time_t GetStartTime() const { return m_times.front(); }
+  std::time_t GetEndTime() const { return m_times.back(); }
+
+  std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                        double lon) const override;
+  void GetWindDataBatch(size_t n, const std::time_t* t, const double* lat,
+                        const double* lon, double* tws,
+                        double* twd) const override;
+
+  /// Kernel level of the batches, the best one of the CPU by default. For
+  /// comparisons, level must be supported by the CPU
+  void SetKernelLevel(WindKernel::Level level) { m_level = level; }
+
+private:
+  std::vector<std::string> m_errors;
+
+  double m_lat_start = 0.0;
+  double m_lon_start = 0.0;
+  double m_lat_increment = 0.0;
+  double m_lon_increment = 0.0;
+  size_t m_lat_n_points = 0;
+  size_t m_lon_n_points = 0;
+  bool m_wraps = false;  // Grid covers all longitudes
+
+  std::vector<std::time_t> m_times;
+  // Wind components (m/s), index (frame * m_lat_n_points + lat) *
+  // m_lon_n_points + lon. They point into m_storage: the parsed vectors or
+  // the mapped cache file
+  const float* m_u = nullptr;
+  const float* m_v = nullptr;
+  std::shared_ptr<const void> m_storage;
+  WindKernel::Level m_level = WindKernel::GetBestLevel();
+
+  void Clear();
+  /// Check that the kernel can index all values
+  bool CheckSize();
+};
+
+#endif
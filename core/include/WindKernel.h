@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _WINDKERNEL_H_
+#define _WINDKERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Namespace for the batch interpolation of wind grids (see WindGrid). The
+ * points are interpolated trilinearly in the U and V components and
+ * converted to speed and direction, with AVX2, SSE4.1 or scalar code as the
+ * CPU supports. All levels compute the same single precision operations in
+ * the same order, so they return the same results.
+ */
+namespace WindKernel {
+enum class Level { kScalar, kSse41, kAvx2 };
+
+/// Grid the kernel reads, index (frame * lat_n + lat) * lon_n + lon
+struct Grid {
+  const float* m_u;  // m/s
+  const float* m_v;
+  int32_t m_lat_n;
+  int32_t m_lon_n;
+  bool m_wraps;  // Longitudes wrap around the globe
+};
+
+/// Points in grid coordinates, prepared by WindGrid. Longitudes of wrapping
+/// grids are in [0, lon_n), the others in [0, lon_n - 1], latitudes in
+/// [0, lat_n - 1]. A negative time weight marks a point outside the grid
+struct Points {
+  const float* m_lat;
+  const float* m_lon;
+  const int32_t* m_frame0;  // Offsets of the frames before and after
+  const int32_t* m_frame1;
+  const float* m_w_time;  // Weight of the frame after
+};
+
+/// Best level of this CPU, detected once
+Level GetBestLevel();
+const char* GetName(Level level);
+
+/// True wind speed (knots) and direction (degrees) of n points, {-1, -1}
+/// outside the grid. level must be supported by the CPU
+void Interpolate(const Grid& grid, const Points& points, size_t n,
+                 double* tws, double* twd, Level level);
+}  // namespace WindKernel
+
+#endif
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "ClockSync.h"
+
+ClockSync::ClockSync(size_t max_samples)
+    : m_max_samples(std::max<size_t>(1, max_samples)) {}
+
+double ClockSync::LocalNow() {
+  return std::chrono::duration<double>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void ClockSync::AddSample(std::time_t server_time, double local_send,
+                          double local_receive) {
+  if (local_receive < local_send) return;
+
+  // The server time is truncated to whole seconds
+  Add({server_time - local_receive, server_time + 1.0 - local_send,
+       local_receive - local_send});
+}
+
+void ClockSync::AddLowerBound(std::time_t server_time, double local_receive) {
+  Add({server_time - local_receive, std::numeric_limits<double>::infinity(),
+       -1.0});
+}
+
+bool ClockSync::HasOffset() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_has_offset;
+}
+
+double ClockSync::GetOffset() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_has_offset ? 0.5 * (m_low + m_high) : 0.0;
+}
+
+double ClockSync::GetUncertainty() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_has_offset ? 0.5 * (m_high - m_low)
+                      : std::numeric_limits<double>::infinity();
+}
+
+double ClockSync::GetRoundTrip() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_round_trip;
+}
+
+std::time_t ClockSync::Now() const {
+  return static_cast<std::time_t>(std::floor(ToServer(LocalNow())));
+}
+
+void ClockSync::Add(const Sample& sample) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_samples.push_back(sample);
+  if (m_samples.size() > m_max_samples) m_samples.pop_front();
+
+  // Intersect from the newest sample back, the first sample that doesn't fit
+  // drops all older ones
+  double low = -std::numeric_limits<double>::infinity();
+  double high = std::numeric_limits<double>::infinity();
+  double round_trip = std::numeric_limits<double>::infinity();
+  size_t used = 0;
+  for (auto it = m_samples.rbegin(); it != m_samples.rend(); ++it, ++used) {
+    double new_low = std::max(low, it->m_low);
+    double new_high = std::min(high, it->m_high);
+    if (new_low > new_high) break;
+    low = new_low;
+    high = new_high;
+    if (it->m_round_trip >= 0.0)
+      round_trip = std::min(round_trip, it->m_round_trip);
+  }
+  m_samples.erase(m_samples.begin(), m_samples.end() - used);
+
+  // Lower bounds alone don't give an offset
+  m_has_offset = std::isfinite(low) && std::isfinite(high);
+  if (m_has_offset) {
+    m_low = low;
+    m_high = high;
+    m_round_trip = round_trip;
+  }
+}
@@ -0,0 +1,291 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+#include <pugixml.hpp>
+
+#include "DcFile.h"
+#include "SolTime.h"
+
+namespace {
+/// Escape the characters that are not allowed in XML character data
+std::string escaped(const std::string& text) {
+  std::string result;
+  result.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        result.append("&amp;");
+        break;
+      case '<':
+        result.append("&lt;");
+        break;
+      case '>':
+        result.append("&gt;");
+        break;
+      default:
+        result.push_back(c);
+    }
+  }
+  return result;
+}
+
+static constexpr char kPlanMagic[8] = {'S', 'O', 'L', 'D', 'C', 'P', 'L', 'N'};
+static constexpr uint32_t kPlanVersion = 1;
+static constexpr size_t kPlanHeaderSize =
+    sizeof(kPlanMagic) + 2 * sizeof(uint32_t);
+static constexpr uint8_t kPlanTwa = 1;
+static constexpr uint8_t kPlanPosition = 2;
+
+void append_uint(std::string& out, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i) out.push_back(char(value >> (8 * i)));
+}
+
+void append_double(std::string& out, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  append_uint(out, bits, sizeof(bits));
+}
+
+/// Reads little endian values from a binary plan, with bounds checks
+class PlanReader {
+public:
+  explicit PlanReader(const std::string& data)
+      : m_p(data.data()), m_end(m_p + data.size()) {}
+
+  bool ReadUint(uint64_t& value, size_t size) {
+    if (size_t(m_end - m_p) < size) return false;
+    value = 0;
+    for (size_t i = 0; i < size; ++i)
+      value |= uint64_t(static_cast<unsigned char>(m_p[i])) << (8 * i);
+    m_p += size;
+    return true;
+  }
+
+  bool ReadDouble(double& value) {
+    uint64_t bits;
+    if (!ReadUint(bits, sizeof(bits))) return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+
+  bool AtEnd() const { return m_p == m_end; }
+
+private:
+  const char* m_p;
+  const char* m_end;
+};
+}  // namespace
+
+namespace DcFile {
+
+bool ParseDcList(const std::string& text, std::list<Dc>& dcs,
+                 std::string& error) {
+  dcs.clear();
+
+  std::istringstream stream(text);
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(stream, line)) {
+    ++line_number;
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+
+    std::istringstream fields(line.substr(first));
+    std::string date, time, type;
+    double course;
+    std::time_t timestamp;
+    if (!(fields >> date >> time >> type >> course) ||
+        !SolTime::ParseUtc(date + " " + time, timestamp) ||
+        (type != "cc" && type != "twa")) {
+      error = "Format error in DC list, line " + std::to_string(line_number);
+      dcs.clear();
+      return false;
+    }
+
+    double lat = -1.0, lon = -1.0;
+    if (!(fields >> lat >> lon)) lat = lon = -1.0;
+
+    dcs.emplace_back(Dc{timestamp, lat, lon, course, type == "twa"});
+    if (dcs.size() > 1 &&
+        dcs.back().m_timestamp <= std::prev(dcs.end(), 2)->m_timestamp) {
+      error = "DC list not sorted by time, line " + std::to_string(line_number);
+      dcs.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string FormatDcList(const std::list<Dc>& dcs, bool positions) {
+  std::string result;
+  char course[32], position[64];
+  for (const auto& dc : dcs) {
+    std::snprintf(course, sizeof(course), "%03.3f",
+                  dc.m_is_twa ? dc.m_twa : dc.m_course);
+    result.append(SolTime::FormatUtc(dc.m_timestamp))
+        .append(dc.m_is_twa ? " twa " : " cc ")
+        .append(course);
+    if (positions && (dc.m_lat_start != -1.0 || dc.m_lon_start != -1.0)) {
+      std::snprintf(position, sizeof(position), " %.6f %.6f", dc.m_lat_start,
+                    dc.m_lon_start);
+      result.append(position);
+    }
+    result.append("\n");
+  }
+  return result;
+}
+
+std::string FormatDcPlan(const std::list<Dc>& dcs) {
+  std::string data;
+  data.reserve(kPlanHeaderSize + dcs.size() * 33);
+  data.append(kPlanMagic, sizeof(kPlanMagic));
+  append_uint(data, kPlanVersion, sizeof(uint32_t));
+  append_uint(data, dcs.size(), sizeof(uint32_t));
+  for (const auto& dc : dcs) {
+    bool position = dc.m_lat_start != -1.0 || dc.m_lon_start != -1.0;
+    append_uint(data, static_cast<uint64_t>(dc.m_timestamp), sizeof(int64_t));
+    data.push_back(char((dc.m_is_twa ? kPlanTwa : 0) |
+                        (position ? kPlanPosition : 0)));
+    append_double(data, dc.m_is_twa ? dc.m_twa : dc.m_course);
+    if (position) {
+      append_double(data, dc.m_lat_start);
+      append_double(data, dc.m_lon_start);
+    }
+  }
+  return data;
+}
+
+bool ParseDcPlan(const std::string& data, std::list<Dc>& dcs,
+                 std::string& error) {
+  dcs.clear();
+  if (data.size() < kPlanHeaderSize ||
+      std::memcmp(data.data(), kPlanMagic, sizeof(kPlanMagic)) != 0) {
+    error = "Not a DC plan";
+    return false;
+  }
+
+  PlanReader reader(data);
+  uint64_t magic, version, count;
+  reader.ReadUint(magic, sizeof(magic));
+  reader.ReadUint(version, sizeof(uint32_t));
+  reader.ReadUint(count, sizeof(uint32_t));
+  if (version != kPlanVersion) {
+    error = "DC plan of unknown version " + std::to_string(version);
+    return false;
+  }
+
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t timestamp, flags;
+    double value, lat = -1.0, lon = -1.0;
+    if (!reader.ReadUint(timestamp, sizeof(int64_t)) ||
+        !reader.ReadUint(flags, 1) || !reader.ReadDouble(value) ||
+        ((flags & kPlanPosition) &&
+         (!reader.ReadDouble(lat) || !reader.ReadDouble(lon))) ||
+        (!dcs.empty() &&
+         static_cast<std::time_t>(timestamp) <= dcs.back().m_timestamp)) {
+      error = "Damaged DC plan at DC " + std::to_string(i + 1);
+      dcs.clear();
+      return false;
+    }
+    dcs.emplace_back(Dc{static_cast<std::time_t>(timestamp), lat, lon, value,
+                        (flags & kPlanTwa) != 0});
+  }
+  if (!reader.AtEnd()) {
+    error = "Damaged DC plan, data after the last DC";
+    dcs.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool ParseGpxTrack(const std::string& xml, std::vector<TrackPoint>& track,
+                   std::string& error) {
+  track.clear();
+
+  pugi::xml_document gpx_doc;
+  auto status = gpx_doc.load_buffer(xml.data(), xml.size());
+  if (!status) {
+    error = std::string("Could not parse GPX file: ") + status.description();
+    return false;
+  }
+
+  pugi::xml_node node_trk = gpx_doc.child("gpx").child("trk");
+  for (pugi::xml_node node_trkseg = node_trk.child("trkseg");
+       node_trkseg != nullptr;
+       node_trkseg = node_trkseg.next_sibling("trkseg")) {
+    for (pugi::xml_node node_trkpt = node_trkseg.child("trkpt");
+         node_trkpt != nullptr;
+         node_trkpt = node_trkpt.next_sibling("trkpt")) {
+      TrackPoint point;
+      if (!SolTime::ParseUtc(node_trkpt.child_value("time"), point.m_time)) {
+        error = "GPX track point " + std::to_string(track.size() + 1) +
+                " has no valid time";
+        track.clear();
+        return false;
+      }
+      point.m_lat = node_trkpt.attribute("lat").as_double();
+      point.m_lon = node_trkpt.attribute("lon").as_double();
+      track.push_back(point);
+    }
+  }
+
+  if (track.size() < 2) {
+    error = "GPX file contains no track with at least two points";
+    return false;
+  }
+
+  return true;
+}
+
+std::string FormatGpxTrack(const std::vector<TrackPoint>& track,
+                           const std::string& name) {
+  std::string result =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<gpx version=\"1.1\" creator=\"sailonline_pi\" "
+      "xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+      "  <trk>\n"
+      "    <name>" +
+      escaped(name) +
+      "</name>\n"
+      "    <trkseg>\n";
+
+  char point[128];
+  for (const auto& p : track) {
+    std::snprintf(point, sizeof(point),
+                  "      <trkpt lat=\"%.6f\" lon=\"%.6f\"><time>%s</time>"
+                  "</trkpt>\n",
+                  p.m_lat, p.m_lon, SolTime::FormatIso8601(p.m_time).c_str());
+    result.append(point);
+  }
+
+  result.append(
+      "    </trkseg>\n"
+      "  </trk>\n"
+      "</gpx>\n");
+  return result;
+}
+}  // namespace DcFile
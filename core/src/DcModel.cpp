@@ -0,0 +1,641 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <tuple>
+
+#include "SolDebug.h"
+#include "DcModel.h"
+#include "Geodesy.h"
+#include "Performance.h"
+
+using namespace Performance;
+
+namespace {
+double normalize_angle(double angle) {
+  angle = std::fmod(angle, 360.0);
+  if (angle > 180.0) return angle - 360.0;
+  if (angle <= -180.0) return angle + 360.0;
+  return angle;
+}
+
+/// Values of a course or TWA that keep a leg within the tolerance. Sailing
+/// the constant angle a instead of the angles a_i of the route segments of
+/// length l_i, the boat is off the route by about sum(l_i * (a_i - a)) after
+/// each segment (small angles), so every segment narrows the interval of a
+class LegFit {
+public:
+  /// Start an empty leg
+  void Reset() {
+    m_empty = true;
+    m_valid = true;
+    m_sum = m_length = 0.0;
+  }
+
+  bool IsEmpty() const { return m_empty; }
+
+  /// Add the next segment of the route. Returns false if no angle keeps the
+  /// leg within tolerance anymore
+  bool Add(double angle, double length, double tolerance) {
+    if (!m_valid) return false;
+    if (m_empty) {
+      // Angles are relative to the first segment to avoid the wrap at 360
+      m_reference = angle;
+      m_low = -180.0;
+      m_high = 180.0;
+      m_empty = false;
+    }
+
+    double tolerance_deg = tolerance * 180.0 / M_PI;
+    m_sum += length * normalize_angle(angle - m_reference);
+    m_length += length;
+    double low = std::max(m_low, (m_sum - tolerance_deg) / m_length);
+    double high = std::min(m_high, (m_sum + tolerance_deg) / m_length);
+    if (low > high) {
+      m_valid = false;
+      return false;
+    }
+
+    m_low = low;
+    m_high = high;
+    return true;
+  }
+
+  /// Angle in the middle of the interval of the leg so far
+  double GetAngle() const {
+    return normalize_angle(m_reference + 0.5 * (m_low + m_high));
+  }
+
+private:
+  bool m_empty = true;
+  bool m_valid = true;
+  double m_reference = 0.0;
+  double m_sum = 0.0;
+  double m_length = 0.0;
+  double m_low = -180.0;
+  double m_high = 180.0;
+};
+}  // namespace
+
+DcModel::DcModel(const WindProvider& wind, const PolarProvider& polar)
+    : m_wind(wind), m_polar(polar) {}
+
+void DcModel::SetAnchor(const Anchor& anchor) {
+  m_anchor = anchor;
+  m_has_anchor = true;
+}
+
+void DcModel::CompileDcs(const std::vector<TrackPoint>& route,
+                         double tolerance, std::list<Dc>& dcs) const {
+  dcs.clear();
+  if (route.size() < 2) return;
+
+  // The positions are known, so the segments and the wind of all points are
+  // calculated at once
+  std::vector<std::time_t> times(route.size());
+  std::vector<double> lats(route.size()), lons(route.size());
+  for (size_t i = 0; i < route.size(); ++i) {
+    times[i] = route[i].m_time;
+    lats[i] = route[i].m_lat;
+    lons[i] = route[i].m_lon;
+  }
+  std::vector<double> twss(route.size()), twds(route.size());
+  m_wind.GetWindDataBatch(route.size(), times.data(), lats.data(), lons.data(),
+                          twss.data(), twds.data());
+  std::vector<double> bearings(route.size() - 1), lengths(route.size() - 1);
+  Geodesy::TrackDistanceBearingMercator(route.size(), lats.data(), lons.data(),
+                                        bearings.data(), lengths.data());
+
+  // Course and TWA legs are extended segment by segment, and the leg that
+  // lasts longer becomes the DC when both fail. The next leg starts with the
+  // failing segment, so every segment is visited once. A tack or jibe always
+  // ends a leg, averaging over it could give an angle that can't be sailed
+  LegFit cc, twa;
+  cc.Reset();
+  twa.Reset();
+  size_t leg_begin = 0;
+  size_t cc_end = 0, twa_end = 0;  // Segments covered so far
+  double cc_angle = 0.0, twa_angle = 0.0;
+  int leg_tack = 0;  // 1: starboard, -1: port, 0: not known yet
+
+  auto emit = [&](size_t end) {
+    const TrackPoint& p = route[leg_begin];
+    bool is_twa = twa_end >= cc_end;
+    double value = is_twa ? twa_angle : cc_angle;
+    if (!is_twa && value < 0.0) value += 360.0;
+    dcs.emplace_back(Dc{p.m_time, p.m_lat, p.m_lon, value, is_twa});
+
+    leg_begin = end;
+    cc_end = twa_end = end;
+    leg_tack = 0;
+    cc.Reset();
+    twa.Reset();
+  };
+
+  for (size_t i = 0; i + 1 < route.size(); ++i) {
+    double bearing = bearings[i], length = lengths[i];
+    if (length <= 0.0) {
+      // Standing still fits every leg
+      if (cc_end == i) cc_end = i + 1;
+      if (twa_end == i) twa_end = i + 1;
+      continue;
+    }
+
+    bool has_wind = twss[i] >= 0.0;
+    double segment_twa = normalize_angle(twds[i] - bearing);
+    int tack = !has_wind ? 0 : (segment_twa >= 0.0 ? 1 : -1);
+
+    auto extend = [&]() {
+      if (tack != 0 && leg_tack != 0 && tack != leg_tack) return false;
+      bool cc_ok = cc_end == i && cc.Add(bearing, length, tolerance);
+      bool twa_ok =
+          twa_end == i && has_wind && twa.Add(segment_twa, length, tolerance);
+      if (cc_ok) {
+        cc_end = i + 1;
+        cc_angle = cc.GetAngle();
+      }
+      if (twa_ok) {
+        twa_end = i + 1;
+        twa_angle = twa.GetAngle();
+      }
+      if (leg_tack == 0) leg_tack = tack;
+      return cc_ok || twa_ok;
+    };
+
+    // A single segment always fits a new course leg
+    if (!extend()) {
+      emit(i);
+      extend();
+    }
+  }
+
+  // Last leg, unless the boat only stands still there
+  if (!cc.IsEmpty()) emit(route.size() - 1);
+}
+
+void DcModel::SimplifyDcs(std::list<Dc>& dcs) const {
+  if (dcs.size() < 2) return;
+
+  // TODO This must use the functionality already implemented in WR plugin to
+  // simplify the route
+
+  // Current leg is from first_dc to last_dc
+  auto first_dc = dcs.begin();  // First DC of a leg
+  auto second_dc =
+      first_dc;  // Required because std::list does not allow first_dc + 1
+  ++second_dc;
+  auto last_dc = dcs.begin();  // Last DC that was investigated
+
+  for (auto dc = second_dc; dc != dcs.end();) {
+    double diff_course = std::fabs(dc->m_course - first_dc->m_course);
+    double diff_twa = std::fabs(dc->m_twa - first_dc->m_twa);
+    if (diff_course > 360.0) diff_course -= 360.0;
+    if (diff_twa > 360.0) diff_twa -= 360.0;
+
+    // Check for minimal course or twa changes and delete unnecessary waypoints
+    // TODO Make limits for course/twa change configurable and maybe depend on
+    // distance between waypoints (how detailed was the WR?)
+    // TODO No land collision check!!!
+    DEBUGSL("First DC: " << first_dc->m_course << ", TWA " << first_dc->m_twa
+                         << ", last DC: " << last_dc->m_course << ", TWA "
+                         << last_dc->m_twa << ", this DC: " << dc->m_course
+                         << ", TWA " << dc->m_twa);
+
+    if (diff_course < 2.0 && (!first_dc->m_is_twa || first_dc == last_dc)) {
+      DEBUGSL("Continuing current leg because of minimal course change");
+      first_dc->m_is_twa = false;
+      if (last_dc != first_dc)
+        last_dc = dcs.erase(last_dc);
+      else
+        last_dc = dc;
+      dc = last_dc;
+      ++dc;
+    } else if (diff_twa < 1.0 && (first_dc->m_is_twa || first_dc == last_dc)) {
+      DEBUGSL("Continuing current leg because of minimal twa change");
+      first_dc->m_is_twa = true;
+      if (last_dc != first_dc)
+        last_dc = dcs.erase(last_dc);
+      else
+        last_dc = dc;
+      dc = last_dc;
+      ++dc;
+    } else {
+      // Calculate new course / TWA
+      if (first_dc != last_dc) {
+        first_dc->m_twa =
+            0.5 *
+            (first_dc->m_twa +
+             last_dc
+                 ->m_twa);  // TODO calculate exact twa that will bring us from
+                            // start to end waypoint when course is finalized
+        double new_dist;
+        Geodesy::DistanceBearingMercator(
+            last_dc->m_lat_start, last_dc->m_lon_start, first_dc->m_lat_start,
+            first_dc->m_lon_start, &first_dc->m_course, &new_dist);
+        DEBUGSL("Wrote DC: " << first_dc->m_course << ", TWA "
+                             << first_dc->m_twa);
+        first_dc = last_dc;
+        // Note: dc must not be incremented, leg between first_dc and dc has not
+        // been investigated yet
+      } else {
+        DEBUGSL("Wrote DC: " << first_dc->m_course << ", TWA "
+                             << first_dc->m_twa);
+        first_dc = dc;
+        last_dc = dc;
+        ++dc;
+      }
+    }
+  }
+}
+
+namespace {
+// Course change required to reach 93% performance is ca. 100.3 degrees
+// Add 6 seconds of performance recovery at 5kn
+// TODO Make that precise in calculation below
+// TODO Give safety margin for weather beyond next forecast
+static constexpr double max_recovery = 6.0 * 3.0 / (20.0 * 5.0) / 100.0;
+static constexpr double course_change_for_max_loss =
+    (0.07 + max_recovery) * 180.0 / M_PI * 25.0;
+}  // namespace
+
+void DcModel::OptimizeManeuvers(std::list<Dc>& dcs) const {
+  // Note: This assumes that EnrichDcs() has been called
+  // TODO If this is called twice on the same list, it will create duplicate
+  // TWAs
+  // Note: This assumes a symmetric polar throughout
+  // Note: A course change of exactly 180 degrees will be treated as a tack
+  // (not sure what SOL does)
+  // TODO Take into account that performance may not be 100% to start with
+  if (dcs.empty()) return;
+
+  double first_twa = dcs.begin()->m_twa;
+  auto second_dc = dcs.begin();
+  ++second_dc;
+
+  for (auto p_dc = second_dc; p_dc != dcs.end(); ++p_dc) {
+    double next_twa = p_dc->m_twa;
+    double sign = first_twa > 0.0 ? 1.0 : -1.0;
+    DEBUGSL("      DC course" << p_dc->m_course
+                              << ": Checking course change TWA=" << first_twa
+                              << " to " << next_twa);
+
+    if (first_twa * next_twa > 0) {
+      // Course change. Performance loss is ca. 0.07% per degree
+      // TODO Optimize by calculating performance recovery to reach exactly 93%
+      if (std::fabs(next_twa - first_twa) > course_change_for_max_loss) {
+        // Note: std::list::emplace() does not invalidate any iterators
+        // Note: Two seconds difference is required to preserve the order of the
+        // DCs
+        dcs.emplace(p_dc,
+                    Dc{p_dc->m_timestamp - 2, -1.0, -1.0,
+                       first_twa + sign * course_change_for_max_loss, true});
+        // ... and the existing dc finalizes the course change to next_twa
+      }
+    } else if (std::fabs(first_twa - next_twa) > 180.0) {
+      // Jibe
+      /* The performance loss for a jibe is half the boat speed after the jibe,
+       * in percent. The performance loss for a course change (without jibe) is
+       * ca. 0.07% per degree There are two possible strategies:
+       * 1. Drive performance just below the 93% limit by two course changes.
+       *    Then jibe to next_twa without further performance loss.
+       *    This only makes sense if boat speed after the jibe is greater than
+       * 14 knots, because in this case the jibe performance loss would be
+       * greater than 7%
+       * 2. Jibe to TWA 180 degrees, then harden in to next_twa
+       *    This only makes sense if the added performance loss for jibe and
+       * course change is less than the performance loss for directly jibing to
+       * next_twa
+       */
+      double stw_before_wind = m_polar.GetSpeedThroughWater(p_dc->m_tws, 180.0);
+      double next_stw = m_polar.GetSpeedThroughWater(p_dc->m_tws, next_twa);
+      DEBUGSL("Optimizing jibe, speed twa 180=" << stw_before_wind
+                                                << ", speed after jibe="
+                                                << next_stw);
+
+      if (next_stw > 14.0) {
+        // Strategy 1
+        // TODO Optimize by calculating performance recovery to reach exactly
+        // 93%
+        double twa_delta = 180.0 - std::fabs(first_twa);
+        // Change course upwind (delta1), then downwind to 180 degrees (delta2):
+        // twa_delta + 2 * delta1 = course_change_for_max_loss
+        double delta1 = 0.5 * (course_change_for_max_loss - twa_delta);
+        // TODO Take into account loss in VMG due to the course changes and
+        // their duration Insert two course changes, filling only required
+        // fields
+        dcs.emplace(p_dc, Dc{p_dc->m_timestamp - 4, -1.0, -1.0,
+                             first_twa - sign * delta1, true});
+        dcs.emplace(p_dc,
+                    Dc{p_dc->m_timestamp - 2, -1.0, -1.0, sign * 180.0, true});
+        // ... and the existing dc finalizes the course change to next_twa
+      } else {
+        // Strategy 2
+        // Performance loss for direct jibe to next_twa
+        double loss = get_performance_loss_tack_jibe(next_stw);
+        // Performance loss for jibe to 180 degrees, then course change to
+        // next_twa
+        double loss1 = get_performance_loss_tack_jibe(stw_before_wind);
+        double loss2 =
+            get_performance_loss_course_change(180.0, std::fabs(next_twa));
+        if (loss1 + loss2 < loss) {
+          // TODO optimize this by jibing to some course between 180 degrees and
+          // next_twa
+          // TODO Take into account loss in VMG due to the course changes and
+          // their duration
+          dcs.emplace(p_dc, Dc{p_dc->m_timestamp - 2, -1.0, -1.0, sign * 180.0,
+                               true});
+          // ... and the existing dc finalizes the course change to next_twa
+        }
+      }
+    } else {
+      // Tack
+      /* The performance loss for a tack is half the boat speed after the tack,
+       * in percent. The performance loss for a course change (without tack) is
+       * ca. 0.07% per degree Strategy: Tack to 0 degrees (zero boat speed) with
+       * no performance loss Change course to next_twa
+       */
+      double next_speed = m_polar.GetSpeedThroughWater(p_dc->m_tws, next_twa);
+      // Performance loss for direct tack to next_twa
+      double loss1 = get_performance_loss_tack_jibe(next_speed);
+      // Performance loss for course change from 0 degrees to next_twa
+      double loss2 = get_performance_loss_course_change(0.0, next_twa);
+      DEBUGSL("Optimizing tack, speed after tack=" << next_speed << ", loss1="
+                                                   << loss1 << ", loss2="
+                                                   << loss2);
+      if (loss1 > loss2) {
+        dcs.emplace(p_dc, Dc{p_dc->m_timestamp - 2, -1.0, -1.0,
+                             -sign * kTwaZero, true});
+        // ... and the existing dc finalizes the course change to next_twa
+      }
+    }
+
+    first_twa = next_twa;
+  }
+}
+
+void DcModel::EnrichDcs(std::list<Dc>& dcs) const {
+  EnrichDcs(dcs, dcs.begin());
+}
+
+void DcModel::EnrichDcs(std::list<Dc>& dcs,
+                        std::list<Dc>::iterator first) const {
+  auto previous_dc = (first == dcs.begin()) ? first : std::prev(first);
+
+  // The first DC after the anchor starts where the boat gets to from its
+  // actual state, the later ones where the planned DCs get to
+  auto anchored = dcs.end();
+  double anchor_perf_end = 1.0;
+  if (m_has_anchor)
+    anchored = std::find_if(dcs.begin(), dcs.end(), [this](const Dc& dc) {
+      return dc.m_timestamp > m_anchor.m_time;
+    });
+
+  for (auto dc = first; dc != dcs.end(); ++dc) {
+    bool after_anchor = m_has_anchor && dc->m_timestamp > m_anchor.m_time;
+
+    // Calculate extra values
+    if (dc == anchored) {
+      double seconds = std::difftime(dc->m_timestamp, m_anchor.m_time);
+      double tws =
+          m_wind.GetWindData(m_anchor.m_time, m_anchor.m_lat, m_anchor.m_lon)
+              .first;
+      double stw = std::max(
+          0.0, m_polar.GetSpeedThroughWater(tws, m_anchor.m_twa));
+      anchor_perf_end = get_recovery(m_anchor.m_performance, seconds, stw);
+      double dist = stw * 0.5 * (m_anchor.m_performance + anchor_perf_end) *
+                    seconds / 3600.0;
+      Geodesy::PositionBearingDistanceMercator(
+          m_anchor.m_lat, m_anchor.m_lon, m_anchor.m_course, dist,
+          &dc->m_lat_start, &dc->m_lon_start);
+    } else if ((dc->m_lat_start == -1.0 || after_anchor) &&
+               dc != dcs.begin()) {
+      // DC course change optimization doesn't fill these fields
+      double dist = previous_dc->m_stw *
+                    std::difftime(dc->m_timestamp, previous_dc->m_timestamp) /
+                    3600.0;
+      Geodesy::PositionBearingDistanceMercator(
+          previous_dc->m_lat_start, previous_dc->m_lon_start,
+          previous_dc->m_course, dist, &dc->m_lat_start, &dc->m_lon_start);
+    }
+
+    double twd;
+    std::tie(dc->m_tws, twd) =
+        m_wind.GetWindData(dc->m_timestamp, dc->m_lat_start, dc->m_lon_start);
+    if (dc->m_is_twa) {
+      dc->m_course = twd - dc->m_twa;
+      if (dc->m_course > 360.0)
+        dc->m_course -= 360.0;
+      else if (dc->m_course < 0.0)
+        dc->m_course += 360.0;
+    } else {
+      // Get TWA from course
+      dc->m_twa = NAN;
+      if (dc->m_tws >= 0.0) {
+        dc->m_twa = twd - dc->m_course;  // positive sign: starboard tack
+        if (dc->m_twa < -180.0)
+          dc->m_twa += 360.0;
+        else if (dc->m_twa > 180.0)
+          dc->m_twa -= 360.0;
+      }
+    }
+
+    dc->m_stw = m_polar.GetSpeedThroughWater(dc->m_tws, dc->m_twa);
+    auto [max_up, max_down] = m_polar.GetBoatOptimalAngles(dc->m_tws);
+    if (max_up > 180.0) max_up = 360.0 - max_up;
+    if (max_down > 180.0) max_down = 360.0 - max_down;
+    double sign = (dc->m_twa > 0 ? 1.0 : -1.0);
+    dc->m_opt_upwind = max_up * sign;
+    dc->m_opt_downwind = max_down * sign;
+    // Performance right after the course change
+    // TODO Get parent heading at begin of DC from WR
+    if (dc == anchored)
+      dc->m_perf_begin = get_performance(anchor_perf_end, dc->m_stw,
+                                         m_anchor.m_twa, dc->m_twa);
+    else
+      dc->m_perf_begin =
+          (previous_dc->m_twa == 0.0)
+              ? 1.0
+              : get_performance(previous_dc->m_perf_end, dc->m_stw,
+                                previous_dc->m_twa, dc->m_twa);
+    auto next_dc = dc;
+    ++next_dc;
+    dc->m_perf_end =
+        (next_dc == dcs.end())
+            ? 1.0
+            : get_recovery(dc->m_perf_begin,
+                           std::difftime(next_dc->m_timestamp, dc->m_timestamp),
+                           dc->m_stw);
+
+    previous_dc = dc;
+  }
+}
+
+void DcModel::MakeTrack(const std::list<Dc>& dcs, TrackSink& track) const {
+  if (!m_has_anchor) {
+    if (dcs.empty()) return;
+    // TODO Get parent heading at begin of DC from WR
+    const Dc& front = dcs.front();
+    Simulate(dcs.begin(), dcs.end(),
+             {front.m_lat_start, front.m_lon_start, 1.0, front.m_twa}, track);
+    return;
+  }
+
+  Plan plan;
+  MakePlan(dcs, plan);
+  MakeTrack(plan, track);
+}
+
+void DcModel::MakePlan(const std::list<Dc>& dcs, Plan& plan) const {
+  plan.m_legs.clear();
+  if (!m_has_anchor) {
+    plan.m_legs = dcs;
+    plan.m_performance = 1.0;
+    plan.m_previous_twa = dcs.empty() ? 0.0 : dcs.front().m_twa;
+    return;
+  }
+
+  // The current leg of the boat, followed by the planned DCs
+  plan.m_legs.emplace_back(
+      m_anchor.m_time, m_anchor.m_lat, m_anchor.m_lon,
+      m_anchor.m_is_twa ? m_anchor.m_twa : m_anchor.m_course,
+      m_anchor.m_is_twa);
+  for (const auto& dc : dcs)
+    if (dc.m_timestamp > m_anchor.m_time) plan.m_legs.push_back(dc);
+  plan.m_performance = m_anchor.m_performance;
+  plan.m_previous_twa = m_anchor.m_twa;
+}
+
+void DcModel::MakeTrack(const Plan& plan, TrackSink& track) const {
+  if (plan.m_legs.empty()) return;
+  const Dc& front = plan.m_legs.front();
+  Simulate(plan.m_legs.begin(), plan.m_legs.end(),
+           {front.m_lat_start, front.m_lon_start, plan.m_performance,
+            plan.m_previous_twa},
+           track);
+}
+
+void DcModel::ContinueTrack(std::list<Dc>::const_iterator first,
+                            std::list<Dc>::const_iterator last,
+                            const LegStart& start, TrackSink& track) const {
+  if (first == last) return;
+  Simulate(first, last, start, track);
+}
+
+void DcModel::Simulate(std::list<Dc>::const_iterator first,
+                       std::list<Dc>::const_iterator last, LegStart start,
+                       TrackSink& track) const {
+  double current_lat = start.m_lat;
+  double current_lon = start.m_lon;
+  double performance = start.m_performance;
+  double previous_twa = start.m_previous_twa;
+  std::time_t end = first->m_timestamp;
+
+  // Recalculate the track from the dcs as precisely as possible
+  for (auto dc = first; dc != last; ++dc) {
+    track.AddTrackPoint(dc->m_timestamp, current_lat, current_lon);
+    track.SetLegStart(performance, previous_twa);
+    end = dc->m_timestamp;
+
+    auto [tws, twd] =
+        m_wind.GetWindData(dc->m_timestamp, current_lat, current_lon);
+    double twa;
+    double course;
+    if (dc->m_is_twa) {
+      twa = dc->m_twa;
+      course = twd - twa;
+    } else {
+      twa = twd - dc->m_course;  // positive sign: starboard tack
+      course = dc->m_course;
+    }
+    if (twa < -180.0)
+      twa += 360.0;
+    else if (twa > 180.0)
+      twa -= 360.0;
+    double theoretical_stw = m_polar.GetSpeedThroughWater(tws, twa);
+
+    // Performance loss for initial course change of the Dc
+    performance =
+        get_performance(performance, theoretical_stw, previous_twa, twa);
+    track.SetPerformance(performance, theoretical_stw);
+    previous_twa = twa;
+
+    auto next_dc = dc;
+    ++next_dc;
+    double time_seconds =
+        (next_dc != last)
+            ? std::difftime(next_dc->m_timestamp, dc->m_timestamp)
+            : 3600.0;  // Go on for one more hour after last Dc
+    // DCs at the same time, e.g. from a hand-edited list, give an empty leg.
+    // The jump would be zero and the loop below would never end
+    if (time_seconds <= 0.0) {
+      track.SetLegDistance(0.0, 0.0);
+      continue;
+    }
+
+    // Note: Waypoints are only created at DC timestamps, not at every jump
+    double jump = std::min(time_seconds, kStepSeconds);
+    double current_time;
+    double current_stw = theoretical_stw * performance;
+    double total_dist = 0.0;
+
+    for (current_time = jump; current_time <= time_seconds;
+         current_time += jump) {
+      // TODO TODO New wind and theoretical speed!
+
+      // The loop always calculates the performance and distance at current_time
+      if (performance < 1.0) {
+        performance = get_recovery_step(performance, jump, current_stw);
+        current_stw = theoretical_stw * performance;
+      }
+
+      // TODO It is not clear whether dist is calculated with old or new
+      // performance
+      double dist = current_stw * jump / 3600.0;
+      if (dc->m_is_twa)
+        Geodesy::PositionBearingDistanceMercator(
+            current_lat, current_lon, course, dist, &current_lat, &current_lon);
+
+      total_dist += dist;
+    }
+
+    // Remaining fractional jump, the loop stopped one jump behind the end
+    double remainder = time_seconds - (current_time - jump);
+    if (remainder > 0.0) {
+      performance =
+          std::min(1.0, get_recovery_step(performance, remainder, current_stw));
+      double dist = theoretical_stw * performance * remainder / 3600.0;
+      if (dc->m_is_twa)
+        Geodesy::PositionBearingDistanceMercator(
+            current_lat, current_lon, course, dist, &current_lat, &current_lon);
+
+      total_dist += dist;
+    }
+
+    if (!dc->m_is_twa)
+      Geodesy::PositionBearingDistanceMercator(current_lat, current_lon,
+                                               dc->m_course, total_dist,
+                                               &current_lat, &current_lon);
+    track.SetLegDistance(total_dist, theoretical_stw * time_seconds / 3600.0);
+  }
+
+  // End of the hour after the last DC
+  track.AddTrackPoint(end + 3600, current_lat, current_lon);
+}
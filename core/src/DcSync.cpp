@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "DcSync.h"
+#include "SolTime.h"
+
+namespace DcSync {
+
+bool ToServer(const std::list<Dc>& dcs, std::time_t now,
+              std::vector<SolXml::ServerDc>& server_dcs, std::string& error) {
+  server_dcs.clear();
+
+  std::time_t previous = now;
+  for (const auto& dc : dcs) {
+    // Past DCs have been executed already
+    if (dc.m_timestamp <= now) continue;
+
+    std::string time = SolTime::FormatUtc(dc.m_timestamp);
+    double value = dc.m_is_twa ? dc.m_twa : dc.m_course;
+    if (dc.m_timestamp <= previous) {
+      error = "DC at " + time + " is not at least a second after the previous";
+      return false;
+    }
+    if (!std::isfinite(value) ||
+        (dc.m_is_twa ? (value < -180.0 || value > 180.0)
+                     : (value < 0.0 || value >= 360.0))) {
+      error = "DC at " + time + " has an invalid " +
+              (dc.m_is_twa ? "TWA" : "course");
+      return false;
+    }
+
+    server_dcs.push_back({"", dc.m_timestamp, dc.m_is_twa, value});
+    previous = dc.m_timestamp;
+  }
+
+  return true;
+}
+
+std::vector<Change> Diff(const std::vector<SolXml::ServerDc>& old_dcs,
+                         const std::vector<SolXml::ServerDc>& new_dcs) {
+  std::vector<Change> changes;
+
+  // Merge join by time
+  auto o = old_dcs.begin();
+  auto n = new_dcs.begin();
+  while (o != old_dcs.end() || n != new_dcs.end()) {
+    if (n == new_dcs.end() || (o != old_dcs.end() && o->m_time < n->m_time)) {
+      changes.push_back({Change::kRemoved, *o++});
+    } else if (o == old_dcs.end() || n->m_time < o->m_time) {
+      changes.push_back({Change::kAdded, *n++});
+    } else {
+      if (o->m_is_twa != n->m_is_twa || o->m_value != n->m_value) {
+        changes.push_back({Change::kModified, *n});
+        if (n->m_id.empty()) changes.back().m_dc.m_id = o->m_id;
+      }
+      ++o;
+      ++n;
+    }
+  }
+
+  return changes;
+}
+
+std::vector<Change> DiffUpload(const std::vector<SolXml::ServerDc>& server_dcs,
+                               const std::vector<SolXml::ServerDc>& planned_dcs,
+                               std::time_t now) {
+  // Sorted by time, the future DCs are the end of the list
+  auto future = std::upper_bound(
+      server_dcs.begin(), server_dcs.end(), now,
+      [](std::time_t t, const SolXml::ServerDc& dc) { return t < dc.m_time; });
+  return Diff(std::vector<SolXml::ServerDc>(future, server_dcs.end()),
+              planned_dcs);
+}
+
+std::list<Dc>::iterator Apply(const std::vector<Change>& changes,
+                              std::list<Dc>& dcs) {
+  // Changes are sorted as well, so the list is walked once and the first
+  // change is found first
+  auto first_changed = dcs.end();
+  auto changed = [&](std::list<Dc>::iterator dc) {
+    if (first_changed == dcs.end()) first_changed = dc;
+  };
+
+  auto dc = dcs.begin();
+  for (const auto& change : changes) {
+    while (dc != dcs.end() && dc->m_timestamp < change.m_dc.m_time) ++dc;
+    bool exists = dc != dcs.end() && dc->m_timestamp == change.m_dc.m_time;
+
+    if (change.m_kind == Change::kRemoved) {
+      if (!exists) continue;
+      dc = dcs.erase(dc);
+      if (dc != dcs.end())
+        changed(dc);
+      else if (!dcs.empty())
+        changed(std::prev(dc));
+    } else if (exists) {
+      // Also for kAdded, when the DC was planned locally already
+      double& value = change.m_dc.m_is_twa ? dc->m_twa : dc->m_course;
+      if (dc->m_is_twa == change.m_dc.m_is_twa && value == change.m_dc.m_value)
+        continue;
+      dc->m_is_twa = change.m_dc.m_is_twa;
+      value = change.m_dc.m_value;
+      changed(dc);
+    } else {
+      dc = dcs.insert(dc, Dc{change.m_dc.m_time, -1.0, -1.0,
+                             change.m_dc.m_value, change.m_dc.m_is_twa});
+      changed(dc);
+    }
+  }
+  if (first_changed == dcs.end()) return first_changed;
+
+  // The boat sails differently after the first change
+  for (auto later = std::next(first_changed); later != dcs.end(); ++later)
+    later->m_lat_start = later->m_lon_start = -1.0;
+
+  // Performance at the end of the previous DC depends on the time of the
+  // next one
+  return first_changed == dcs.begin() ? first_changed
+                                      : std::prev(first_changed);
+}
+}  // namespace DcSync
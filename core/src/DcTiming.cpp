@@ -0,0 +1,286 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "DcTiming.h"
+#include "Geodesy.h"
+#include "ThreadPool.h"
+
+namespace {
+/// Candidates per direction of a line, multiples of the step
+static constexpr int kLine = 4;
+/// Seconds between DCs, as OptimizeManeuvers() keeps them
+static constexpr std::time_t kMinGap = 2;
+/// Seconds an ETA must improve by
+static constexpr double kMinGain = 1.0;
+/// Knots, at least assumed for the remaining distance after the track
+static constexpr double kMinSpeed = 0.1;
+
+/// Track of a simulation with the boat state at the start of every leg
+class Recorder : public TrackSink {
+public:
+  std::vector<TrackPoint> m_points;
+  std::vector<DcModel::LegStart> m_starts;
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    m_points.push_back({t, lat, lon});
+  }
+  void SetLegStart(double performance, double previous_twa) override {
+    const TrackPoint& point = m_points.back();
+    m_starts.push_back({point.m_lat, point.m_lon, performance, previous_twa});
+  }
+
+  void Clear() {
+    m_points.clear();
+    m_starts.clear();
+  }
+};
+
+double& get_value(Dc& dc) { return dc.m_is_twa ? dc.m_twa : dc.m_course; }
+double get_value(const Dc& dc) { return dc.m_is_twa ? dc.m_twa : dc.m_course; }
+
+/// Copy of the legs of a plan for a block of candidates
+struct Workspace {
+  std::list<Dc> m_legs;
+  std::vector<std::list<Dc>::iterator> m_index;
+  Recorder m_track;
+};
+
+struct Candidate {
+  std::time_t m_timestamp;
+  double m_value;  // Course or TWA
+  double m_eta;
+};
+}  // namespace
+
+DcTiming::DcTiming(const WindProvider& wind, const PolarProvider& polar,
+                   const DcTimingSettings& settings, ThreadPool* pool)
+    : m_wind(wind), m_polar(polar), m_settings(settings), m_pool(pool) {}
+
+std::vector<std::string> DcTiming::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool DcTiming::Optimize(DcModel::Plan& plan, double target_lat,
+                        double target_lon, DcTimingResult& result) {
+  result = DcTimingResult();
+  if (plan.m_legs.size() < 2) {
+    m_errors.emplace_back("No DCs to optimize");
+    return false;
+  }
+  const Dc& first = plan.m_legs.front();
+  if (m_wind.GetWindData(first.m_timestamp, first.m_lat_start,
+                         first.m_lon_start)
+          .first < 0.0) {
+    m_errors.emplace_back("No wind data at the first DC");
+    return false;
+  }
+
+  const DcModel model(m_wind, m_polar);
+  const size_t legs = plan.m_legs.size();
+  const double radius = m_settings.m_arrival_radius;
+  const std::vector<Dc> planned(plan.m_legs.begin(), plan.m_legs.end());
+  std::vector<std::list<Dc>::iterator> index;
+  index.reserve(legs);
+  for (auto leg = plan.m_legs.begin(); leg != plan.m_legs.end(); ++leg)
+    index.push_back(leg);
+
+  // Track of the plan, updated with every change
+  Recorder current;
+  current.m_points.reserve(legs + 1);
+  current.m_starts.reserve(legs);
+  model.MakeTrack(plan, current);
+  size_t arrival;
+  double eta =
+      GetEta(current.m_points, target_lat, target_lon, radius, arrival);
+  result.m_eta_before = eta;
+  result.m_simulations = 1;
+
+  // Candidates are simulated in blocks, each on its own copy of the legs
+  const size_t blocks = (m_pool ? m_pool->GetSize() : 0) + 1;
+  std::vector<Workspace> workspaces(blocks);
+  for (auto& workspace : workspaces) {
+    workspace.m_legs = plan.m_legs;
+    for (auto leg = workspace.m_legs.begin(); leg != workspace.m_legs.end();
+         ++leg)
+      workspace.m_index.push_back(leg);
+    workspace.m_track.m_points.reserve(legs + 1);
+    workspace.m_track.m_starts.reserve(legs);
+  }
+  std::vector<Candidate> candidates;
+  candidates.reserve(4 * kLine);
+
+  for (double scale = 1.0;
+       m_settings.m_time_step * scale >= m_settings.m_min_time_step &&
+       result.m_simulations < m_settings.m_max_simulations;
+       scale /= 2.0) {
+    const std::time_t time_step =
+        std::max<std::time_t>(1, std::llround(m_settings.m_time_step * scale));
+    const double course_step = m_settings.m_course_step * scale;
+
+    for (bool improved = true;
+         improved && result.m_simulations < m_settings.m_max_simulations;) {
+      improved = false;
+      // DCs after the arrival don't matter
+      for (size_t i = 1; i < legs && i - 1 <= arrival; ++i) {
+        const Dc& dc = *index[i];
+        const Dc& original = planned[i];
+        // Executed, or too late to upload
+        if (original.m_timestamp <= m_settings.m_min_time) continue;
+        std::time_t max_shift = std::llround(m_settings.m_max_shift);
+        std::time_t lower = std::max({index[i - 1]->m_timestamp + kMinGap,
+                                      original.m_timestamp - max_shift,
+                                      m_settings.m_min_time + 1});
+        std::time_t upper = original.m_timestamp + max_shift;
+        if (i + 1 < legs)
+          upper = std::min(upper, index[i + 1]->m_timestamp - kMinGap);
+
+        candidates.clear();
+        for (int k = -kLine; k <= kLine; ++k) {
+          std::time_t t = dc.m_timestamp + k * time_step;
+          if (k != 0 && t >= lower && t <= upper)
+            candidates.push_back({t, get_value(dc), 0.0});
+        }
+        for (int k = -kLine; k <= kLine && m_settings.m_max_course_change > 0.0;
+             ++k) {
+          double value = get_value(dc) + k * course_step;
+          double change =
+              Geodesy::NormalizeLonDelta(value - get_value(original));
+          if (k == 0 || std::fabs(change) > m_settings.m_max_course_change)
+            continue;
+          // TWAs stay on their tack, courses in [0, 360)
+          if (dc.m_is_twa) {
+            if (value * dc.m_twa <= 0.0 || std::fabs(value) >= 180.0) continue;
+          } else {
+            value = std::fmod(value + 360.0, 360.0);
+          }
+          candidates.push_back({dc.m_timestamp, value, 0.0});
+        }
+        if (candidates.empty()) continue;
+
+        // Only the legs from the one before the DC change, and only up to
+        // the leg after the arrival: later arrivals are no improvement
+        const size_t from = i - 1;
+        const size_t to = std::min(legs, arrival + 3);
+        const size_t used = std::min(blocks, candidates.size());
+        auto evaluate = [&](size_t block) {
+          Workspace& workspace = workspaces[block];
+          Dc& leg = *workspace.m_index[i];
+          const Dc saved = leg;
+          auto last =
+              to < legs ? workspace.m_index[to] : workspace.m_legs.end();
+          for (size_t c = block * candidates.size() / used;
+               c < (block + 1) * candidates.size() / used; ++c) {
+            leg.m_timestamp = candidates[c].m_timestamp;
+            get_value(leg) = candidates[c].m_value;
+            workspace.m_track.Clear();
+            model.ContinueTrack(workspace.m_index[from], last,
+                                current.m_starts[from], workspace.m_track);
+            size_t segment;
+            candidates[c].m_eta = GetEta(workspace.m_track.m_points,
+                                         target_lat, target_lon, radius,
+                                         segment);
+          }
+          leg = saved;
+        };
+        if (m_pool == nullptr)
+          evaluate(0);
+        else
+          m_pool->ParallelFor(used, evaluate);
+        result.m_simulations += candidates.size();
+
+        auto best = std::min_element(
+            candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.m_eta < b.m_eta;
+            });
+        if (best->m_eta > eta - kMinGain) continue;
+
+        index[i]->m_timestamp = best->m_timestamp;
+        get_value(*index[i]) = best->m_value;
+        for (auto& workspace : workspaces) {
+          workspace.m_index[i]->m_timestamp = best->m_timestamp;
+          get_value(*workspace.m_index[i]) = best->m_value;
+        }
+
+        // The rest of the track of the changed plan
+        Recorder& track = workspaces.front().m_track;
+        track.Clear();
+        model.ContinueTrack(index[from], plan.m_legs.end(),
+                            current.m_starts[from], track);
+        ++result.m_simulations;
+        current.m_points.resize(from);
+        current.m_points.insert(current.m_points.end(), track.m_points.begin(),
+                                track.m_points.end());
+        current.m_starts.resize(from);
+        current.m_starts.insert(current.m_starts.end(), track.m_starts.begin(),
+                                track.m_starts.end());
+        size_t segment;
+        eta = GetEta(track.m_points, target_lat, target_lon, radius, segment);
+        arrival = from + segment;
+        improved = true;
+      }
+    }
+  }
+
+  result.m_eta_after = eta;
+  result.m_reached = arrival < current.m_points.size();
+  result.m_changed = 0;
+  for (size_t i = 1; i < legs; ++i)
+    if (index[i]->m_timestamp != planned[i].m_timestamp ||
+        get_value(*index[i]) != get_value(planned[i]))
+      ++result.m_changed;
+
+  return true;
+}
+
+double DcTiming::GetEta(const std::vector<TrackPoint>& points, double lat,
+                        double lon, double radius, size_t& segment) {
+  for (size_t i = 0; i + 1 < points.size(); ++i) {
+    const TrackPoint& a = points[i];
+    const TrackPoint& b = points[i + 1];
+    double f;
+    if (Geodesy::ClosestApproachFlat(a.m_lat, a.m_lon, b.m_lat, b.m_lon, lat,
+                                     lon, &f) <= radius) {
+      segment = i;
+      return a.m_time + f * std::difftime(b.m_time, a.m_time);
+    }
+  }
+  segment = points.size();
+
+  // The rest of the way at the speed of the last segment
+  const TrackPoint& end = points.back();
+  double speed = kMinSpeed;
+  if (points.size() >= 2) {
+    const TrackPoint& before = points[points.size() - 2];
+    double hours = std::difftime(end.m_time, before.m_time) / 3600.0;
+    if (hours > 0.0)
+      speed = std::max(speed, Geodesy::DistanceGreatCircle(
+                                  end.m_lat, end.m_lon, before.m_lat,
+                                  before.m_lon) /
+                                  hours);
+  }
+  double remaining =
+      Geodesy::DistanceGreatCircle(lat, lon, end.m_lat, end.m_lon) - radius;
+  return end.m_time + std::max(0.0, remaining) / speed * 3600.0;
+}
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "DriftMonitor.h"
+#include "Geodesy.h"
+#include "Performance.h"
+
+DriftMonitor::DriftMonitor(double max_distance, double max_performance)
+    : m_max_distance(max_distance), m_max_performance(max_performance) {}
+
+void DriftMonitor::SetPlan(const DcModel& model, const std::list<Dc>& dcs,
+                           const DcModel::Anchor& actual) {
+  m_simulations = 0;
+  Project(model, dcs, actual);
+  m_plan = m_projection;
+}
+
+DriftMonitor::Drift DriftMonitor::Update(const DcModel& model,
+                                         const std::list<Dc>& dcs,
+                                         const DcModel::Anchor& actual) {
+  if (!HasPlan()) SetPlan(model, dcs, actual);
+
+  Drift drift{actual.m_time, NAN, 0.0, false};
+  if (Compare(m_plan, actual, drift.m_distance, drift.m_performance))
+    drift.m_exceeded = drift.m_distance > m_max_distance ||
+                       std::fabs(drift.m_performance) > m_max_performance;
+
+  // Usually the boat is where the last update expected it
+  double distance, performance;
+  if (!Compare(m_projection, actual, distance, performance) ||
+      distance > kProjectionDistance ||
+      std::fabs(performance) > kProjectionPerformance)
+    Project(model, dcs, actual);
+
+  return drift;
+}
+
+std::vector<TrackPoint> DriftMonitor::GetProjection() const {
+  std::vector<TrackPoint> result;
+  result.reserve(m_projection.m_points.size());
+  for (const auto& point : m_projection.m_points)
+    result.push_back(point.m_point);
+  return result;
+}
+
+void DriftMonitor::Project(const DcModel& model, const std::list<Dc>& dcs,
+                           const DcModel::Anchor& actual) {
+  // Only the DCs after the actual state are simulated
+  DcModel anchored(model);
+  anchored.SetAnchor(actual);
+  m_projection.m_points.clear();
+  anchored.MakeTrack(dcs, m_projection);
+  ++m_simulations;
+}
+
+bool DriftMonitor::Compare(const Track& track, const DcModel::Anchor& actual,
+                           double& distance, double& performance) {
+  TrackPoint point;
+  double expected;
+  if (!track.At(actual.m_time, point, expected)) {
+    distance = NAN;
+    performance = 0.0;
+    return false;
+  }
+
+  double bearing;
+  Geodesy::DistanceBearingMercator(actual.m_lat, actual.m_lon, point.m_lat,
+                                   point.m_lon, &bearing, &distance);
+  performance = actual.m_performance - expected;
+  return true;
+}
+
+void DriftMonitor::Track::AddTrackPoint(std::time_t t, double lat,
+                                        double lon) {
+  Point point;
+  point.m_point = {t, lat, lon};
+  // The end point keeps the performance of the last leg
+  if (!m_points.empty()) {
+    const auto& last = m_points.back();
+    point.m_stw = last.m_stw;
+    point.m_performance = Performance::get_recovery(
+        last.m_performance, std::difftime(t, last.m_point.m_time), last.m_stw);
+  }
+  m_points.push_back(point);
+}
+
+void DriftMonitor::Track::SetPerformance(double performance, double stw) {
+  if (m_points.empty()) return;
+  m_points.back().m_performance = performance;
+  m_points.back().m_stw = stw;
+}
+
+bool DriftMonitor::Track::At(std::time_t t, TrackPoint& point,
+                             double& performance) const {
+  if (m_points.size() < 2 || t < m_points.front().m_point.m_time ||
+      t > m_points.back().m_point.m_time)
+    return false;
+
+  // First point after t, t is on the leg from the one before
+  auto next = std::upper_bound(
+      m_points.begin(), m_points.end(), t,
+      [](std::time_t t, const Point& p) { return t < p.m_point.m_time; });
+  if (next == m_points.end()) --next;
+  const Point& leg = *std::prev(next);
+
+  double seconds = std::difftime(t, leg.m_point.m_time);
+  double duration = std::difftime(next->m_point.m_time, leg.m_point.m_time);
+  double w = duration > 0.0 ? seconds / duration : 0.0;
+  const TrackPoint& from = leg.m_point;
+  const TrackPoint& to = next->m_point;
+  point.m_time = t;
+  point.m_lat = from.m_lat + w * (to.m_lat - from.m_lat);
+  point.m_lon =
+      from.m_lon + w * Geodesy::NormalizeLonDelta(to.m_lon - from.m_lon);
+  performance =
+      Performance::get_recovery(leg.m_performance, seconds, leg.m_stw);
+  return true;
+}
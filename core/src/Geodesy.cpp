@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "Geodesy.h"
+
+namespace Geodesy {
+
+void TrackDistanceBearingMercator(size_t n, const double* lat,
+                                  const double* lon, double* brg,
+                                  double* dist) {
+  if (n < 2) return;
+
+  // Every point starts one segment and ends another, so its meridional part
+  // is calculated once instead of twice. Blocks keep the parts on the stack
+  static constexpr size_t kBlock = 256;
+  double psi[kBlock + 1];
+  psi[0] = MercatorPsi(lat[0]);
+  for (size_t begin = 0; begin + 1 < n; begin += kBlock) {
+    size_t count = std::min(kBlock, n - 1 - begin);
+    for (size_t i = 1; i <= count; ++i) psi[i] = MercatorPsi(lat[begin + i]);
+
+    // As DistanceBearingMercator()
+    for (size_t i = 0; i < count; ++i) {
+      size_t k = begin + i;
+      double dlat = (lat[k + 1] - lat[k]) * kDegToRad;
+      double dlon = NormalizeLonDelta(lon[k + 1] - lon[k]) * kDegToRad;
+      double q = MercatorQ(lat[k], lat[k + 1], psi[i], psi[i + 1]);
+      double dpsi = std::fabs(q) > 0.0 ? dlat / q : 0.0;
+      double course = std::atan2(dlon, dpsi) / kDegToRad;
+      brg[k] = course < 0.0 ? course + 360.0 : course;
+      dist[k] = std::sqrt(dlat * dlat + q * q * dlon * dlon) * kEarthRadiusNm;
+    }
+    psi[0] = psi[count];
+  }
+}
+}  // namespace Geodesy
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Geodesy.h"
+#include "Leaderboard.h"
+
+namespace {
+// Keys of finished boats are below all DTFs, in the order they finished
+static constexpr double kFinishedKey = -1E12;
+
+void to_unit(double lat, double lon, double& x, double& y, double& z) {
+  double phi = lat * Geodesy::kDegToRad;
+  double lambda = lon * Geodesy::kDegToRad;
+  x = std::cos(phi) * std::cos(lambda);
+  y = std::cos(phi) * std::sin(lambda);
+  z = std::sin(phi);
+}
+
+// Radians, about 34 nm. Boats that moved less between two updates get the
+// sine and cosine of their position from the ones before
+static constexpr double kMaxStep = 0.01;
+
+/// Sine and cosine of a + step from those of a, for |step| <= kMaxStep. The
+/// series of the step are exact to double precision there
+inline void rotate(double step, double& sin_a, double& cos_a) {
+  double s2 = step * step;
+  double sin_step = step * (1.0 - s2 / 6.0 * (1.0 - s2 / 20.0));
+  double cos_step = 1.0 - s2 / 2.0 * (1.0 - s2 / 12.0 * (1.0 - s2 / 30.0));
+  double sin_sum = sin_a * cos_step + cos_a * sin_step;
+  cos_a = cos_a * cos_step - sin_a * sin_step;
+  sin_a = sin_sum;
+}
+
+/// Great circle distance (nm) of two unit vectors from their chord
+inline double chord_distance(double dx, double dy, double dz) {
+  double half_chord = 0.5 * std::sqrt(dx * dx + dy * dy + dz * dz);
+  return 2.0 * std::asin(std::fmin(half_chord, 1.0)) * Geodesy::kEarthRadiusNm;
+}
+}  // namespace
+
+Leaderboard::Leaderboard(const std::vector<std::pair<double, double>>& course,
+                         double radius)
+    : m_radius(radius) {
+  const size_t n = course.size();
+  // A sentinel behind the finish, so that finished boats can be looked up
+  m_wx.resize(n + 1, 0.0);
+  m_wy.resize(n + 1, 0.0);
+  m_wz.resize(n + 1, 0.0);
+  m_tx.resize(n + 1, 0.0);
+  m_ty.resize(n + 1, 0.0);
+  m_tz.resize(n + 1, 0.0);
+  m_to_finish.resize(n + 1, 0.0);
+  for (size_t j = 0; j < n; ++j) {
+    m_lat.push_back(course[j].first);
+    m_lon.push_back(course[j].second);
+    to_unit(course[j].first, course[j].second, m_wx[j], m_wy[j], m_wz[j]);
+  }
+
+  for (size_t j = n; j-- > 1;)
+    m_to_finish[j - 1] =
+        m_to_finish[j] + chord_distance(m_wx[j] - m_wx[j - 1],
+                                        m_wy[j] - m_wy[j - 1],
+                                        m_wz[j] - m_wz[j - 1]);
+
+  // Direction of the leg to each waypoint there, (w[j - 1] x w[j]) x w[j].
+  // The start has the direction of the first leg
+  for (size_t j = 0; j < n && n > 1; ++j) {
+    size_t a = j == 0 ? 0 : j - 1, b = j == 0 ? 1 : j;
+    double nx = m_wy[a] * m_wz[b] - m_wz[a] * m_wy[b];
+    double ny = m_wz[a] * m_wx[b] - m_wx[a] * m_wz[b];
+    double nz = m_wx[a] * m_wy[b] - m_wy[a] * m_wx[b];
+    m_tx[j] = ny * m_wz[j] - nz * m_wy[j];
+    m_ty[j] = nz * m_wx[j] - nx * m_wz[j];
+    m_tz[j] = nx * m_wy[j] - ny * m_wx[j];
+  }
+
+  double half_chord =
+      std::sin(std::fmin(radius / Geodesy::kEarthRadiusNm, M_PI) / 2.0);
+  m_radius_chord2 = 4.0 * half_chord * half_chord;
+}
+
+void Leaderboard::Update(size_t n, const int64_t* ids, const double* lat,
+                         const double* lon) {
+  for (size_t i = 0; i < n; ++i) {
+    // Feeds list the boats in the same order every time, which saves the
+    // lookup
+    uint32_t boat = static_cast<uint32_t>(i);
+    if (i >= m_ids.size() || m_ids[i] != ids[i]) {
+      auto [it, added] =
+          m_index.emplace(ids[i], static_cast<uint32_t>(m_ids.size()));
+      boat = it->second;
+      if (added) Add(ids[i], lat[i], lon[i]);
+    }
+    Move(boat, lat[i], lon[i]);
+    Advance(boat);
+  }
+
+  // DTF of all boats in one pass, finished ones look up the sentinel
+  const uint32_t finish = static_cast<uint32_t>(m_lat.size());
+  for (size_t i = 0; i < m_ids.size(); ++i) {
+    uint32_t j = m_next[i];
+    double dtf = chord_distance(m_x[i] - m_wx[j], m_y[i] - m_wy[j],
+                                m_z[i] - m_wz[j]) +
+                 m_to_finish[j];
+    m_dtf[i] = j == finish ? 0.0 : dtf;
+    m_key[i] = j == finish ? m_key[i] : dtf;
+  }
+}
+
+void Leaderboard::Add(int64_t id, double lat, double lon) {
+  m_ids.push_back(id);
+  m_pos_lat.push_back(lat);
+  m_pos_lon.push_back(lon);
+  m_sin_lat.push_back(std::sin(lat * Geodesy::kDegToRad));
+  m_cos_lat.push_back(std::cos(lat * Geodesy::kDegToRad));
+  m_sin_lon.push_back(std::sin(lon * Geodesy::kDegToRad));
+  m_cos_lon.push_back(std::cos(lon * Geodesy::kDegToRad));
+  m_x.push_back(m_cos_lat.back() * m_cos_lon.back());
+  m_y.push_back(m_cos_lat.back() * m_sin_lon.back());
+  m_z.push_back(m_sin_lat.back());
+  m_next.push_back(static_cast<uint32_t>(GetClosestLeg(lat, lon)));
+  m_dtf.push_back(0.0);
+  m_key.push_back(0.0);
+  m_order.push_back(static_cast<uint32_t>(m_order.size()));
+}
+
+void Leaderboard::Move(uint32_t i, double lat, double lon) {
+  double dlat = (lat - m_pos_lat[i]) * Geodesy::kDegToRad;
+  double dlon =
+      Geodesy::NormalizeLonDelta(lon - m_pos_lon[i]) * Geodesy::kDegToRad;
+  // E.g. retired boats
+  if (dlat == 0.0 && dlon == 0.0) return;
+
+  if (std::fabs(dlat) <= kMaxStep && std::fabs(dlon) <= kMaxStep) {
+    rotate(dlat, m_sin_lat[i], m_cos_lat[i]);
+    rotate(dlon, m_sin_lon[i], m_cos_lon[i]);
+  } else {
+    m_sin_lat[i] = std::sin(lat * Geodesy::kDegToRad);
+    m_cos_lat[i] = std::cos(lat * Geodesy::kDegToRad);
+    m_sin_lon[i] = std::sin(lon * Geodesy::kDegToRad);
+    m_cos_lon[i] = std::cos(lon * Geodesy::kDegToRad);
+  }
+  m_pos_lat[i] = lat;
+  m_pos_lon[i] = lon;
+  m_x[i] = m_cos_lat[i] * m_cos_lon[i];
+  m_y[i] = m_cos_lat[i] * m_sin_lon[i];
+  m_z[i] = m_sin_lat[i];
+}
+
+void Leaderboard::Advance(uint32_t i) {
+  const size_t finish = m_lat.size();
+  size_t j = m_next[i];
+  if (j == finish) return;
+
+  while (j < finish && HasRounded(m_x[i], m_y[i], m_z[i], j)) ++j;
+  m_next[i] = static_cast<uint32_t>(j);
+  if (j == finish) m_key[i] = kFinishedKey + m_finished++;
+}
+
+bool Leaderboard::HasRounded(double x, double y, double z, size_t j) const {
+  double dx = x - m_wx[j], dy = y - m_wy[j], dz = z - m_wz[j];
+  if (dx * dx + dy * dy + dz * dz <= m_radius_chord2) return true;
+  // The waypoint itself is orthogonal to the direction of the leg
+  return x * m_tx[j] + y * m_ty[j] + z * m_tz[j] > 0.0;
+}
+
+void Leaderboard::GetTop(size_t n, std::vector<Entry>& top) {
+  n = std::min(n, m_order.size());
+  std::partial_sort(m_order.begin(), m_order.begin() + n, m_order.end(),
+                    [this](uint32_t a, uint32_t b) {
+                      return m_key[a] < m_key[b] ||
+                             (m_key[a] == m_key[b] && m_ids[a] < m_ids[b]);
+                    });
+
+  top.clear();
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t boat = m_order[i];
+    top.push_back({m_ids[boat], m_dtf[boat], m_next[boat]});
+  }
+}
+
+size_t Leaderboard::GetNextWaypoint(double lat, double lon) const {
+  const size_t finish = m_lat.size();
+  size_t next = GetClosestLeg(lat, lon);
+  double x, y, z;
+  to_unit(lat, lon, x, y, z);
+  while (next < finish && HasRounded(x, y, z, next)) ++next;
+  return next;
+}
+
+size_t Leaderboard::GetClosestLeg(double lat, double lon) const {
+  const size_t finish = m_lat.size();
+  if (finish < 2) return 0;
+
+  size_t next = 1;
+  double best = INFINITY;
+  for (size_t j = 1; j < finish; ++j) {
+    double f;
+    double distance =
+        Geodesy::ClosestApproachFlat(m_lat[j - 1], m_lon[j - 1], m_lat[j],
+                                     m_lon[j], lat, lon, &f);
+    if (distance < best) {
+      best = distance;
+      next = j;
+    }
+  }
+  return next;
+}
+
+double Leaderboard::GetDtf(double lat, double lon, size_t next) const {
+  if (next >= m_lat.size()) return 0.0;
+
+  double x, y, z;
+  to_unit(lat, lon, x, y, z);
+  return chord_distance(x - m_wx[next], y - m_wy[next], z - m_wz[next]) +
+         m_to_finish[next];
+}
+
+size_t Leaderboard::GetRank(double dtf) const {
+  size_t ahead = 0;
+  for (double key : m_key) ahead += key < dtf;
+  return ahead + 1;
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "SolDebug.h"
+#include "Performance.h"
+
+namespace Performance {
+
+double get_performance_loss_tack_jibe(const double stw) {
+  return 0.5 * stw / 100.0;
+}
+
+double get_performance_loss_course_change(const double first_twa,
+                                          const double next_twa) {
+  return std::fabs(next_twa - first_twa) / 180.0 * M_PI / 25.0;
+}
+
+double get_performance(const double performance, const double theoretical_stw,
+                       const double first_twa, const double next_twa) {
+  if (performance < 0.93) return performance;
+
+  if (first_twa * next_twa > 0) {
+    // Course change
+    return performance -
+           get_performance_loss_course_change(first_twa, next_twa);
+  } else {
+    // Tack or jibe
+    return performance -
+           get_performance_loss_tack_jibe(theoretical_stw * performance);
+  }
+}
+
+double get_recovery_step(const double performance, const double step_seconds,
+                         const double stw) {
+  return std::min(1.0, performance + step_seconds * 3.0 / (20.0 * stw) / 100.0);
+}
+
+double get_recovery(const double performance, const double time_seconds,
+                    const double theoretical_stw) {
+  if (performance >= 1.0) return 1.0;
+  // Also avoids an endless loop with a jump of zero
+  if (time_seconds <= 0.0) return performance;
+
+  DEBUGSL("Recovery from " << performance << " at " << theoretical_stw
+                           << " kn in " << time_seconds << " s");
+
+  double jump =
+      std::min(time_seconds, kStepSeconds);  // TODO Find correct value for jump
+  double current_stw = theoretical_stw * performance;
+  double newperformance = performance;
+  double current_time;
+
+  // TODO Find closed formula for this
+  for (current_time = jump; current_time <= time_seconds;
+       current_time += jump) {
+    newperformance = get_recovery_step(newperformance, jump, current_stw);
+    if (newperformance >= 1.0) return 1.0;
+
+    current_stw = theoretical_stw * newperformance;
+  }
+
+  // Remaining fractional jump, the loop stopped one jump behind the end
+  double remainder = time_seconds - (current_time - jump);
+  if (remainder > 0.0)
+    return get_recovery_step(newperformance, remainder, current_stw);
+
+  return newperformance;
+}
+}  // namespace Performance
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "PerformanceLedger.h"
+
+const PerformanceLedger::Entry* PerformanceLedger::Find(std::time_t t) const {
+  auto entry = std::lower_bound(
+      m_entries.begin(), m_entries.end(), t,
+      [](const Entry& e, std::time_t time) { return e.m_time < time; });
+  return entry != m_entries.end() && entry->m_time == t ? &*entry : nullptr;
+}
+
+double PerformanceLedger::GetTotalLoss() const {
+  double loss = 0.0;
+  for (const auto& entry : m_entries) loss += entry.GetLoss();
+  return loss;
+}
+
+double PerformanceLedger::GetTotalLossSeconds() const {
+  double seconds = 0.0;
+  for (const auto& entry : m_entries) seconds += entry.GetLossSeconds();
+  return seconds;
+}
+
+void PerformanceLedger::AddTrackPoint(std::time_t t, double lat, double lon) {
+  m_time = t;
+  if (m_next != nullptr) m_next->AddTrackPoint(t, lat, lon);
+}
+
+void PerformanceLedger::SetPerformance(double performance, double stw) {
+  // Every leg starts with a track point and its course change, the end of
+  // the track has none
+  m_entries.push_back({m_time, performance, stw, 0.0, 0.0});
+  if (m_next != nullptr) m_next->SetPerformance(performance, stw);
+}
+
+void PerformanceLedger::SetLegStart(double performance, double previous_twa) {
+  if (m_next != nullptr) m_next->SetLegStart(performance, previous_twa);
+}
+
+void PerformanceLedger::SetLegDistance(double sailed, double ideal) {
+  if (!m_entries.empty()) {
+    m_entries.back().m_sailed = sailed;
+    m_entries.back().m_ideal = ideal;
+  }
+  if (m_next != nullptr) m_next->SetLegDistance(sailed, ideal);
+}
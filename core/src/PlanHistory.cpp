@@ -0,0 +1,224 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Geodesy.h"
+#include "PlanHistory.h"
+
+namespace {
+// A chunk ends at DCs whose mixed time is divisible by kChunkTarget, so
+// chunks have kChunkTarget DCs on average, and at most kMaxChunk
+static constexpr uint64_t kChunkTarget = 16;
+static constexpr size_t kMaxChunk = 64;
+
+bool ends_chunk(std::time_t t) {
+  // SplitMix64 finalizer, DC times are often multiples of a minute
+  uint64_t z = static_cast<uint64_t>(t) + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return ((z ^ (z >> 31)) % kChunkTarget) == 0;
+}
+
+/// Waypoint arrivals of a simulated track
+class EtaSink : public TrackSink {
+public:
+  EtaSink(const std::vector<std::pair<double, double>>& waypoints,
+          double radius, std::vector<double>& etas)
+      : m_waypoints(waypoints), m_radius(radius), m_etas(etas) {
+    m_etas.assign(waypoints.size(), NAN);
+  }
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    // A waypoint at the first point is reached there
+    if (!m_has_point) {
+      m_t = t;
+      m_lat = lat;
+      m_lon = lon;
+      m_has_point = true;
+    }
+    // One segment may reach several waypoints
+    while (m_next < m_waypoints.size()) {
+      double f;
+      if (Geodesy::ClosestApproachFlat(m_lat, m_lon, lat, lon,
+                                       m_waypoints[m_next].first,
+                                       m_waypoints[m_next].second,
+                                       &f) > m_radius)
+        break;
+      m_etas[m_next++] = m_t + f * std::difftime(t, m_t);
+    }
+    m_t = t;
+    m_lat = lat;
+    m_lon = lon;
+  }
+
+private:
+  const std::vector<std::pair<double, double>>& m_waypoints;
+  double m_radius;
+  std::vector<double>& m_etas;
+  size_t m_next = 0;
+  bool m_has_point = false;
+  std::time_t m_t = 0;
+  double m_lat = 0.0;
+  double m_lon = 0.0;
+};
+}  // namespace
+
+void PlanSnapshot::GetDcs(std::list<Dc>& dcs) const {
+  dcs.clear();
+  for (const auto& chunk : m_chunks)
+    for (const auto& dc : *chunk)
+      dcs.emplace_back(Dc{dc.m_timestamp, dc.m_lat_start, dc.m_lon_start,
+                          dc.m_value, dc.m_is_twa});
+  if (!dcs.empty()) {
+    dcs.front().m_lat_start = m_lat_start;
+    dcs.front().m_lon_start = m_lon_start;
+  }
+}
+
+bool PlanSnapshot::IsSame(const PlanSnapshot& other) const {
+  if (m_size != other.m_size || m_chunks.size() != other.m_chunks.size())
+    return false;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+    if (m_chunks[i] != other.m_chunks[i] &&
+        *m_chunks[i] != *other.m_chunks[i])
+      return false;
+  return true;
+}
+
+PlanSnapshot PlanHistory::MakeSnapshot(const std::list<Dc>& dcs) const {
+  // Chunks of the current plan by their first DC
+  std::unordered_map<std::time_t, const PlanSnapshot::ChunkPtr*> current;
+  current.reserve(m_current.m_chunks.size());
+  for (const auto& chunk : m_current.m_chunks)
+    current.emplace(chunk->front().m_timestamp, &chunk);
+
+  PlanSnapshot snapshot;
+  snapshot.m_size = dcs.size();
+  if (!dcs.empty()) {
+    snapshot.m_lat_start = dcs.front().m_lat_start;
+    snapshot.m_lon_start = dcs.front().m_lon_start;
+  }
+
+  PlanSnapshot::Chunk chunk;
+  chunk.reserve(kMaxChunk);
+  for (auto dc = dcs.begin(); dc != dcs.end(); ++dc) {
+    bool first = dc == dcs.begin();
+    chunk.push_back({dc->m_timestamp, dc->m_is_twa ? dc->m_twa : dc->m_course,
+                     dc->m_is_twa, first ? -1.0 : dc->m_lat_start,
+                     first ? -1.0 : dc->m_lon_start});
+    if (chunk.size() < kMaxChunk && !ends_chunk(dc->m_timestamp) &&
+        std::next(dc) != dcs.end())
+      continue;
+
+    auto shared = current.find(chunk.front().m_timestamp);
+    if (shared != current.end() && **shared->second == chunk)
+      snapshot.m_chunks.push_back(*shared->second);
+    else
+      snapshot.m_chunks.push_back(
+          std::make_shared<const PlanSnapshot::Chunk>(chunk));
+    chunk.clear();
+  }
+
+  return snapshot;
+}
+
+bool PlanHistory::Commit(const std::list<Dc>& dcs) {
+  PlanSnapshot snapshot = MakeSnapshot(dcs);
+  if (snapshot.IsSame(m_current)) {
+    // The start position follows the boat, and must not make a new version
+    m_current.m_lat_start = snapshot.m_lat_start;
+    m_current.m_lon_start = snapshot.m_lon_start;
+    return false;
+  }
+
+  // The first plan, e.g. one loaded on race selection, has no predecessor
+  if (!m_current.IsEmpty() || !m_undo.empty())
+    m_undo.push_back(std::move(m_current));
+  if (m_undo.size() > kMaxUndo) m_undo.pop_front();
+  m_redo.clear();
+  m_current = std::move(snapshot);
+  return true;
+}
+
+bool PlanHistory::Undo(std::list<Dc>& dcs) {
+  if (m_undo.empty()) return false;
+
+  m_redo.push_back(std::move(m_current));
+  m_current = std::move(m_undo.back());
+  m_undo.pop_back();
+  m_current.GetDcs(dcs);
+  return true;
+}
+
+bool PlanHistory::Redo(std::list<Dc>& dcs) {
+  if (m_redo.empty()) return false;
+
+  m_undo.push_back(std::move(m_current));
+  m_current = std::move(m_redo.back());
+  m_redo.pop_back();
+  m_current.GetDcs(dcs);
+  return true;
+}
+
+void PlanHistory::Keep(const std::string& name) {
+  for (auto& kept : m_kept)
+    if (kept.first == name) {
+      kept.second = m_current;
+      return;
+    }
+  m_kept.emplace_back(name, m_current);
+}
+
+bool PlanHistory::Restore(size_t i, std::list<Dc>& dcs) {
+  if (i >= m_kept.size()) return false;
+
+  m_kept[i].second.GetDcs(dcs);
+  Commit(dcs);
+  return true;
+}
+
+size_t PlanHistory::GetStoredDcs() const {
+  std::unordered_set<const PlanSnapshot::Chunk*> chunks;
+  size_t stored = 0;
+  auto count = [&](const PlanSnapshot& snapshot) {
+    for (const auto& chunk : snapshot.m_chunks)
+      if (chunks.insert(chunk.get()).second) stored += chunk->size();
+  };
+
+  count(m_current);
+  for (const auto& snapshot : m_undo) count(snapshot);
+  for (const auto& snapshot : m_redo) count(snapshot);
+  for (const auto& kept : m_kept) count(kept.second);
+  return stored;
+}
+
+void PlanHistory::GetEtas(
+    const DcModel& model, const PlanSnapshot& plan,
+    const std::vector<std::pair<double, double>>& waypoints, double radius,
+    std::vector<double>& etas) {
+  std::list<Dc> dcs;
+  plan.GetDcs(dcs);
+  model.EnrichDcs(dcs);
+  EtaSink sink(waypoints, radius, etas);
+  model.MakeTrack(dcs, sink);
+}
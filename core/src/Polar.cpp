@@ -0,0 +1,310 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "Polar.h"
+#include "SolFile.h"
+#include "SolXml.h"
+
+namespace {
+static constexpr double kMsToKnots = 3600.0 / 1852.0;
+
+// Binary cache: "SOLPOLAR", version, byte order mark (kByteOrder as written
+// by the machine), number of columns (TWS) and rows (TWA) as uint32, then
+// TWS, TWA and the row-major boat speeds as doubles. Host byte order, a cache
+// of another byte order is rejected and parsed again
+static constexpr char kBinaryMagic[8] = {'S', 'O', 'L', 'P',
+                                         'O', 'L', 'A', 'R'};
+static constexpr uint32_t kBinaryVersion = 2;
+static constexpr uint32_t kByteOrder = 0x01020304;
+static constexpr uint32_t kByteOrderSwapped = 0x04030201;
+static constexpr size_t kBinaryHeaderSize =
+    sizeof(kBinaryMagic) + 4 * sizeof(uint32_t);
+
+/// Append the whitespace-separated numbers of text to values. Returns false
+/// if text contains anything else
+bool parse_numbers(std::string_view text, std::vector<double>& values) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  while (p < end) {
+    if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+      ++p;
+      continue;
+    }
+    double value;
+    if (!SolXml::ParseNumber(p, end, value)) return false;
+    // Numbers must be separated
+    if (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+      return false;
+    values.push_back(value);
+  }
+  return true;
+}
+
+/// Shortest of 15 and 17 significant digits that reads back to the same
+/// value, with a '.' whatever the locale of the application
+void append_number(std::string& out, double value) {
+  const char* point = std::localeconv()->decimal_point;
+  size_t point_size = std::strlen(point);
+  char buffer[48];
+  for (int precision : {15, 17}) {
+    int size = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    std::string text(buffer, std::max(0, std::min(size, 47)));
+    if (point_size > 0 && std::strcmp(point, ".") != 0) {
+      size_t i = text.find(point);
+      if (i != std::string::npos) text.replace(i, point_size, ".");
+    }
+    const char* p = text.data();
+    double back;
+    if (precision == 17 ||
+        (SolXml::ParseNumber(p, text.data() + text.size(), back) &&
+         back == value)) {
+      out.append(text);
+      return;
+    }
+  }
+}
+
+/// Find i so that axis[i] <= x <= axis[i + 1] and the weight of axis[i + 1].
+/// Values outside the axis are clamped
+void locate(const std::vector<double>& axis, double x, size_t& i,
+            double& weight) {
+  if (axis.size() < 2 || x <= axis.front()) {
+    i = 0;
+    weight = 0.0;
+    return;
+  }
+  if (x >= axis.back()) {
+    i = axis.size() - 2;
+    weight = 1.0;
+    return;
+  }
+
+  i = std::upper_bound(axis.begin(), axis.end(), x) - axis.begin() - 1;
+  weight = (x - axis[i]) / (axis[i + 1] - axis[i]);
+}
+}  // namespace
+
+std::vector<std::string> Polar::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool Polar::Parse(const SolXml::Vpp& vpp) {
+  m_tws.clear();
+  m_twa.clear();
+  m_bs.clear();
+
+  auto fail = [this](const std::string& error) {
+    m_errors.emplace_back("Format error in polar, " + error);
+    m_tws.clear();
+    m_twa.clear();
+    m_bs.clear();
+    return false;
+  };
+
+  if (!parse_numbers(vpp.m_tws_splined, m_tws) ||
+      !parse_numbers(vpp.m_twa_splined, m_twa))
+    return fail("TWS or TWA data is not a list of numbers");
+  if (m_tws.empty() || m_twa.empty()) return fail("no TWS or TWA data");
+  if (std::adjacent_find(m_tws.begin(), m_tws.end(), std::greater_equal<>()) !=
+          m_tws.end() ||
+      std::adjacent_find(m_twa.begin(), m_twa.end(), std::greater_equal<>()) !=
+          m_twa.end())
+    return fail("TWS or TWA data is not ascending");
+  for (auto& tws : m_tws) tws *= kMsToKnots;
+
+  // One row of boat speeds per TWA, separated by ';'
+  m_bs.reserve(m_twa.size() * m_tws.size());
+  std::string_view bss(vpp.m_bs_splined);
+  size_t row = 0;
+  while (!bss.empty()) {
+    size_t separator = bss.find(';');
+    std::string_view bs_line = bss.substr(0, separator);
+    bss.remove_prefix(separator == std::string_view::npos ? bss.size()
+                                                          : separator + 1);
+    if (bs_line.find_first_not_of(" \t\r\n") == std::string_view::npos)
+      continue;  // E.g. after a trailing ';'
+
+    if (row == m_twa.size())
+      return fail("more rows of boat speeds than TWA values");
+    size_t columns = m_bs.size();
+    if (!parse_numbers(bs_line, m_bs))
+      return fail("boat speeds for TWA " + std::to_string(m_twa[row]) +
+                  " are not a list of numbers");
+    columns = m_bs.size() - columns;
+    if (columns != m_tws.size())
+      return fail("row for TWA " + std::to_string(m_twa[row]) + " has " +
+                  std::to_string(columns) + " boat speeds instead of " +
+                  std::to_string(m_tws.size()));
+    ++row;
+  }
+  if (row != m_twa.size())
+    return fail(std::to_string(row) + " rows of boat speeds for " +
+                std::to_string(m_twa.size()) + " TWA values");
+
+  return true;
+}
+
+bool Polar::WriteCsv(const std::string& path) {
+  if (IsEmpty()) {
+    m_errors.emplace_back("Cannot export empty polar");
+    return false;
+  }
+
+  // Assembled in memory and written at once
+  std::string csv;
+  csv.reserve(12 * (m_twa.size() + 1) * (m_tws.size() + 1));
+  csv.append("twa/tws");
+  for (double tws : m_tws) {
+    csv.push_back(';');
+    append_number(csv, tws);
+  }
+  csv.push_back('\n');
+  for (size_t i_twa = 0; i_twa < m_twa.size(); ++i_twa) {
+    append_number(csv, m_twa[i_twa]);
+    for (size_t i_tws = 0; i_tws < m_tws.size(); ++i_tws) {
+      csv.push_back(';');
+      append_number(csv, GetBs(i_twa, i_tws));
+    }
+    csv.push_back('\n');
+  }
+
+  std::string error;
+  if (!SolFile::WriteAtomic(path, csv, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+bool Polar::SaveBinary(const std::string& path) {
+  if (IsEmpty()) {
+    m_errors.emplace_back("Cannot cache empty polar");
+    return false;
+  }
+
+  const uint32_t header[4] = {kBinaryVersion, kByteOrder,
+                              static_cast<uint32_t>(m_tws.size()),
+                              static_cast<uint32_t>(m_twa.size())};
+  std::string data;
+  data.reserve(kBinaryHeaderSize +
+               sizeof(double) * (m_tws.size() + m_twa.size() + m_bs.size()));
+  data.append(kBinaryMagic, sizeof(kBinaryMagic));
+  data.append(reinterpret_cast<const char*>(header), sizeof(header));
+  for (const auto* values : {&m_tws, &m_twa, &m_bs})
+    data.append(reinterpret_cast<const char*>(values->data()),
+                sizeof(double) * values->size());
+
+  std::string error;
+  if (!SolFile::WriteAtomic(path, data, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+bool Polar::LoadBinary(const std::string& path) {
+  std::string data;
+  if (!SolFile::Read(path, data)) {
+    m_errors.emplace_back("Could not read polar cache " + path);
+    return false;
+  }
+
+  uint32_t header[4];
+  if (data.size() < kBinaryHeaderSize ||
+      std::memcmp(data.data(), kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+    m_errors.emplace_back("Not a polar cache: " + path);
+    return false;
+  }
+  std::memcpy(header, data.data() + sizeof(kBinaryMagic), sizeof(header));
+  if (header[1] == kByteOrderSwapped) {
+    m_errors.emplace_back("Polar cache of another byte order: " + path);
+    return false;
+  }
+  const uint64_t columns = header[2], rows = header[3];
+  if (header[0] != kBinaryVersion || header[1] != kByteOrder || columns == 0 ||
+      rows == 0 ||
+      data.size() != kBinaryHeaderSize +
+                         sizeof(double) * (columns + rows + columns * rows)) {
+    m_errors.emplace_back("Outdated or damaged polar cache: " + path);
+    return false;
+  }
+
+  const char* p = data.data() + kBinaryHeaderSize;
+  for (auto [values, size] : {std::make_pair(&m_tws, columns),
+                              std::make_pair(&m_twa, rows),
+                              std::make_pair(&m_bs, columns * rows)}) {
+    values->resize(size);
+    std::memcpy(values->data(), p, sizeof(double) * size);
+    p += sizeof(double) * size;
+  }
+
+  return true;
+}
+
+double Polar::GetSpeedThroughWater(double tws, double twa) const {
+  if (IsEmpty() || tws < 0.0 || std::isnan(twa)) return -1.0;
+
+  twa = std::fabs(twa);
+  if (twa > 180.0) twa = 360.0 - twa;
+
+  size_t i_tws, i_twa;
+  double w_tws, w_twa;
+  locate(m_tws, tws, i_tws, w_tws);
+  locate(m_twa, twa, i_twa, w_twa);
+  size_t i_tws1 = std::min(i_tws + 1, m_tws.size() - 1);
+  size_t i_twa1 = std::min(i_twa + 1, m_twa.size() - 1);
+
+  double bs0 =
+      (1.0 - w_tws) * GetBs(i_twa, i_tws) + w_tws * GetBs(i_twa, i_tws1);
+  double bs1 =
+      (1.0 - w_tws) * GetBs(i_twa1, i_tws) + w_tws * GetBs(i_twa1, i_tws1);
+  return (1.0 - w_twa) * bs0 + w_twa * bs1;
+}
+
+std::pair<double, double> Polar::GetBoatOptimalAngles(double tws) const {
+  if (IsEmpty() || tws < 0.0) return {-1.0, -1.0};
+
+  double best_up = -1.0, best_down = -1.0;
+  double vmg_up = 0.0, vmg_down = 0.0;
+  for (double twa : m_twa) {
+    double vmg = GetSpeedThroughWater(tws, twa) * std::cos(twa * M_PI / 180.0);
+    if (twa <= 90.0 && vmg > vmg_up) {
+      vmg_up = vmg;
+      best_up = twa;
+    } else if (twa >= 90.0 && -vmg > vmg_down) {
+      vmg_down = -vmg;
+      best_down = twa;
+    }
+  }
+
+  return {best_up, best_down};
+}
@@ -0,0 +1,284 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include "Geodesy.h"
+#include "Robustness.h"
+#include "ThreadPool.h"
+
+namespace {
+using Geodesy::kDegToRad;
+
+/// Seed of a run (SplitMix64), so that neighbouring runs are not correlated
+uint64_t get_run_seed(uint64_t seed, uint64_t run) {
+  uint64_t z = seed + (run + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/// Random numbers that are the same on every platform, unlike the
+/// distributions of the standard library
+class Random {
+public:
+  explicit Random(uint64_t seed) : m_engine(seed) {}
+
+  /// Uniform in (0, 1)
+  double Uniform() { return ((m_engine() >> 11) + 0.5) * 0x1.0p-53; }
+  /// Standard normal (Box-Muller)
+  double Normal() {
+    double radius = std::sqrt(-2.0 * std::log(Uniform()));
+    return radius * std::cos(2.0 * M_PI * Uniform());
+  }
+
+private:
+  std::mt19937_64 m_engine;
+};
+
+/// The forecast as one run sees it
+class PerturbedWind : public WindProvider {
+public:
+  PerturbedWind(const WindProvider& wind, const RobustnessSettings& settings)
+      : m_wind(wind), m_settings(settings) {}
+
+  /// Draw the perturbation of a run
+  void Reset(uint64_t seed) {
+    Random random(seed);
+    m_speed_bias = m_settings.m_speed_sigma * random.Normal();
+    m_speed_wave = m_settings.m_speed_sigma * random.Normal();
+    m_speed_phase = 2.0 * M_PI * random.Uniform();
+    m_direction_bias = m_settings.m_direction_sigma * random.Normal();
+    m_direction_wave = m_settings.m_direction_sigma * random.Normal();
+    m_direction_phase = 2.0 * M_PI * random.Uniform();
+    m_shift = std::llround(m_settings.m_time_sigma * 3600.0 * random.Normal());
+  }
+
+  std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                        double lon) const override {
+    // The weather comes m_shift seconds early. Where the shifted time is
+    // beyond the forecast it comes on time
+    auto wind = m_wind.GetWindData(t + m_shift, lat, lon);
+    if (wind.first < 0.0) wind = m_wind.GetWindData(t, lat, lon);
+    if (wind.first < 0.0) return wind;
+
+    double period = m_settings.m_wave_period * 3600.0;
+    double phase =
+        period > 0.0 ? 2.0 * M_PI * std::fmod(double(t), period) / period : 0;
+    double factor = 1.0 + m_speed_bias +
+                    m_speed_wave * std::sin(phase + m_speed_phase);
+    wind.first *= std::max(0.0, factor);
+    double twd = wind.second + m_direction_bias +
+                 m_direction_wave * std::sin(phase + m_direction_phase);
+    wind.second = std::fmod(std::fmod(twd, 360.0) + 360.0, 360.0);
+    return wind;
+  }
+
+private:
+  const WindProvider& m_wind;
+  const RobustnessSettings& m_settings;
+  double m_speed_bias = 0.0;
+  double m_speed_wave = 0.0;
+  double m_speed_phase = 0.0;
+  double m_direction_bias = 0.0;
+  double m_direction_wave = 0.0;
+  double m_direction_phase = 0.0;
+  std::time_t m_shift = 0;
+};
+
+/// Track of a run, a point per leg and the end of the plan
+class RunTrack : public TrackSink {
+public:
+  std::vector<TrackPoint> m_points;
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    m_points.push_back({t, lat, lon});
+  }
+};
+
+/// Distance (nm) of the closest approach of the segment from a to b to the
+/// position, and its time
+double get_closest_approach(const TrackPoint& a, const TrackPoint& b,
+                            double lat, double lon, std::time_t& t) {
+  double f;
+  double distance = Geodesy::ClosestApproachFlat(a.m_lat, a.m_lon, b.m_lat,
+                                                 b.m_lon, lat, lon, &f);
+  t = a.m_time + std::llround(f * std::difftime(b.m_time, a.m_time));
+  return distance;
+}
+
+/// Value at quantile q of sorted values (nearest rank)
+template <typename T>
+T get_quantile(const std::vector<T>& sorted, double q) {
+  return sorted[std::lround(q * (sorted.size() - 1))];
+}
+}  // namespace
+
+Robustness::Robustness(const WindProvider& wind, const PolarProvider& polar,
+                       const RobustnessSettings& settings, ThreadPool* pool)
+    : m_wind(wind), m_polar(polar), m_settings(settings), m_pool(pool) {}
+
+std::vector<std::string> Robustness::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool Robustness::Evaluate(
+    const DcModel::Plan& plan,
+    const std::vector<std::pair<double, double>>& waypoints,
+    RobustnessResult& result) {
+  result = RobustnessResult();
+  if (plan.m_legs.empty()) {
+    m_errors.emplace_back("No DCs to test");
+    return false;
+  }
+  const Dc& first = plan.m_legs.front();
+  if (m_wind.GetWindData(first.m_timestamp, first.m_lat_start,
+                         first.m_lon_start)
+          .first < 0.0) {
+    m_errors.emplace_back("No wind data at the first DC");
+    return false;
+  }
+  const size_t runs = m_settings.m_runs;
+  if (runs == 0) {
+    m_errors.emplace_back("No runs to test the DCs");
+    return false;
+  }
+
+  // Results of the runs, run-major
+  const size_t points = plan.m_legs.size() + 1;
+  const size_t marks = waypoints.size();
+  std::vector<double> lats(runs * points), lons(runs * points);
+  std::vector<std::time_t> etas(runs * marks);
+  std::vector<double> distances(runs * marks);
+
+  // Contiguous blocks of runs, one per thread, each with its own
+  // simulator. Nothing is allocated per run
+  const size_t blocks = std::min(runs, (m_pool ? m_pool->GetSize() : 0) + 1);
+  auto sail = [&](size_t block) {
+    PerturbedWind wind(m_wind, m_settings);
+    DcModel model(wind, m_polar);
+    RunTrack track;
+    track.m_points.reserve(points);
+
+    for (size_t run = block * runs / blocks;
+         run < (block + 1) * runs / blocks; ++run) {
+      wind.Reset(get_run_seed(m_settings.m_seed, run));
+      track.m_points.clear();
+      model.MakeTrack(plan, track);
+
+      const auto& sailed = track.m_points;
+      for (size_t i = 0; i < points; ++i) {
+        lats[run * points + i] = sailed[i].m_lat;
+        lons[run * points + i] = sailed[i].m_lon;
+      }
+
+      // Waypoints in order: each is searched after the closest approach to
+      // the one before
+      size_t from = 0;
+      for (size_t mark = 0; mark < marks; ++mark) {
+        auto [lat, lon] = waypoints[mark];
+        double best = INFINITY;
+        std::time_t eta = sailed.back().m_time;
+        for (size_t i = from; i + 1 < points; ++i) {
+          std::time_t t;
+          double distance =
+              get_closest_approach(sailed[i], sailed[i + 1], lat, lon, t);
+          if (distance < best) {
+            best = distance;
+            eta = t;
+            from = i;
+          }
+        }
+        etas[run * marks + mark] = eta;
+        distances[run * marks + mark] = best;
+      }
+    }
+  };
+  if (m_pool == nullptr)
+    sail(0);
+  else
+    m_pool->ParallelFor(blocks, sail);
+
+  std::vector<std::time_t> sorted_etas(runs);
+  std::vector<double> sorted_distances(runs);
+  for (size_t mark = 0; mark < marks; ++mark) {
+    for (size_t run = 0; run < runs; ++run) {
+      sorted_etas[run] = etas[run * marks + mark];
+      sorted_distances[run] = distances[run * marks + mark];
+    }
+    std::sort(sorted_etas.begin(), sorted_etas.end());
+    std::sort(sorted_distances.begin(), sorted_distances.end());
+    RobustnessEta eta;
+    eta.m_min = sorted_etas.front();
+    eta.m_p10 = get_quantile(sorted_etas, 0.1);
+    eta.m_p50 = get_quantile(sorted_etas, 0.5);
+    eta.m_p90 = get_quantile(sorted_etas, 0.9);
+    eta.m_max = sorted_etas.back();
+    eta.m_distance = get_quantile(sorted_distances, 0.5);
+    eta.m_reached =
+        std::upper_bound(sorted_distances.begin(), sorted_distances.end(),
+                         m_settings.m_waypoint_radius) -
+        sorted_distances.begin();
+    result.m_etas.push_back(eta);
+  }
+
+  // Spread of the positions at the track points, in nm around their mean.
+  // Longitudes relative to the first run, in case the plan crosses 180
+  std::vector<double> spreads(points);
+  for (size_t i = 0; i < points; ++i) {
+    double lon0 = lons[i];
+    double mean_lat = 0.0, mean_dlon = 0.0;
+    for (size_t run = 0; run < runs; ++run) {
+      mean_lat += lats[run * points + i];
+      mean_dlon += Geodesy::NormalizeLonDelta(lons[run * points + i] - lon0);
+    }
+    mean_lat /= runs;
+    mean_dlon /= runs;
+    double scale = std::cos(mean_lat * kDegToRad);
+    double sum = 0.0;
+    for (size_t run = 0; run < runs; ++run) {
+      double dy = lats[run * points + i] - mean_lat;
+      double dx = (Geodesy::NormalizeLonDelta(lons[run * points + i] - lon0) -
+                   mean_dlon) *
+                  scale;
+      sum += dx * dx + dy * dy;
+    }
+    spreads[i] = 60.0 * std::sqrt(sum / runs);
+  }
+
+  size_t i = 0;
+  for (const auto& leg : plan.m_legs) {
+    result.m_legs.push_back({leg.m_timestamp, spreads[i], spreads[i + 1]});
+    ++i;
+  }
+  result.m_sensitive.resize(result.m_legs.size());
+  std::iota(result.m_sensitive.begin(), result.m_sensitive.end(), 0);
+  auto growth = [&](size_t leg) {
+    return result.m_legs[leg].m_spread_end - result.m_legs[leg].m_spread_begin;
+  };
+  std::stable_sort(result.m_sensitive.begin(), result.m_sensitive.end(),
+                   [&](size_t a, size_t b) { return growth(a) > growth(b); });
+
+  return true;
+}
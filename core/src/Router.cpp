@@ -0,0 +1,278 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+
+#include "Geodesy.h"
+#include "Performance.h"
+#include "Router.h"
+#include "ThreadPool.h"
+
+using namespace Performance;
+
+namespace {
+/// Node of an isochrone, with the leg that reached it from its parent
+struct Node {
+  double m_lat;
+  double m_lon;
+  double m_course;
+  double m_twa;
+  double m_perf_begin;  // After the course change at the parent
+  double m_perf_end;    // On arrival at this node
+  int m_parent;         // Index of the parent node, -1 for the root
+  int m_isochrone;
+};
+
+struct Candidate {
+  bool m_valid = false;
+  Node m_node;
+  double m_arrival = -1.0;  // Seconds to the waypoint if passed on the way
+  double m_arrival_perf;
+};
+
+/// Distance (nm) sailed in seconds at the polar speed stw, while performance
+/// recovers as in DcModel::MakeTrack()
+double sail(double& performance, double stw, double seconds) {
+  double dist = 0.0;
+  double time = 0.0;
+  while (performance < 1.0 && time < seconds) {
+    double jump = std::min(kStepSeconds, seconds - time);
+    performance = get_recovery_step(performance, jump, stw * performance);
+    dist += stw * performance * jump / 3600.0;
+    time += jump;
+  }
+  performance = std::min(performance, 1.0);
+
+  return dist + stw * (seconds - time) / 3600.0;
+}
+
+double normalize_twa(double twa) {
+  twa = std::fmod(twa, 360.0);
+  if (twa > 180.0) return twa - 360.0;
+  if (twa <= -180.0) return twa + 360.0;
+  return twa;
+}
+
+/// Cell of the reached grid. Cells are cell_size nm high and approximately
+/// as wide
+int64_t cell_key(double lat, double lon, double cell_size) {
+  int64_t row = static_cast<int64_t>(std::floor(lat * 60.0 / cell_size));
+  double row_lat = (row + 0.5) * cell_size / 60.0;
+  double width = cell_size / std::max(0.01, std::cos(row_lat * M_PI / 180.0));
+  int64_t column = static_cast<int64_t>(std::floor(lon * 60.0 / width));
+  return (row << 32) ^ (column & 0xFFFFFFFF);
+}
+}  // namespace
+
+Router::Router(const WindProvider& wind, const PolarProvider& polar,
+               const RouterSettings& settings, ThreadPool* pool)
+    : m_wind(wind), m_polar(polar), m_settings(settings), m_pool(pool) {}
+
+std::vector<std::string> Router::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool Router::Route(const TrackPoint& start,
+                   const std::vector<std::pair<double, double>>& waypoints,
+                   std::vector<RoutePoint>& route) {
+  route.clear();
+  // No course before the start, so the first course change is free
+  route.push_back({start.m_time, start.m_lat, start.m_lon, 0.0, 0.0, 1.0});
+
+  for (size_t i = 0; i < waypoints.size(); ++i) {
+    if (!RouteLeg(waypoints[i].first, waypoints[i].second, route)) {
+      m_errors.emplace_back("Could not route to waypoint " +
+                            std::to_string(i + 1));
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Router::RouteLeg(double lat, double lon, std::vector<RoutePoint>& route) {
+  const RoutePoint start = route.back();
+  double leg_bearing, leg_dist;
+  Geodesy::DistanceBearingMercator(lat, lon, start.m_lat, start.m_lon,
+                                   &leg_bearing, &leg_dist);
+  if (leg_dist <= m_settings.m_arrival_radius) return true;
+
+  const double step = m_settings.m_time_step;
+  const size_t n_headings = std::max<size_t>(
+      1, std::lround(360.0 / m_settings.m_heading_step));
+  const double heading_step = 360.0 / n_headings;
+  const size_t n_sectors =
+      std::max<size_t>(1, std::lround(360.0 / m_settings.m_sector));
+  const double sector_size = 360.0 / n_sectors;
+
+  // All nodes of the leg, the current isochrone is [front_begin, end)
+  std::vector<Node> nodes{{start.m_lat, start.m_lon, start.m_course,
+                           start.m_twa, start.m_performance,
+                           start.m_performance, -1, 0}};
+  size_t front_begin = 0;
+  std::unordered_set<int64_t> reached{
+      cell_key(start.m_lat, start.m_lon, m_settings.m_cell_size)};
+  std::vector<Candidate> candidates;
+  std::vector<int> sector_best(n_sectors);
+  std::vector<double> sector_dist(n_sectors);
+
+  for (size_t k = 0; k < m_settings.m_max_isochrones; ++k) {
+    const std::time_t t = start.m_time + static_cast<std::time_t>(k * step);
+    const size_t front_size = nodes.size() - front_begin;
+    candidates.assign(front_size * (n_headings + 1), Candidate());
+
+    // Expand every node of the isochrone by a fan of headings
+    auto expand = [&](size_t i) {
+      const Node& node = nodes[front_begin + i];
+      auto [tws, twd] = m_wind.GetWindData(t, node.m_lat, node.m_lon);
+      if (tws < 0.0) return;
+      double target_bearing, target_dist;
+      Geodesy::DistanceBearingMercator(lat, lon, node.m_lat, node.m_lon,
+                                       &target_bearing, &target_dist);
+
+      // The fan plus the direct course to the waypoint, which the fan
+      // misses far from the start, where the nodes are sparse
+      for (size_t h = 0; h <= n_headings; ++h) {
+        double course = (h < n_headings) ? h * heading_step : target_bearing;
+        double twa = normalize_twa(twd - course);
+        if (std::fabs(twa) < kTwaZero) continue;
+        double stw = m_polar.GetSpeedThroughWater(tws, twa);
+        if (stw <= 0.0) continue;
+
+        // No course at the start: no maneuver
+        double perf_begin =
+            (node.m_twa == 0.0) ? node.m_perf_end
+                                : get_performance(node.m_perf_end, stw,
+                                                  node.m_twa, twa);
+        double perf_end = perf_begin;
+        double dist = sail(perf_end, stw, step);
+
+        Candidate& c = candidates[i * (n_headings + 1) + h];
+        c.m_valid = true;
+        Node& next = c.m_node;
+        Geodesy::PositionBearingDistanceMercator(
+            node.m_lat, node.m_lon, course, dist, &next.m_lat, &next.m_lon);
+        next.m_course = course;
+        next.m_twa = twa;
+        next.m_perf_begin = perf_begin;
+        next.m_perf_end = perf_end;
+        next.m_parent = static_cast<int>(front_begin + i);
+        next.m_isochrone = static_cast<int>(k + 1);
+
+        // Waypoint passed within the arrival radius?
+        double off = (course - target_bearing) * Geodesy::kDegToRad;
+        double along = target_dist * std::cos(off);
+        double cross = std::fabs(target_dist * std::sin(off));
+        if (dist > 0.0 && along >= 0.0 && along <= dist &&
+            cross <= m_settings.m_arrival_radius) {
+          c.m_arrival = step * along / dist;
+          c.m_arrival_perf = perf_begin;
+          sail(c.m_arrival_perf, stw, c.m_arrival);
+        }
+      }
+    };
+    if (m_pool)
+      m_pool->ParallelFor(front_size, expand);
+    else
+      for (size_t i = 0; i < front_size; ++i) expand(i);
+
+    // The earliest arrival ends the leg
+    const Candidate* arrival = nullptr;
+    for (const auto& c : candidates)
+      if (c.m_valid && c.m_arrival >= 0.0 &&
+          (arrival == nullptr || c.m_arrival < arrival->m_arrival))
+        arrival = &c;
+    if (arrival != nullptr) {
+      std::vector<const Node*> chain{&arrival->m_node};
+      for (int n = arrival->m_node.m_parent; n > 0; n = nodes[n].m_parent)
+        chain.push_back(&nodes[n]);
+      std::reverse(chain.begin(), chain.end());
+
+      // Leg from each point to the next
+      for (const Node* node : chain) {
+        RoutePoint& from = route.back();
+        from.m_course = node->m_course;
+        from.m_twa = node->m_twa;
+        from.m_performance = node->m_perf_begin;
+        if (node == chain.back()) break;
+
+        std::time_t node_time =
+            start.m_time + static_cast<std::time_t>(node->m_isochrone * step);
+        route.push_back({node_time, node->m_lat, node->m_lon, node->m_course,
+                         node->m_twa, node->m_perf_end});
+      }
+      std::time_t arrival_time =
+          t + static_cast<std::time_t>(std::lround(arrival->m_arrival));
+      route.push_back({arrival_time, lat, lon, arrival->m_node.m_course,
+                       arrival->m_node.m_twa, arrival->m_arrival_perf});
+      return true;
+    }
+
+    // Keep the farthest new node per sector, towards the waypoint
+    std::fill(sector_best.begin(), sector_best.end(), -1);
+    std::fill(sector_dist.begin(), sector_dist.end(), 0.0);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const Candidate& c = candidates[i];
+      if (!c.m_valid ||
+          reached.count(cell_key(c.m_node.m_lat, c.m_node.m_lon,
+                                 m_settings.m_cell_size)) > 0)
+        continue;
+
+      double bearing, dist;
+      Geodesy::DistanceBearingMercator(c.m_node.m_lat, c.m_node.m_lon,
+                                       start.m_lat, start.m_lon, &bearing,
+                                       &dist);
+      if (std::fabs(normalize_twa(bearing - leg_bearing)) >
+          m_settings.m_max_spread)
+        continue;
+
+      size_t sector =
+          std::min(n_sectors - 1, static_cast<size_t>(bearing / sector_size));
+      if (dist > sector_dist[sector]) {
+        sector_dist[sector] = dist;
+        sector_best[sector] = static_cast<int>(i);
+      }
+    }
+
+    // Everything reached now can't be reached faster later
+    for (const auto& c : candidates)
+      if (c.m_valid)
+        reached.insert(cell_key(c.m_node.m_lat, c.m_node.m_lon,
+                                m_settings.m_cell_size));
+
+    front_begin = nodes.size();
+    for (int best : sector_best)
+      if (best >= 0) nodes.push_back(candidates[best].m_node);
+    if (nodes.size() == front_begin) {
+      m_errors.emplace_back("Isochrone " + std::to_string(k + 1) +
+                            " is empty, no wind or boat data");
+      return false;
+    }
+  }
+
+  m_errors.emplace_back("Waypoint not reached after " +
+                        std::to_string(m_settings.m_max_isochrones) +
+                        " isochrones");
+  return false;
+}
@@ -0,0 +1,339 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "SolFile.h"
+
+namespace {
+std::atomic<unsigned> g_temp_files{0};
+
+/// Name of a temporary file next to path that no other write uses, also
+/// not one of the same file by another thread or process
+std::string get_temp_path(const std::string& path) {
+#ifdef _WIN32
+  unsigned long pid = GetCurrentProcessId();
+#else
+  unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+  return path + "." + std::to_string(pid) + "." +
+         std::to_string(++g_temp_files) + ".tmp";
+}
+
+/// 64 bit FNV-1a, the same on all platforms
+uint64_t get_hash(const std::string& contents) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : contents) hash = (hash ^ c) * 1099511628211ull;
+  return hash;
+}
+
+#ifdef _WIN32
+std::wstring widen(const std::string& utf8) {
+  int size = MultiByteToWideChar(CP_UTF8, 0, utf8.data(),
+                                 static_cast<int>(utf8.size()), nullptr, 0);
+  std::wstring result(size, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()),
+                      &result[0], size);
+  return result;
+}
+
+/// Write contents to the new file temp and flush it to disk
+bool write_temp(const std::string& temp, const std::string& contents,
+                std::string& error) {
+  HANDLE file = CreateFileW(widen(temp).c_str(), GENERIC_WRITE, 0, nullptr,
+                            CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    error = "Could not create " + temp;
+    return false;
+  }
+  const char* p = contents.data();
+  size_t left = contents.size();
+  bool written = true;
+  while (written && left > 0) {
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(left, 1 << 30));
+    DWORD done = 0;
+    written = WriteFile(file, p, chunk, &done, nullptr) && done == chunk;
+    p += done;
+    left -= done;
+  }
+  written = written && FlushFileBuffers(file);
+  CloseHandle(file);
+  if (!written) error = "Could not write to " + temp;
+  return written;
+}
+#else
+bool write_temp(const std::string& temp, const std::string& contents,
+                std::string& error) {
+  int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  if (fd < 0) {
+    error = "Could not create " + temp + ": " + std::strerror(errno);
+    return false;
+  }
+  const char* p = contents.data();
+  size_t left = contents.size();
+  bool written = true;
+  while (written && left > 0) {
+    ssize_t done = write(fd, p, left);
+    if (done < 0 && errno == EINTR) continue;
+    written = done > 0;
+    if (written) {
+      p += done;
+      left -= static_cast<size_t>(done);
+    }
+  }
+  written = written && fsync(fd) == 0;
+  // Some file systems report failed writes only on close
+  written = close(fd) == 0 && written;
+  if (!written)
+    error = "Could not write to " + temp + ": " + std::strerror(errno);
+  return written;
+}
+
+/// Flush the directory entries of the directory of path to disk. Best
+/// effort, not every file system supports it
+void sync_directory(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+  int fd = open(dir.empty() ? "/" : dir.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return;
+  fsync(fd);
+  close(fd);
+}
+#endif
+}  // namespace
+
+namespace SolFile {
+
+bool Read(const std::string& path, std::string& contents) {
+#ifdef _WIN32
+  std::FILE* file = _wfopen(widen(path).c_str(), L"rb");
+  struct _stat64 st;
+  if (file != nullptr && _fstat64(_fileno(file), &st) != 0) st.st_size = 0;
+#else
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  struct stat st;
+  if (file != nullptr && fstat(fileno(file), &st) != 0) st.st_size = 0;
+#endif
+  if (file == nullptr) return false;
+
+  contents.clear();
+  contents.reserve(static_cast<size_t>(st.st_size));
+  char buffer[65536];
+  size_t count;
+  while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, count);
+  bool ok = !std::ferror(file);
+  std::fclose(file);
+  return ok;
+}
+
+bool CreateDirectories(const std::string& path) {
+  // Create every missing parent, existing directories are fine
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i < path.size() && path[i] != '/' && path[i] != '\\') continue;
+    std::string dir = path.substr(0, i);
+#ifdef _WIN32
+    if (dir.back() == ':') continue;
+    int result = _wmkdir(widen(dir).c_str());
+#else
+    int result = mkdir(dir.c_str(), 0777);
+#endif
+    if (result != 0 && errno != EEXIST) return false;
+  }
+#ifdef _WIN32
+  struct _stat64 st;
+  return _wstat64(widen(path).c_str(), &st) == 0 && (st.st_mode & _S_IFDIR);
+#else
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+bool WriteAtomic(const std::string& path, const std::string& contents,
+                 std::string& error) {
+  // The contents are on disk before the rename, so that a power loss leaves
+  // the old or the new file, not an empty one
+  std::string temp = get_temp_path(path);
+#ifdef _WIN32
+  if (!write_temp(temp, contents, error)) {
+    DeleteFileW(widen(temp).c_str());
+    return false;
+  }
+  if (!MoveFileExW(widen(temp).c_str(), widen(path).c_str(),
+                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    error = "Could not rename " + temp + " to " + path;
+    DeleteFileW(widen(temp).c_str());
+    return false;
+  }
+#else
+  if (!write_temp(temp, contents, error)) {
+    unlink(temp.c_str());
+    return false;
+  }
+  if (std::rename(temp.c_str(), path.c_str()) != 0) {
+    error = "Could not rename " + temp + ": " + std::strerror(errno);
+    unlink(temp.c_str());
+    return false;
+  }
+  sync_directory(path);
+#endif
+
+  return true;
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& path) {
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+  // The mapping keeps the file open
+  m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (m_mapping == nullptr) return false;
+  m_data = static_cast<const char*>(
+      MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_data == nullptr) {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+    return false;
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  // The mapping stays valid after closing the file
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return false;
+  m_data = static_cast<const char*>(data);
+  m_size = static_cast<size_t>(st.st_size);
+#endif
+
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_data == nullptr) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  m_mapping = nullptr;
+#else
+  munmap(const_cast<char*>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
+
+BackgroundWriter::BackgroundWriter() : m_thread(&BackgroundWriter::Run, this) {}
+
+BackgroundWriter::~BackgroundWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_queued.notify_one();
+  m_thread.join();
+}
+
+void BackgroundWriter::Write(const std::string& path, std::string contents) {
+  std::pair<size_t, uint64_t> fingerprint(contents.size(), get_hash(contents));
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto written = m_written.find(path);
+    if (path != m_writing && written != m_written.end() &&
+        written->second == fingerprint) {
+      // An older version may still be queued
+      m_queue.erase(path);
+      return;
+    }
+    m_queue[path] = std::move(contents);
+  }
+  m_queued.notify_one();
+}
+
+void BackgroundWriter::Flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle.wait(lock, [this] { return m_queue.empty() && m_writing.empty(); });
+}
+
+std::vector<std::string> BackgroundWriter::GetErrors() {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::swap(m_errors, result);
+  return result;
+}
+
+void BackgroundWriter::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_queued.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    // The queue is written before stopping
+    if (m_queue.empty()) return;
+
+    auto node = m_queue.extract(m_queue.begin());
+    m_writing = node.key();
+    lock.unlock();
+    std::string error;
+    bool written = WriteAtomic(node.key(), node.mapped(), error);
+    std::pair<size_t, uint64_t> fingerprint(node.mapped().size(),
+                                            get_hash(node.mapped()));
+    lock.lock();
+    m_writing.clear();
+    if (written) {
+      m_written[node.key()] = fingerprint;
+    } else {
+      m_written.erase(node.key());
+      m_errors.emplace_back(error);
+    }
+    if (m_queue.empty()) m_idle.notify_all();
+  }
+}
+}  // namespace SolFile
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <cstdio>
+
+#include "SolTime.h"
+
+namespace {
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, see
+// http://howardhinnant.github.io/date_algorithms.html
+long days_from_civil(int year, int month, int day) {
+  year -= month <= 2;
+  const long era = (year >= 0 ? year : year - 399) / 400;
+  const long yoe = year - era * 400;
+  const long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void civil_from_days(long days, int& year, int& month, int& day) {
+  days += 719468;
+  const long era = (days >= 0 ? days : days - 146096) / 146097;
+  const long doe = days - era * 146097;
+  const long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const long mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = yoe + era * 400 + (month <= 2);
+}
+
+void split(std::time_t t, int& year, int& month, int& day, int& hour,
+           int& minute, int& second) {
+  long days = t / 86400;
+  long seconds = t % 86400;
+  if (seconds < 0) {
+    seconds += 86400;
+    --days;
+  }
+  civil_from_days(days, year, month, day);
+  hour = seconds / 3600;
+  minute = seconds / 60 % 60;
+  second = seconds % 60;
+}
+}  // namespace
+
+namespace SolTime {
+
+std::time_t FromUtc(int year, int month, int day, int hour, int minute,
+                    int second) {
+  return static_cast<std::time_t>(days_from_civil(year, month, day)) * 86400 +
+         hour * 3600 + minute * 60 + second;
+}
+
+bool ParseUtc(const std::string& text, std::time_t& t) {
+  int year, month, day, hour, minute, second;
+  char date_sep1, date_sep2, time_sep;
+  if (std::sscanf(text.c_str(), "%d%c%d%c%d%c%d:%d:%d", &year, &date_sep1,
+                  &month, &date_sep2, &day, &time_sep, &hour, &minute,
+                  &second) != 9)
+    return false;
+  if ((date_sep1 != '/' && date_sep1 != '-') || date_sep2 != date_sep1 ||
+      (time_sep != ' ' && time_sep != 'T'))
+    return false;
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 ||
+      hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+    return false;
+
+  t = FromUtc(year, month, day, hour, minute, second);
+  return true;
+}
+
+std::string FormatUtc(std::time_t t) {
+  int year, month, day, hour, minute, second;
+  split(t, year, month, day, hour, minute, second);
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%04d/%02d/%02d %02d:%02d:%02d", year,
+                month, day, hour, minute, second);
+  return buffer;
+}
+
+std::string FormatIso8601(std::time_t t) {
+  int year, month, day, hour, minute, second;
+  split(t, year, month, day, hour, minute, second);
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02dZ", year,
+                month, day, hour, minute, second);
+  return buffer;
+}
+}  // namespace SolTime
@@ -0,0 +1,328 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+#include <pugixml.hpp>
+
+#include "SolTime.h"
+#include "SolXml.h"
+
+namespace {
+std::string trimmed(const char* value) {
+  static const char* kWhitespace = " \t\r\n";
+  std::string result(value);
+  size_t first = result.find_first_not_of(kWhitespace);
+  if (first == std::string::npos) return "";
+  size_t last = result.find_last_not_of(kWhitespace);
+  return result.substr(first, last - first + 1);
+}
+
+// Fields of the boat state after the time of the state, as seen in the files
+// served (see Race::GetRaceInfo()). The boat name before may contain spaces
+static constexpr size_t kBoatStw = 1;
+static constexpr size_t kBoatPerformance = 4;
+static constexpr size_t kBoatLon = 7;
+static constexpr size_t kBoatLat = 8;
+static constexpr size_t kBoatValue = 10;
+static constexpr size_t kBoatMode = 12;
+
+/// Epoch seconds of a time stamp like "1765824727UTCC"
+bool parse_epoch(const std::string& token, std::time_t& time) {
+  static const std::string kSuffix = "UTCC";
+  if (token.size() <= kSuffix.size() ||
+      token.compare(token.size() - kSuffix.size(), kSuffix.size(), kSuffix) !=
+          0)
+    return false;
+  char* end;
+  long long seconds = std::strtoll(token.c_str(), &end, 10);
+  if (end != token.c_str() + token.size() - kSuffix.size()) return false;
+  time = static_cast<std::time_t>(seconds);
+  return true;
+}
+
+// Powers of ten that are exact doubles
+static constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                    1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                    1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+}  // namespace
+
+namespace SolXml {
+
+bool ParseRaceList(const std::string& xml, std::vector<RaceEntry>& races,
+                   std::string& error) {
+  pugi::xml_document racelist_doc;
+  auto status = racelist_doc.load_buffer(xml.data(), xml.size());
+  if (!status) {
+    error = std::string("Could not parse racelist file: ") +
+            status.description();
+    return false;
+  }
+
+  // Parse xml and fill list of races
+  races.clear();
+  pugi::xml_node node_races = racelist_doc.child("races");
+
+  for (pugi::xml_node node_race = node_races.first_child();
+       node_race != nullptr; node_race = node_race.next_sibling()) {
+    if (strcmp(node_race.name(), "race") != 0) continue;
+
+    RaceEntry race;
+    for (pugi::xml_node node_race_child = node_race.first_child();
+         node_race_child != nullptr;
+         node_race_child = node_race_child.next_sibling()) {
+      const char* value = node_race_child.first_child().value();
+      if (strcmp(node_race_child.name(), "id") == 0)
+        race.m_id = trimmed(value);
+      else if (strcmp(node_race_child.name(), "name") == 0)
+        race.m_name = trimmed(value);
+      else if (strcmp(node_race_child.name(), "description") == 0)
+        race.m_description = trimmed(value);
+      else if (strcmp(node_race_child.name(), "message") == 0)
+        race.m_message = trimmed(value);
+      else if (strcmp(node_race_child.name(), "start_time") == 0)
+        race.m_start = trimmed(value);
+      else if (strcmp(node_race_child.name(), "url") == 0)
+        race.m_url = trimmed(value);
+    }
+
+    races.emplace_back(std::move(race));
+  }
+
+  return true;
+}
+
+bool ParseRaceInfo(const std::string& xml, RaceInfo& info,
+                   std::string& error) {
+  pugi::xml_document race_doc;
+  auto status = race_doc.load_buffer(xml.data(), xml.size());
+  if (!status) {
+    error = std::string("Could not parse race file: ") + status.description();
+    return false;
+  }
+
+  pugi::xml_node node_race = race_doc.child("race");
+  info.m_url = trimmed(node_race.child("url").first_child().value());
+  info.m_weatherurl =
+      trimmed(node_race.child("weatherurl").first_child().value());
+  info.m_traceurl = trimmed(node_race.child("traceUrl").first_child().value());
+  info.m_boaturl = trimmed(node_race.child("boaturl").first_child().value());
+
+  // Get boat polar
+  pugi::xml_node node_vpp = node_race.child("boat").child("vpp");
+  info.m_vpp.m_name = node_vpp.child("name").first_child().value();
+  info.m_vpp.m_tws_splined =
+      node_vpp.child("tws_splined").first_child().value();
+  info.m_vpp.m_twa_splined =
+      node_vpp.child("twa_splined").first_child().value();
+  info.m_vpp.m_bs_splined = node_vpp.child("bs_splined").first_child().value();
+
+  // Get waypoints
+  info.m_course.clear();
+  pugi::xml_node node_course = node_race.child("course");
+  for (pugi::xml_node node_wp = node_course.first_child(); node_wp != nullptr;
+       node_wp = node_wp.next_sibling()) {
+    if (strcmp(node_wp.name(), "waypoint") != 0) continue;
+
+    Waypoint wp{"", "", NAN, NAN};
+    for (pugi::xml_node node_wp_child = node_wp.first_child();
+         node_wp_child != nullptr;
+         node_wp_child = node_wp_child.next_sibling()) {
+      if (strcmp(node_wp_child.name(), "order") == 0)
+        wp.m_order = node_wp_child.first_child().value();
+      else if (strcmp(node_wp_child.name(), "name") == 0)
+        wp.m_name = trimmed(node_wp_child.first_child().value());
+      else if (strcmp(node_wp_child.name(), "lon") == 0)
+        wp.m_lon = node_wp_child.text().as_double(NAN);
+      else if (strcmp(node_wp_child.name(), "lat") == 0)
+        wp.m_lat = node_wp_child.text().as_double(NAN);
+    }
+
+    info.m_course.emplace_back(std::move(wp));
+  }
+
+  return true;
+}
+
+bool ParseDcList(const std::string& xml, std::vector<ServerDc>& dcs,
+                 std::string& error) {
+  pugi::xml_document dcs_doc;
+  auto status = dcs_doc.load_buffer(xml.data(), xml.size());
+  if (!status) {
+    error = std::string("Could not parse DC list: ") + status.description();
+    return false;
+  }
+
+  dcs.clear();
+  pugi::xml_node node_dcs = dcs_doc.child("dcs");
+  for (pugi::xml_node node_dc = node_dcs.first_child(); node_dc != nullptr;
+       node_dc = node_dc.next_sibling()) {
+    if (strcmp(node_dc.name(), "dc") != 0) continue;
+
+    ServerDc dc{"", 0, false, NAN};
+    std::string time, type;
+    for (pugi::xml_node node_dc_child = node_dc.first_child();
+         node_dc_child != nullptr;
+         node_dc_child = node_dc_child.next_sibling()) {
+      if (strcmp(node_dc_child.name(), "id") == 0)
+        dc.m_id = trimmed(node_dc_child.first_child().value());
+      else if (strcmp(node_dc_child.name(), "time") == 0)
+        time = trimmed(node_dc_child.first_child().value());
+      else if (strcmp(node_dc_child.name(), "type") == 0)
+        type = trimmed(node_dc_child.first_child().value());
+      else if (strcmp(node_dc_child.name(), "value") == 0)
+        dc.m_value = node_dc_child.text().as_double(NAN);
+    }
+
+    if (!SolTime::ParseUtc(time, dc.m_time) ||
+        (type != "cc" && type != "twa") || std::isnan(dc.m_value)) {
+      error = "Invalid DC " + dc.m_id + " in DC list";
+      return false;
+    }
+    dc.m_is_twa = type == "twa";
+    dcs.emplace_back(std::move(dc));
+  }
+
+  std::stable_sort(dcs.begin(), dcs.end(),
+                   [](const ServerDc& a, const ServerDc& b) {
+                     return a.m_time < b.m_time;
+                   });
+  return true;
+}
+
+bool ParseBoatState(const std::string& text, BoatState& state,
+                    std::string& error) {
+  std::istringstream stream(text);
+  std::vector<std::string> tokens;
+  for (std::string token; stream >> token;) tokens.push_back(token);
+
+  // Race start, then the time of the state
+  size_t stamps = 0, i = 0;
+  while (i < tokens.size() && stamps < 2)
+    if (parse_epoch(tokens[i++], state.m_time)) ++stamps;
+  if (stamps < 2 || tokens.size() - i <= kBoatMode) {
+    error = "Boat state is incomplete";
+    return false;
+  }
+
+  auto number = [&](size_t field) {
+    const std::string& token = tokens[i + field];
+    char* end;
+    double value = std::strtod(token.c_str(), &end);
+    return end == token.c_str() + token.size() ? value : NAN;
+  };
+  state.m_stw = number(kBoatStw);
+  state.m_performance = number(kBoatPerformance);
+  state.m_lon = number(kBoatLon);
+  state.m_lat = number(kBoatLat);
+  state.m_value = number(kBoatValue);
+  const std::string& mode = tokens[i + kBoatMode];
+  state.m_is_twa = mode == "twa";
+
+  if (!(std::fabs(state.m_lat) <= 90.0) || !(std::fabs(state.m_lon) <= 360.0) ||
+      !(state.m_stw >= 0.0) || !(state.m_performance > 0.0) ||
+      !(state.m_performance <= 1.0) || std::isnan(state.m_value) ||
+      (mode != "cc" && mode != "twa")) {
+    error = "Invalid boat state";
+    return false;
+  }
+
+  return true;
+}
+
+bool ParseWeatherInfo(const std::string& text, WeatherInfo& info,
+                      std::string& error) {
+  std::istringstream stream(text);
+  std::string date, time;
+  if (!(stream >> info.m_id >> date >> time >> info.m_url) ||
+      !SolTime::ParseUtc(date + " " + time, info.m_time)) {
+    error = "Weather info is incomplete";
+    return false;
+  }
+  if (info.m_url.compare(0, 4, "http") != 0) {
+    error = "Invalid weather URL " + info.m_url;
+    return false;
+  }
+
+  return true;
+}
+
+bool ParseNumber(const char*& p, const char* end, double& value) {
+  const char* start = p;
+  bool negative = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+')) ++p;
+
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool any = false;
+  auto add_digit = [&](char c) {
+    // Up to 19 digits fit, more make the number inexact anyway
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (c - '0');
+      if (mantissa != 0) ++digits;
+    } else {
+      ++digits;
+    }
+    any = true;
+  };
+  for (; p < end && is_digit(*p); ++p) add_digit(*p);
+  if (p < end && *p == '.') {
+    for (++p; p < end && is_digit(*p); ++p) {
+      add_digit(*p);
+      --exponent;
+    }
+  }
+  if (!any) {
+    p = start;
+    return false;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* e = p + 1;
+    bool e_negative = e < end && *e == '-';
+    if (e < end && (*e == '-' || *e == '+')) ++e;
+    if (e < end && is_digit(*e)) {
+      int e_value = 0;
+      for (; e < end && is_digit(*e); ++e)
+        e_value = std::min(e_value * 10 + (*e - '0'), 100000);
+      exponent += e_negative ? -e_value : e_value;
+      p = e;
+    }
+  }
+
+  if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+    double v = static_cast<double>(mantissa);
+    v = exponent < 0 ? v / kPow10[-exponent] : v * kPow10[exponent];
+    value = negative ? -v : v;
+    return true;
+  }
+  std::istringstream stream(std::string(start, p));
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  return !stream.fail();
+}
+}  // namespace SolXml
@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "DcTiming.h"
+#include "StartSweep.h"
+#include "ThreadPool.h"
+
+namespace {
+/// Track of a departure, invalid once the wind data ran out
+class Recorder : public TrackSink {
+public:
+  std::vector<TrackPoint> m_points;
+  bool m_valid = true;
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    m_points.push_back({t, lat, lon});
+  }
+  void SetPerformance(double performance, double stw) override {
+    if (stw < 0.0) m_valid = false;
+  }
+};
+
+/// Copy of the plan for a block of departures, shifted from one to the next
+struct Workspace {
+  DcModel::Plan m_plan;
+  Recorder m_track;
+};
+}  // namespace
+
+StartSweep::StartSweep(const WindProvider& wind, const PolarProvider& polar,
+                       const StartSweepSettings& settings, ThreadPool* pool)
+    : m_wind(wind), m_polar(polar), m_settings(settings), m_pool(pool) {}
+
+std::vector<std::string> StartSweep::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool StartSweep::MakeDepartures(std::time_t begin, std::time_t end,
+                                std::vector<Departure>& departures) {
+  departures.clear();
+  if (m_settings.m_interval <= 0 || end < begin) {
+    m_errors.emplace_back("No departures in the start window");
+    return false;
+  }
+
+  departures.reserve((end - begin) / m_settings.m_interval + 1);
+  for (std::time_t t = begin; t <= end; t += m_settings.m_interval)
+    departures.push_back({t, NAN});
+  return true;
+}
+
+bool StartSweep::SweepDcs(const DcModel::Plan& plan, std::time_t begin,
+                          std::time_t end, double target_lat,
+                          double target_lon,
+                          std::vector<Departure>& departures) {
+  if (plan.m_legs.empty()) {
+    m_errors.emplace_back("No DCs to sail from the departures");
+    return false;
+  }
+  if (!MakeDepartures(begin, end, departures)) return false;
+
+  // Contiguous blocks of departures, one per thread. The plan is copied
+  // once per block and shifted in place
+  const DcModel model(m_wind, m_polar);
+  const size_t blocks =
+      std::min(departures.size(), (m_pool ? m_pool->GetSize() : 0) + 1);
+  std::vector<Workspace> workspaces(blocks);
+  auto sail = [&](size_t block) {
+    Workspace& workspace = workspaces[block];
+    workspace.m_plan = plan;
+    workspace.m_track.m_points.reserve(plan.m_legs.size() + 1);
+    std::time_t start = plan.m_legs.front().m_timestamp;
+
+    for (size_t i = block * departures.size() / blocks;
+         i < (block + 1) * departures.size() / blocks; ++i) {
+      Departure& departure = departures[i];
+      for (auto& leg : workspace.m_plan.m_legs)
+        leg.m_timestamp += departure.m_time - start;
+      start = departure.m_time;
+
+      workspace.m_track.m_points.clear();
+      workspace.m_track.m_valid = true;
+      model.MakeTrack(workspace.m_plan, workspace.m_track);
+      size_t segment;
+      if (workspace.m_track.m_valid)
+        departure.m_arrival = DcTiming::GetEta(
+            workspace.m_track.m_points, target_lat, target_lon,
+            m_settings.m_arrival_radius, segment);
+    }
+  };
+  if (m_pool == nullptr)
+    sail(0);
+  else
+    m_pool->ParallelFor(blocks, sail);
+
+  return true;
+}
+
+bool StartSweep::SweepRoutes(
+    double start_lat, double start_lon,
+    const std::vector<std::pair<double, double>>& waypoints,
+    std::time_t begin, std::time_t end, std::vector<Departure>& departures) {
+  if (waypoints.empty()) {
+    m_errors.emplace_back("No waypoints to route the departures through");
+    return false;
+  }
+  if (!MakeDepartures(begin, end, departures)) return false;
+
+  // A route per departure, each on a single thread. Departures the wind data
+  // doesn't cover fail and keep their NAN
+  auto route = [&](size_t i) {
+    Departure& departure = departures[i];
+    Router router(m_wind, m_polar, m_settings.m_router);
+    std::vector<RoutePoint> points;
+    if (router.Route({departure.m_time, start_lat, start_lon}, waypoints,
+                     points) &&
+        !points.empty())
+      departure.m_arrival = points.back().m_time;
+  };
+  if (m_pool == nullptr) {
+    for (size_t i = 0; i < departures.size(); ++i) route(i);
+  } else {
+    m_pool->ParallelFor(departures.size(), route);
+  }
+
+  return true;
+}
+
+size_t StartSweep::GetBest(const std::vector<Departure>& departures) {
+  size_t best = departures.size();
+  for (size_t i = 0; i < departures.size(); ++i) {
+    if (std::isnan(departures[i].m_arrival)) continue;
+    if (best == departures.size() ||
+        departures[i].GetDuration() < departures[best].GetDuration())
+      best = i;
+  }
+  return best;
+}
@@ -0,0 +1,367 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "SolFile.h"
+#include "TraceStore.h"
+
+namespace {
+// Binary file: "SOLTRACE", version and number of boats as uint32, then per
+// boat its ID, last point (int64 time, int32 latitude and longitude) and its
+// differences (int64), number of blocks and bytes of data as uint32, the block
+// index and the data. Host byte order, like the polar cache
+static constexpr char kBinaryMagic[8] = {'S', 'O', 'L', 'T',
+                                         'R', 'A', 'C', 'E'};
+static constexpr uint32_t kBinaryVersion = 1;
+static constexpr size_t kBinaryHeaderSize =
+    sizeof(kBinaryMagic) + 2 * sizeof(uint32_t);
+static constexpr size_t kTraceHeaderSize =
+    5 * sizeof(int64_t) + 4 * sizeof(uint32_t);
+
+// Longitude units of kResolution per half and full turn
+static constexpr int64_t kHalfTurn = 18000000;
+static constexpr int64_t kFullTurn = 2 * kHalfTurn;
+
+/// Longitude units wrapped into [-kHalfTurn, kHalfTurn)
+int64_t wrap_lon(int64_t lon) {
+  lon = (lon + kHalfTurn) % kFullTurn;
+  if (lon < 0) lon += kFullTurn;
+  return lon - kHalfTurn;
+}
+
+int32_t quantize(double degrees) {
+  return static_cast<int32_t>(std::llround(degrees / TraceStore::kResolution));
+}
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// Wrapping sum, damaged data must not overflow
+int64_t add(int64_t a, int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) +
+                              static_cast<uint64_t>(b));
+}
+
+/// Little endian base 128, seven bits per byte
+void append_varint(std::string& data, uint64_t value) {
+  while (value >= 0x80) {
+    data.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  data.push_back(static_cast<char>(value));
+}
+
+bool read_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    uint8_t byte = *p++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) return true;
+  }
+  return false;
+}
+
+template <typename T>
+void append_raw(std::string& data, const T& value) {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read_raw(const char*& p, const char* end, T& value) {
+  if (static_cast<size_t>(end - p) < sizeof(value)) return false;
+  std::memcpy(&value, p, sizeof(value));
+  p += sizeof(value);
+  return true;
+}
+}  // namespace
+
+std::vector<std::string> TraceStore::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool TraceStore::Append(int64_t id, const TrackPoint& point) {
+  Trace& trace = m_traces[id];
+  if (trace.m_count > 0 && point.m_time <= trace.m_time) return false;
+
+  int32_t lat = quantize(point.m_lat);
+  int32_t lon = static_cast<int32_t>(wrap_lon(quantize(point.m_lon)));
+  // Only the last block can have room left
+  if (trace.m_count % kBlockPoints == 0) {
+    trace.m_blocks.push_back({point.m_time, lat, lon,
+                              static_cast<uint32_t>(trace.m_data.size()), 1});
+    trace.m_dt = trace.m_dlat = trace.m_dlon = 0;
+  } else {
+    int64_t dt = point.m_time - trace.m_time;
+    int64_t dlat = int64_t{lat} - trace.m_lat;
+    int64_t dlon = wrap_lon(int64_t{lon} - trace.m_lon);
+    append_varint(trace.m_data, zigzag(dt - trace.m_dt));
+    append_varint(trace.m_data, zigzag(dlat - trace.m_dlat));
+    append_varint(trace.m_data, zigzag(dlon - trace.m_dlon));
+    ++trace.m_blocks.back().m_count;
+    trace.m_dt = dt;
+    trace.m_dlat = dlat;
+    trace.m_dlon = dlon;
+  }
+  ++trace.m_count;
+  trace.m_time = point.m_time;
+  trace.m_lat = lat;
+  trace.m_lon = lon;
+  return true;
+}
+
+std::vector<int64_t> TraceStore::GetBoats() const {
+  std::vector<int64_t> ids;
+  ids.reserve(m_traces.size());
+  for (const auto& [id, trace] : m_traces) ids.push_back(id);
+  return ids;
+}
+
+size_t TraceStore::GetPointCount(int64_t id) const {
+  auto it = m_traces.find(id);
+  return it == m_traces.end() ? 0 : it->second.m_count;
+}
+
+bool TraceStore::GetTimeRange(int64_t id, std::time_t& first,
+                              std::time_t& last) const {
+  auto it = m_traces.find(id);
+  if (it == m_traces.end() || it->second.m_blocks.empty()) return false;
+  first = it->second.m_blocks.front().m_time;
+  last = it->second.m_time;
+  return true;
+}
+
+template <typename Visitor>
+void TraceStore::Decode(const Trace& trace, size_t b, Visitor&& visit) {
+  const Block& block = trace.m_blocks[b];
+  int64_t time = block.m_time, lat = block.m_lat, lon = block.m_lon;
+  if (!visit(time, lat, lon)) return;
+  int64_t dt = 0, dlat = 0, dlon = 0;
+
+  const auto* data = reinterpret_cast<const uint8_t*>(trace.m_data.data());
+  const uint8_t* p = data + block.m_offset;
+  const uint8_t* end = data + (b + 1 < trace.m_blocks.size()
+                                   ? trace.m_blocks[b + 1].m_offset
+                                   : trace.m_data.size());
+  for (uint32_t i = 1; i < block.m_count; ++i) {
+    uint64_t ddt, ddlat, ddlon;
+    if (!read_varint(p, end, ddt) || !read_varint(p, end, ddlat) ||
+        !read_varint(p, end, ddlon))
+      return;
+    dt = add(dt, unzigzag(ddt));
+    dlat = add(dlat, unzigzag(ddlat));
+    dlon = add(dlon, unzigzag(ddlon));
+    time = add(time, dt);
+    lat = add(lat, dlat);
+    lon = wrap_lon(add(lon, dlon));
+    if (!visit(time, lat, lon)) return;
+  }
+}
+
+size_t TraceStore::FindBlock(const Trace& trace, std::time_t t) {
+  auto it = std::upper_bound(
+      trace.m_blocks.begin(), trace.m_blocks.end(), t,
+      [](std::time_t time, const Block& block) { return time < block.m_time; });
+  if (it == trace.m_blocks.begin()) return trace.m_blocks.size();
+  return it - trace.m_blocks.begin() - 1;
+}
+
+void TraceStore::GetTrace(int64_t id, std::time_t begin, std::time_t end,
+                          std::vector<TrackPoint>& points) const {
+  auto it = m_traces.find(id);
+  if (it == m_traces.end()) return;
+  const Trace& trace = it->second;
+
+  size_t b = FindBlock(trace, begin);
+  if (b == trace.m_blocks.size()) b = 0;
+  for (; b < trace.m_blocks.size() && trace.m_blocks[b].m_time <= end; ++b) {
+    Decode(trace, b, [&](int64_t time, int64_t lat, int64_t lon) {
+      if (time > end) return false;
+      if (time >= begin)
+        points.push_back({static_cast<std::time_t>(time), lat * kResolution,
+                          lon * kResolution});
+      return true;
+    });
+  }
+}
+
+bool TraceStore::GetPosition(int64_t id, std::time_t t, double& lat,
+                             double& lon) const {
+  auto it = m_traces.find(id);
+  if (it == m_traces.end()) return false;
+  const Trace& trace = it->second;
+  size_t b = FindBlock(trace, t);
+  if (b == trace.m_blocks.size() || t > trace.m_time) return false;
+
+  // The last point at or before t and the first after it
+  int64_t time0 = 0, lat0 = 0, lon0 = 0;
+  int64_t time1 = 0, lat1 = 0, lon1 = 0;
+  bool after = false;
+  Decode(trace, b, [&](int64_t time, int64_t plat, int64_t plon) {
+    if (time <= t) {
+      time0 = time;
+      lat0 = plat;
+      lon0 = plon;
+      return true;
+    }
+    time1 = time;
+    lat1 = plat;
+    lon1 = plon;
+    after = true;
+    return false;
+  });
+
+  if (time0 == t) {
+    lat = lat0 * kResolution;
+    lon = lon0 * kResolution;
+    return true;
+  }
+  if (!after) {
+    // Between the blocks, or the data of the block is damaged
+    if (b + 1 == trace.m_blocks.size()) return false;
+    const Block& next = trace.m_blocks[b + 1];
+    time1 = next.m_time;
+    lat1 = next.m_lat;
+    lon1 = next.m_lon;
+  }
+
+  double f = static_cast<double>(t - time0) / (time1 - time0);
+  lat = (lat0 + f * (lat1 - lat0)) * kResolution;
+  lon = (lon0 + f * wrap_lon(lon1 - lon0)) * kResolution;
+  if (lon >= 180.0)
+    lon -= 360.0;
+  else if (lon < -180.0)
+    lon += 360.0;
+  return true;
+}
+
+size_t TraceStore::GetEncodedSize() const {
+  size_t size = 0;
+  for (const auto& [id, trace] : m_traces)
+    size += trace.m_blocks.size() * sizeof(Block) + trace.m_data.size();
+  return size;
+}
+
+bool TraceStore::Save(const std::string& path) {
+  static_assert(sizeof(Block) == 24, "Block index is written as it is");
+
+  std::string data;
+  data.reserve(kBinaryHeaderSize + m_traces.size() * kTraceHeaderSize +
+               GetEncodedSize());
+  data.append(kBinaryMagic, sizeof(kBinaryMagic));
+  append_raw(data, kBinaryVersion);
+  append_raw(data, static_cast<uint32_t>(m_traces.size()));
+  for (const auto& [id, trace] : m_traces) {
+    append_raw(data, id);
+    append_raw(data, trace.m_time);
+    append_raw(data, trace.m_lat);
+    append_raw(data, trace.m_lon);
+    append_raw(data, trace.m_dt);
+    append_raw(data, trace.m_dlat);
+    append_raw(data, trace.m_dlon);
+    append_raw(data, static_cast<uint32_t>(trace.m_blocks.size()));
+    append_raw(data, static_cast<uint32_t>(trace.m_data.size()));
+    data.append(reinterpret_cast<const char*>(trace.m_blocks.data()),
+                trace.m_blocks.size() * sizeof(Block));
+    data.append(trace.m_data);
+  }
+
+  std::string error;
+  if (!SolFile::WriteAtomic(path, data, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+bool TraceStore::Load(const std::string& path) {
+  std::string data;
+  if (!SolFile::Read(path, data)) {
+    m_errors.emplace_back("Could not read trace store " + path);
+    return false;
+  }
+  if (data.size() < kBinaryHeaderSize ||
+      std::memcmp(data.data(), kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+    m_errors.emplace_back("Not a trace store: " + path);
+    return false;
+  }
+
+  auto fail = [&]() {
+    m_errors.emplace_back("Outdated or damaged trace store: " + path);
+    return false;
+  };
+
+  const char* p = data.data() + sizeof(kBinaryMagic);
+  const char* end = data.data() + data.size();
+  uint32_t version, boats;
+  read_raw(p, end, version);
+  read_raw(p, end, boats);
+  if (version != kBinaryVersion) return fail();
+
+  // The index is checked, the data is only decoded when it is needed
+  std::map<int64_t, Trace> traces;
+  for (uint32_t i = 0; i < boats; ++i) {
+    int64_t id;
+    Trace trace;
+    uint32_t blocks, size;
+    if (!read_raw(p, end, id) || !read_raw(p, end, trace.m_time) ||
+        !read_raw(p, end, trace.m_lat) || !read_raw(p, end, trace.m_lon) ||
+        !read_raw(p, end, trace.m_dt) || !read_raw(p, end, trace.m_dlat) ||
+        !read_raw(p, end, trace.m_dlon) || !read_raw(p, end, blocks) ||
+        !read_raw(p, end, size) || blocks == 0 ||
+        static_cast<size_t>(end - p) / sizeof(Block) < blocks)
+      return fail();
+    trace.m_blocks.resize(blocks);
+    std::memcpy(trace.m_blocks.data(), p, blocks * sizeof(Block));
+    p += blocks * sizeof(Block);
+    if (static_cast<size_t>(end - p) < size) return fail();
+    trace.m_data.assign(p, size);
+    p += size;
+
+    for (size_t b = 0; b < blocks; ++b) {
+      const Block& block = trace.m_blocks[b];
+      if (block.m_count == 0 || block.m_count > kBlockPoints ||
+          (b + 1 < blocks && block.m_count != kBlockPoints) ||
+          block.m_offset > size ||
+          (b == 0 ? block.m_offset != 0
+                  : block.m_offset < trace.m_blocks[b - 1].m_offset ||
+                        block.m_time <= trace.m_blocks[b - 1].m_time))
+        return fail();
+    }
+    if (trace.m_time < trace.m_blocks.back().m_time) return fail();
+    trace.m_count = (blocks - 1) * kBlockPoints + trace.m_blocks.back().m_count;
+    if (!traces.emplace(id, std::move(trace)).second) return fail();
+  }
+  if (p != end) return fail();
+
+  m_traces.swap(traces);
+  return true;
+}
@@ -0,0 +1,338 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <pugixml.hpp>
+
+#include "SolFile.h"
+#include "SolTime.h"
+#include "SolXml.h"
+#include "WindGrid.h"
+
+namespace {
+// Binary cache: "SOLWIND" and a null, version and number of latitudes,
+// longitudes and frames as uint32, lat_start, lon_start, lat_increment and
+// lon_increment as doubles, the frame times as int64, then all U and all V
+// components as floats. Host byte order, the cache is not meant to be copied
+// between machines. Every section is aligned to its type, so the mapped file
+// is used in place
+static constexpr char kBinaryMagic[8] = {'S', 'O', 'L', 'W',
+                                         'I', 'N', 'D', '\0'};
+static constexpr uint32_t kBinaryVersion = 1;
+static constexpr size_t kBinaryHeaderSize =
+    sizeof(kBinaryMagic) + 4 * sizeof(uint32_t) + 4 * sizeof(double);
+
+/// Wind components of a parsed grid
+struct Components {
+  std::vector<float> m_u;
+  std::vector<float> m_v;
+};
+
+/// Number of the child element name of node in the C locale, 0 if there is
+/// none
+double child_number(pugi::xml_node node, const char* name) {
+  const char* text = node.child_value(name);
+  const char* end = text + std::strlen(text);
+  while (text < end && std::strchr(" \t\r\n", *text) != nullptr) ++text;
+  double value;
+  return SolXml::ParseNumber(text, end, value) ? value : 0.0;
+}
+
+/// Append the numbers of a U or V element, separated by whitespace, ',' or
+/// ';', in the C locale. Returns false on any other character
+bool append_floats(const char* text, std::vector<float>& values) {
+  const char* end = text + std::strlen(text);
+  while (text < end) {
+    if (std::strchr(" \t\r\n,;", *text) != nullptr) {
+      ++text;
+      continue;
+    }
+    double value;
+    if (!SolXml::ParseNumber(text, end, value)) return false;
+    values.push_back(static_cast<float>(value));
+  }
+  return true;
+}
+}  // namespace
+
+std::vector<std::string> WindGrid::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+bool WindGrid::CheckSize() {
+  if (m_times.size() * m_lat_n_points * m_lon_n_points >
+      static_cast<size_t>(INT32_MAX)) {
+    m_errors.emplace_back("Weather grid too large");
+    Clear();
+    return false;
+  }
+
+  return true;
+}
+
+void WindGrid::Clear() {
+  m_times.clear();
+  m_u = nullptr;
+  m_v = nullptr;
+  m_storage.reset();
+}
+
+bool WindGrid::Parse(const std::string& xml) {
+  Clear();
+  auto components = std::make_shared<Components>();
+  auto& u = components->m_u;
+  auto& v = components->m_v;
+
+  pugi::xml_document weather_doc;
+  auto status = weather_doc.load_buffer(xml.data(), xml.size());
+  if (!status) {
+    m_errors.emplace_back(std::string("Could not parse weather file: ") +
+                          status.description());
+    return false;
+  }
+
+  // The grid geometry is given by the children of the dataset element
+  pugi::xml_node node_dataset =
+      weather_doc.find_node([](pugi::xml_node node) {
+        return node.child("lat_n_points") != nullptr;
+      });
+  if (node_dataset == nullptr) {
+    m_errors.emplace_back("Format error in weather file, no grid found");
+    return false;
+  }
+  m_lat_n_points = node_dataset.child("lat_n_points").text().as_uint();
+  m_lon_n_points = node_dataset.child("lon_n_points").text().as_uint();
+  m_lat_start = child_number(node_dataset, "lat_start");
+  m_lon_start = child_number(node_dataset, "lon_start");
+  m_lat_increment = child_number(node_dataset, "lat_increment");
+  m_lon_increment = child_number(node_dataset, "lon_increment");
+  if (m_lat_n_points == 0 || m_lon_n_points == 0 || m_lat_increment == 0.0 ||
+      m_lon_increment <= 0.0) {
+    m_errors.emplace_back("Format error in weather file, invalid grid");
+    return false;
+  }
+  m_wraps = m_lon_n_points * m_lon_increment >= 360.0 - 1E-6;
+
+  const size_t frame_size = m_lat_n_points * m_lon_n_points;
+  pugi::xml_node node_first_frame =
+      node_dataset.find_node([](pugi::xml_node node) {
+        return strcmp(node.name(), "frame") == 0;
+      });
+  for (pugi::xml_node node_frame = node_first_frame; node_frame != nullptr;
+       node_frame = node_frame.next_sibling("frame")) {
+    std::time_t t;
+    if (!SolTime::ParseUtc(node_frame.attribute("target_time").value(), t)) {
+      m_errors.emplace_back(
+          std::string("Format error in weather file, invalid frame time ") +
+          node_frame.attribute("target_time").value());
+      return false;
+    }
+    if (!m_times.empty() && t <= m_times.back()) {
+      m_errors.emplace_back("Format error in weather file, frames not sorted");
+      return false;
+    }
+
+    if (!append_floats(node_frame.child_value("U"), u) ||
+        !append_floats(node_frame.child_value("V"), v) ||
+        u.size() != (m_times.size() + 1) * frame_size ||
+        v.size() != u.size()) {
+      m_errors.emplace_back("Format error in weather file, frame " +
+                            SolTime::FormatUtc(t) + " does not match grid");
+      m_times.clear();
+      return false;
+    }
+    m_times.push_back(t);
+  }
+
+  if (m_times.empty()) {
+    m_errors.emplace_back("Format error in weather file, no frames found");
+    return false;
+  }
+
+  m_u = u.data();
+  m_v = v.data();
+  m_storage = std::move(components);
+  return CheckSize();
+}
+
+bool WindGrid::SaveBinary(const std::string& path) {
+  if (IsEmpty()) {
+    m_errors.emplace_back("Cannot cache empty wind grid");
+    return false;
+  }
+
+  const uint32_t counts[4] = {kBinaryVersion,
+                              static_cast<uint32_t>(m_lat_n_points),
+                              static_cast<uint32_t>(m_lon_n_points),
+                              static_cast<uint32_t>(m_times.size())};
+  const double geometry[4] = {m_lat_start, m_lon_start, m_lat_increment,
+                              m_lon_increment};
+  const size_t values = m_times.size() * m_lat_n_points * m_lon_n_points;
+  std::string data;
+  data.reserve(kBinaryHeaderSize + sizeof(int64_t) * m_times.size() +
+               2 * sizeof(float) * values);
+  data.append(kBinaryMagic, sizeof(kBinaryMagic));
+  data.append(reinterpret_cast<const char*>(counts), sizeof(counts));
+  data.append(reinterpret_cast<const char*>(geometry), sizeof(geometry));
+  for (std::time_t t : m_times) {
+    int64_t time = t;
+    data.append(reinterpret_cast<const char*>(&time), sizeof(time));
+  }
+  data.append(reinterpret_cast<const char*>(m_u), sizeof(float) * values);
+  data.append(reinterpret_cast<const char*>(m_v), sizeof(float) * values);
+
+  std::string error;
+  if (!SolFile::WriteAtomic(path, data, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+bool WindGrid::LoadBinary(const std::string& path) {
+  Clear();
+  auto file = std::make_shared<SolFile::MappedFile>();
+  if (!file->Open(path)) {
+    m_errors.emplace_back("Could not map wind cache " + path);
+    return false;
+  }
+
+  const char* data = file->GetData();
+  uint32_t counts[4];
+  if (file->GetSize() < kBinaryHeaderSize ||
+      std::memcmp(data, kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+    m_errors.emplace_back("Not a wind cache: " + path);
+    return false;
+  }
+  std::memcpy(counts, data + sizeof(kBinaryMagic), sizeof(counts));
+  const uint64_t frames = counts[3];
+  const uint64_t values = frames * counts[1] * counts[2];
+  if (counts[0] != kBinaryVersion || values == 0 ||
+      file->GetSize() != kBinaryHeaderSize + sizeof(int64_t) * frames +
+                             2 * sizeof(float) * values) {
+    m_errors.emplace_back("Outdated or damaged wind cache: " + path);
+    return false;
+  }
+
+  double geometry[4];
+  std::memcpy(geometry, data + sizeof(kBinaryMagic) + sizeof(counts),
+              sizeof(geometry));
+  m_lat_n_points = counts[1];
+  m_lon_n_points = counts[2];
+  m_lat_start = geometry[0];
+  m_lon_start = geometry[1];
+  m_lat_increment = geometry[2];
+  m_lon_increment = geometry[3];
+  m_wraps = m_lon_n_points * m_lon_increment >= 360.0 - 1E-6;
+
+  const char* p = data + kBinaryHeaderSize;
+  m_times.resize(frames);
+  for (auto& t : m_times) {
+    int64_t time;
+    std::memcpy(&time, p, sizeof(time));
+    t = static_cast<std::time_t>(time);
+    p += sizeof(time);
+  }
+  m_u = reinterpret_cast<const float*>(p);
+  m_v = m_u + values;
+  m_storage = std::move(file);
+  return CheckSize();
+}
+
+std::pair<double, double> WindGrid::GetWindData(std::time_t t, double lat,
+                                                double lon) const {
+  std::pair<double, double> wind;
+  GetWindDataBatch(1, &t, &lat, &lon, &wind.first, &wind.second);
+  return wind;
+}
+
+void WindGrid::GetWindDataBatch(size_t n, const std::time_t* t,
+                                const double* lat, const double* lon,
+                                double* tws, double* twd) const {
+  if (IsEmpty()) {
+    std::fill(tws, tws + n, -1.0);
+    std::fill(twd, twd + n, -1.0);
+    return;
+  }
+
+  // Points are located in double precision, a block at a time, and
+  // interpolated by the kernel
+  static constexpr size_t kBlock = 256;
+  float f_lat[kBlock], f_lon[kBlock], w_time[kBlock];
+  int32_t frame0[kBlock], frame1[kBlock];
+  const WindKernel::Grid grid{m_u, m_v, static_cast<int32_t>(m_lat_n_points),
+                              static_cast<int32_t>(m_lon_n_points), m_wraps};
+  const WindKernel::Points points{f_lat, f_lon, frame0, frame1, w_time};
+  const size_t frame_size = m_lat_n_points * m_lon_n_points;
+  const double lat_last = m_lat_n_points - 1.0;
+  const double lon_last = m_lon_n_points - 1.0;
+  const double lat_scale = 1.0 / m_lat_increment;
+  const double lon_scale = 1.0 / m_lon_increment;
+
+  // Consecutive points are mostly in the same frame
+  size_t i_time = 0;
+  for (size_t begin = 0; begin < n; begin += kBlock) {
+    size_t count = std::min(kBlock, n - begin);
+    for (size_t j = 0; j < count; ++j) {
+      f_lat[j] = f_lon[j] = 0.0f;
+      frame0[j] = frame1[j] = 0;
+      w_time[j] = -1.0f;
+
+      std::time_t time = t[begin + j];
+      if (time < m_times.front() || time > m_times.back()) continue;
+      double y = (lat[begin + j] - m_lat_start) * lat_scale;
+      double dlon = lon[begin + j] - m_lon_start;
+      if (dlon < 0.0 || dlon >= 360.0) dlon -= 360.0 * std::floor(dlon / 360.0);
+      double x = dlon * lon_scale;
+      if (m_wraps && x >= m_lon_n_points) x -= m_lon_n_points;
+      // Also false for NaN
+      if (!(y >= 0.0 && y <= lat_last && x >= 0.0 &&
+            (m_wraps || x <= lon_last)))
+        continue;
+
+      if (time < m_times[i_time] ||
+          (i_time + 1 < m_times.size() && time >= m_times[i_time + 1]))
+        i_time = std::upper_bound(m_times.begin(), m_times.end(), time) -
+                 m_times.begin() - 1;
+      size_t i_time1 = std::min(i_time + 1, m_times.size() - 1);
+      f_lat[j] = static_cast<float>(y);
+      f_lon[j] = static_cast<float>(x);
+      frame0[j] = static_cast<int32_t>(i_time * frame_size);
+      frame1[j] = static_cast<int32_t>(i_time1 * frame_size);
+      w_time[j] = i_time1 == i_time
+                      ? 0.0f
+                      : static_cast<float>(
+                            std::difftime(time, m_times[i_time]) /
+                            std::difftime(m_times[i_time1], m_times[i_time]));
+    }
+
+    WindKernel::Interpolate(grid, points, count, tws + begin, twd + begin,
+                            m_level);
+  }
+}
@@ -0,0 +1,396 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "WindKernel.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SOL_KERNEL_X86
+// Compiled for the level, called only if the CPU supports it
+#define SOL_TARGET(level) __attribute__((target(level)))
+#elif defined(_M_X64)
+#define SOL_KERNEL_X86
+#define SOL_TARGET(level)
+#include <intrin.h>
+#endif
+
+#ifdef SOL_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+static constexpr float kMsToKnots = 3600.0f / 1852.0f;
+static constexpr float kRadToDeg = static_cast<float>(180.0 / M_PI);
+static constexpr float kPi = static_cast<float>(M_PI);
+static constexpr float kPi2 = static_cast<float>(M_PI / 2.0);
+static constexpr float kPi4 = static_cast<float>(M_PI / 4.0);
+static constexpr float kTanPi8 = 0.41421356f;
+// atan(z) = z + z^3 * P(z^2) for |z| <= tan(pi/8) (Cephes atanf)
+static constexpr float kAtan3 = 8.05374449538E-2f;
+static constexpr float kAtan2 = -1.38776856032E-1f;
+static constexpr float kAtan1 = 1.99777106478E-1f;
+static constexpr float kAtan0 = -3.33329491539E-1f;
+
+float lerp(float a, float b, float w) { return a + w * (b - a); }
+
+/// Meteorological direction (degrees) of the wind with components u, v.
+/// atan2(-u, -v), written the way the vector levels compute it
+float direction(float u, float v) {
+  float y = -u, x = -v;
+  float ay = std::fabs(y), ax = std::fabs(x);
+  float a = std::min(ax, ay) / std::max(std::max(ax, ay), FLT_MIN);
+  bool big = a > kTanPi8;
+  float z = big ? (a - 1.0f) / (a + 1.0f) : a;
+  float z2 = z * z;
+  float p = ((kAtan3 * z2 + kAtan2) * z2 + kAtan1) * z2 + kAtan0;
+  float r = (big ? kPi4 : 0.0f) + (p * z2 * z + z);
+  if (ay > ax) r = kPi2 - r;
+  if (x < 0.0f) r = kPi - r;
+  if (y < 0.0f) r = -r;
+  float deg = r * kRadToDeg;
+  return deg < 0.0f ? deg + 360.0f : deg;
+}
+
+void interpolate_point(const WindKernel::Grid& grid,
+                       const WindKernel::Points& points, size_t i,
+                       double& tws, double& twd) {
+  float w_time = points.m_w_time[i];
+  if (w_time < 0.0f) {
+    tws = twd = -1.0;
+    return;
+  }
+
+  int32_t lat0 = std::min(static_cast<int32_t>(std::floor(points.m_lat[i])),
+                          std::max(grid.m_lat_n - 2, 0));
+  float w_lat = points.m_lat[i] - static_cast<float>(lat0);
+  int32_t lat1 = std::min(lat0 + 1, grid.m_lat_n - 1);
+  int32_t lon0 =
+      std::min(static_cast<int32_t>(std::floor(points.m_lon[i])),
+               grid.m_wraps ? grid.m_lon_n - 1 : std::max(grid.m_lon_n - 2, 0));
+  float w_lon = points.m_lon[i] - static_cast<float>(lon0);
+  int32_t lon1 = lon0 + 1;
+  if (lon1 >= grid.m_lon_n) lon1 = grid.m_wraps ? 0 : grid.m_lon_n - 1;
+
+  const int32_t row0 = lat0 * grid.m_lon_n, row1 = lat1 * grid.m_lon_n;
+  const int32_t frame0 = points.m_frame0[i], frame1 = points.m_frame1[i];
+  auto component = [&](const float* c) {
+    float before = lerp(lerp(c[frame0 + row0 + lon0], c[frame0 + row0 + lon1],
+                             w_lon),
+                        lerp(c[frame0 + row1 + lon0], c[frame0 + row1 + lon1],
+                             w_lon),
+                        w_lat);
+    float after = lerp(lerp(c[frame1 + row0 + lon0], c[frame1 + row0 + lon1],
+                            w_lon),
+                       lerp(c[frame1 + row1 + lon0], c[frame1 + row1 + lon1],
+                            w_lon),
+                       w_lat);
+    return lerp(before, after, w_time);
+  };
+  float u = component(grid.m_u);
+  float v = component(grid.m_v);
+
+  tws = std::sqrt(u * u + v * v) * kMsToKnots;
+  twd = direction(u, v);
+}
+
+void interpolate_scalar(const WindKernel::Grid& grid,
+                        const WindKernel::Points& points, size_t begin,
+                        size_t n, double* tws, double* twd) {
+  for (size_t i = begin; i < n; ++i)
+    interpolate_point(grid, points, i, tws[i], twd[i]);
+}
+
+#ifdef SOL_KERNEL_X86
+// The vector levels follow interpolate_point() lane by lane
+
+SOL_TARGET("sse4.1")
+__m128 lerp4(__m128 a, __m128 b, __m128 w) {
+  return _mm_add_ps(a, _mm_mul_ps(w, _mm_sub_ps(b, a)));
+}
+
+SOL_TARGET("sse4.1")
+__m128 gather4(const float* c, __m128i index) {
+  alignas(16) int32_t i[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(i), index);
+  return _mm_set_ps(c[i[3]], c[i[2]], c[i[1]], c[i[0]]);
+}
+
+SOL_TARGET("sse4.1")
+__m128 direction4(__m128 u, __m128 v) {
+  const __m128 sign = _mm_set1_ps(-0.0f), zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128 y = _mm_xor_ps(u, sign), x = _mm_xor_ps(v, sign);
+  __m128 ay = _mm_andnot_ps(sign, y), ax = _mm_andnot_ps(sign, x);
+  __m128 a = _mm_div_ps(_mm_min_ps(ax, ay),
+                        _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(FLT_MIN)));
+  __m128 big = _mm_cmpgt_ps(a, _mm_set1_ps(kTanPi8));
+  __m128 z = _mm_blendv_ps(
+      a, _mm_div_ps(_mm_sub_ps(a, one), _mm_add_ps(a, one)), big);
+  __m128 z2 = _mm_mul_ps(z, z);
+  __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kAtan3), z2),
+                        _mm_set1_ps(kAtan2));
+  p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtan1));
+  p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtan0));
+  __m128 r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z2), z), z);
+  r = _mm_add_ps(_mm_and_ps(big, _mm_set1_ps(kPi4)), r);
+  r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(kPi2), r), _mm_cmpgt_ps(ay, ax));
+  r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(kPi), r), _mm_cmplt_ps(x, zero));
+  r = _mm_xor_ps(r, _mm_and_ps(_mm_cmplt_ps(y, zero), sign));
+  __m128 deg = _mm_mul_ps(r, _mm_set1_ps(kRadToDeg));
+  return _mm_blendv_ps(deg, _mm_add_ps(deg, _mm_set1_ps(360.0f)),
+                       _mm_cmplt_ps(deg, zero));
+}
+
+SOL_TARGET("sse4.1")
+void interpolate_sse41(const WindKernel::Grid& grid,
+                       const WindKernel::Points& points, size_t n, double* tws,
+                       double* twd) {
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i lat_max0 = _mm_set1_epi32(std::max(grid.m_lat_n - 2, 0));
+  const __m128i lat_last = _mm_set1_epi32(grid.m_lat_n - 1);
+  const __m128i lon_max0 = _mm_set1_epi32(
+      grid.m_wraps ? grid.m_lon_n - 1 : std::max(grid.m_lon_n - 2, 0));
+  const __m128i lon_last = _mm_set1_epi32(grid.m_lon_n - 1);
+  const __m128i lon_n = _mm_set1_epi32(grid.m_lon_n);
+  const __m128i lon_back = _mm_set1_epi32(grid.m_wraps ? grid.m_lon_n : 1);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 w_time = _mm_loadu_ps(points.m_w_time + i);
+    __m128 outside = _mm_cmplt_ps(w_time, _mm_setzero_ps());
+
+    __m128 f_lat = _mm_loadu_ps(points.m_lat + i);
+    __m128i lat0 =
+        _mm_min_epi32(_mm_cvttps_epi32(_mm_floor_ps(f_lat)), lat_max0);
+    __m128 w_lat = _mm_sub_ps(f_lat, _mm_cvtepi32_ps(lat0));
+    __m128i lat1 = _mm_min_epi32(_mm_add_epi32(lat0, one), lat_last);
+    __m128 f_lon = _mm_loadu_ps(points.m_lon + i);
+    __m128i lon0 =
+        _mm_min_epi32(_mm_cvttps_epi32(_mm_floor_ps(f_lon)), lon_max0);
+    __m128 w_lon = _mm_sub_ps(f_lon, _mm_cvtepi32_ps(lon0));
+    __m128i lon1 = _mm_add_epi32(lon0, one);
+    lon1 = _mm_sub_epi32(lon1,
+                         _mm_and_si128(_mm_cmpgt_epi32(lon1, lon_last),
+                                       lon_back));
+
+    __m128i row0 = _mm_mullo_epi32(lat0, lon_n);
+    __m128i row1 = _mm_mullo_epi32(lat1, lon_n);
+    __m128i frame0 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(points.m_frame0 + i));
+    __m128i frame1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(points.m_frame1 + i));
+    __m128i corners[8];
+    for (int c = 0; c < 8; ++c)
+      corners[c] = _mm_add_epi32(
+          _mm_add_epi32(c & 4 ? frame1 : frame0, c & 2 ? row1 : row0),
+          c & 1 ? lon1 : lon0);
+
+    __m128 components[2];
+    for (int k = 0; k < 2; ++k) {
+      const float* c = k == 0 ? grid.m_u : grid.m_v;
+      __m128 before = lerp4(
+          lerp4(gather4(c, corners[0]), gather4(c, corners[1]), w_lon),
+          lerp4(gather4(c, corners[2]), gather4(c, corners[3]), w_lon),
+          w_lat);
+      __m128 after = lerp4(
+          lerp4(gather4(c, corners[4]), gather4(c, corners[5]), w_lon),
+          lerp4(gather4(c, corners[6]), gather4(c, corners[7]), w_lon),
+          w_lat);
+      components[k] = lerp4(before, after, w_time);
+    }
+    __m128 u = components[0], v = components[1];
+
+    const __m128 none = _mm_set1_ps(-1.0f);
+    __m128 speed = _mm_mul_ps(
+        _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(u, u), _mm_mul_ps(v, v))),
+        _mm_set1_ps(kMsToKnots));
+    speed = _mm_blendv_ps(speed, none, outside);
+    __m128 dir = _mm_blendv_ps(direction4(u, v), none, outside);
+    _mm_storeu_pd(tws + i, _mm_cvtps_pd(speed));
+    _mm_storeu_pd(tws + i + 2, _mm_cvtps_pd(_mm_movehl_ps(speed, speed)));
+    _mm_storeu_pd(twd + i, _mm_cvtps_pd(dir));
+    _mm_storeu_pd(twd + i + 2, _mm_cvtps_pd(_mm_movehl_ps(dir, dir)));
+  }
+
+  interpolate_scalar(grid, points, i, n, tws, twd);
+}
+
+SOL_TARGET("avx2")
+__m256 lerp8(__m256 a, __m256 b, __m256 w) {
+  return _mm256_add_ps(a, _mm256_mul_ps(w, _mm256_sub_ps(b, a)));
+}
+
+SOL_TARGET("avx2")
+__m256 direction8(__m256 u, __m256 v) {
+  const __m256 sign = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  __m256 y = _mm256_xor_ps(u, sign), x = _mm256_xor_ps(v, sign);
+  __m256 ay = _mm256_andnot_ps(sign, y), ax = _mm256_andnot_ps(sign, x);
+  __m256 a = _mm256_div_ps(
+      _mm256_min_ps(ax, ay),
+      _mm256_max_ps(_mm256_max_ps(ax, ay), _mm256_set1_ps(FLT_MIN)));
+  __m256 big = _mm256_cmp_ps(a, _mm256_set1_ps(kTanPi8), _CMP_GT_OQ);
+  __m256 z = _mm256_blendv_ps(
+      a, _mm256_div_ps(_mm256_sub_ps(a, one), _mm256_add_ps(a, one)), big);
+  __m256 z2 = _mm256_mul_ps(z, z);
+  __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kAtan3), z2),
+                           _mm256_set1_ps(kAtan2));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtan1));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtan0));
+  __m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, z2), z), z);
+  r = _mm256_add_ps(_mm256_and_ps(big, _mm256_set1_ps(kPi4)), r);
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(kPi2), r),
+                       _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(kPi), r),
+                       _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+  r = _mm256_xor_ps(r,
+                    _mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), sign));
+  __m256 deg = _mm256_mul_ps(r, _mm256_set1_ps(kRadToDeg));
+  return _mm256_blendv_ps(deg, _mm256_add_ps(deg, _mm256_set1_ps(360.0f)),
+                          _mm256_cmp_ps(deg, zero, _CMP_LT_OQ));
+}
+
+SOL_TARGET("avx2")
+void store8(double* out, __m256 values) {
+  _mm256_storeu_pd(out, _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+  _mm256_storeu_pd(out + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+}
+
+SOL_TARGET("avx2")
+void interpolate_avx2(const WindKernel::Grid& grid,
+                      const WindKernel::Points& points, size_t n, double* tws,
+                      double* twd) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i lat_max0 = _mm256_set1_epi32(std::max(grid.m_lat_n - 2, 0));
+  const __m256i lat_last = _mm256_set1_epi32(grid.m_lat_n - 1);
+  const __m256i lon_max0 = _mm256_set1_epi32(
+      grid.m_wraps ? grid.m_lon_n - 1 : std::max(grid.m_lon_n - 2, 0));
+  const __m256i lon_last = _mm256_set1_epi32(grid.m_lon_n - 1);
+  const __m256i lon_n = _mm256_set1_epi32(grid.m_lon_n);
+  const __m256i lon_back = _mm256_set1_epi32(grid.m_wraps ? grid.m_lon_n : 1);
+
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 w_time = _mm256_loadu_ps(points.m_w_time + i);
+    __m256 outside = _mm256_cmp_ps(w_time, _mm256_setzero_ps(), _CMP_LT_OQ);
+
+    __m256 f_lat = _mm256_loadu_ps(points.m_lat + i);
+    __m256i lat0 =
+        _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_floor_ps(f_lat)), lat_max0);
+    __m256 w_lat = _mm256_sub_ps(f_lat, _mm256_cvtepi32_ps(lat0));
+    __m256i lat1 = _mm256_min_epi32(_mm256_add_epi32(lat0, one), lat_last);
+    __m256 f_lon = _mm256_loadu_ps(points.m_lon + i);
+    __m256i lon0 =
+        _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_floor_ps(f_lon)), lon_max0);
+    __m256 w_lon = _mm256_sub_ps(f_lon, _mm256_cvtepi32_ps(lon0));
+    __m256i lon1 = _mm256_add_epi32(lon0, one);
+    lon1 = _mm256_sub_epi32(
+        lon1, _mm256_and_si256(_mm256_cmpgt_epi32(lon1, lon_last), lon_back));
+
+    __m256i row0 = _mm256_mullo_epi32(lat0, lon_n);
+    __m256i row1 = _mm256_mullo_epi32(lat1, lon_n);
+    __m256i frame0 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(points.m_frame0 + i));
+    __m256i frame1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(points.m_frame1 + i));
+    __m256i corners[8];
+    for (int c = 0; c < 8; ++c)
+      corners[c] = _mm256_add_epi32(
+          _mm256_add_epi32(c & 4 ? frame1 : frame0, c & 2 ? row1 : row0),
+          c & 1 ? lon1 : lon0);
+
+    __m256 components[2];
+    for (int k = 0; k < 2; ++k) {
+      const float* c = k == 0 ? grid.m_u : grid.m_v;
+      __m256 values[8];
+      for (int j = 0; j < 8; ++j)
+        values[j] = _mm256_i32gather_ps(c, corners[j], sizeof(float));
+      __m256 before = lerp8(lerp8(values[0], values[1], w_lon),
+                            lerp8(values[2], values[3], w_lon), w_lat);
+      __m256 after = lerp8(lerp8(values[4], values[5], w_lon),
+                           lerp8(values[6], values[7], w_lon), w_lat);
+      components[k] = lerp8(before, after, w_time);
+    }
+    __m256 u = components[0], v = components[1];
+
+    const __m256 none = _mm256_set1_ps(-1.0f);
+    __m256 speed = _mm256_mul_ps(
+        _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(u, u), _mm256_mul_ps(v, v))),
+        _mm256_set1_ps(kMsToKnots));
+    store8(tws + i, _mm256_blendv_ps(speed, none, outside));
+    store8(twd + i, _mm256_blendv_ps(direction8(u, v), none, outside));
+  }
+
+  interpolate_scalar(grid, points, i, n, tws, twd);
+}
+
+WindKernel::Level detect() {
+#if defined(__GNUC__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return WindKernel::Level::kAvx2;
+  if (__builtin_cpu_supports("sse4.1")) return WindKernel::Level::kSse41;
+#else
+  int info[4];
+  __cpuid(info, 1);
+  bool sse41 = (info[2] & (1 << 19)) != 0;
+  // AVX also needs the OS to save the YMM registers
+  bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+             (_xgetbv(0) & 6) == 6;
+  __cpuidex(info, 7, 0);
+  if (avx && (info[1] & (1 << 5)) != 0) return WindKernel::Level::kAvx2;
+  if (sse41) return WindKernel::Level::kSse41;
+#endif
+  return WindKernel::Level::kScalar;
+}
+#else
+WindKernel::Level detect() { return WindKernel::Level::kScalar; }
+#endif
+}  // namespace
+
+namespace WindKernel {
+
+Level GetBestLevel() {
+  static const Level level = detect();
+  return level;
+}
+
+const char* GetName(Level level) {
+  switch (level) {
+    case Level::kAvx2:
+      return "AVX2";
+    case Level::kSse41:
+      return "SSE4.1";
+    default:
+      return "scalar";
+  }
+}
+
+void Interpolate(const Grid& grid, const Points& points, size_t n,
+                 double* tws, double* twd, Level level) {
+#ifdef SOL_KERNEL_X86
+  if (level == Level::kAvx2) return interpolate_avx2(grid, points, n, tws, twd);
+  if (level == Level::kSse41)
+    return interpolate_sse41(grid, points, n, tws, twd);
+#endif
+  interpolate_scalar(grid, points, 0, n, tws, twd);
+}
+}  // namespace WindKernel
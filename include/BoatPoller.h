@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _BOATPOLLER_H_
+#define _BOATPOLLER_H_
+
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wx/event.h>
+
+#include "SolXml.h"
+
+typedef void CURL;
+class ClockSync;
+
+/**
+ * Class that polls the state of the own boat from <boaturl> (see
+ * Race::GetRaceInfo()) on a worker thread. The interval adapts to the plan:
+ * short before the next DC, when the actual state matters most, long
+ * otherwise. Unchanged replies are skipped, new states are passed to the
+ * handler on the GUI thread. The times of the states bound the server clock.
+ */
+class BoatPoller : wxEvtHandler {
+public:
+  using Handler = std::function<void(const SolXml::BoatState&)>;
+
+  /// Shortest and longest time between two polls, seconds
+  static constexpr double kMinInterval = 10.0;
+  static constexpr double kMaxInterval = 300.0;
+
+  explicit BoatPoller(std::shared_ptr<ClockSync> clock);
+  ~BoatPoller();
+
+  BoatPoller(const BoatPoller&) = delete;
+  BoatPoller& operator=(const BoatPoller&) = delete;
+
+  /// Return error messages and clear the error store. Thread safe
+  std::vector<std::string> GetErrors();
+
+  /// Poll url until Stop(). A running poll of another url is stopped
+  void Start(const std::string& url, Handler handler);
+  /// Stop polling, waits for a running request
+  void Stop();
+  bool IsRunning() const { return m_thread.joinable(); }
+  const std::string& GetUrl() const { return m_url; }
+
+  /// Time of the next planned DC, 0 if there is none. Thread safe
+  void SetNextDc(std::time_t time);
+
+  /// Seconds from a poll at now to the next one
+  static double GetInterval(std::time_t now, std::time_t next_dc);
+
+private:
+  std::shared_ptr<ClockSync> m_clock;
+  std::string m_url;
+  Handler m_handler;
+  std::thread m_thread;
+
+  // Shared with the worker
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_stop = false;
+  std::time_t m_next_dc = 0;
+  std::vector<std::string> m_errors;
+
+  void Run();
+  /// One request. Returns false on failure
+  bool Poll(CURL* curl, std::string& etag, std::string& last_text);
+};
+
+#endif
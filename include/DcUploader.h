@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _DCUPLOADER_H_
+#define _DCUPLOADER_H_
+
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DcSync.h"
+#include "SolXml.h"
+
+typedef void CURL;
+class ClockSync;
+
+/**
+ * Class that sends DC changes to sailonline.org with as little delay as
+ * possible. One connection is kept open (keep-alive) and reused for all
+ * requests, so that an upload doesn't pay for the TCP and TLS handshakes.
+ * The requests are validated and serialized by Prepare() before the upload
+ * is started. The Date headers of the answers are fed to the clock. Not
+ * thread safe, except for the connection opened by WarmUp() on a worker
+ * thread, which the other methods wait for.
+ */
+class DcUploader {
+public:
+  using Handler = std::function<void(const std::vector<std::string>& errors)>;
+
+  /// DCs closer to now than this (seconds) may be executed before they arrive
+  static constexpr std::time_t kMinLead = 5;
+
+  explicit DcUploader(std::shared_ptr<ClockSync> clock);
+  ~DcUploader();
+
+  DcUploader(const DcUploader&) = delete;
+  DcUploader& operator=(const DcUploader&) = delete;
+
+  /// Return error messages and clear the error store
+  std::vector<std::string> GetErrors();
+
+  /// Open the connection to the server of url on a worker thread, if it
+  /// isn't open anymore. handler is called on the worker thread with the
+  /// errors when done
+  void WarmUp(const std::string& url, Handler handler);
+
+  /// Serialize the requests that turn the DCs of server_dcs after now into
+  /// planned_dcs (see DcSync::DiffUpload()). add_url and delete_url are
+  /// SolApi::kSolDcAddUrl and SolApi::kSolDcDeleteUrl with race and token
+  /// filled in
+  bool Prepare(const std::vector<SolXml::ServerDc>& server_dcs,
+               const std::vector<SolXml::ServerDc>& planned_dcs,
+               std::time_t now, const std::string& add_url,
+               const std::string& delete_url);
+
+  /// True if Prepare() was called for these planned DCs
+  bool IsPrepared(const std::vector<SolXml::ServerDc>& planned_dcs) const;
+
+  /// Number of prepared requests
+  size_t GetRequestCount() const { return m_requests.size(); }
+
+  /// Send the prepared requests. Fails if a DC would arrive too late
+  bool Send(std::time_t now);
+
+  /// GET url on the open connection
+  bool Get(const std::string& url, std::string& response);
+
+private:
+  struct Request {
+    std::time_t m_time;  // Of the DC
+    std::string m_url;
+    std::string m_post;
+  };
+
+  std::shared_ptr<ClockSync> m_clock;
+  CURL* m_curl = nullptr;
+  std::thread m_warm_up;
+  bool m_prepared = false;
+  std::vector<SolXml::ServerDc> m_planned_dcs;
+  std::vector<Request> m_requests;
+  std::vector<std::string> m_errors;
+
+  /// Wait for a running WarmUp()
+  void WaitForWarmUp();
+  /// curl_easy_perform() that samples the clock
+  CURLcode PerformSampled();
+  /// GET if post is empty, POST otherwise
+  bool Perform(const std::string& url, const std::string& post,
+               std::string& response);
+  std::string Escape(const std::string& value);
+};
+
+#endif
@@ -20,27 +20,41 @@
 #ifndef _FROMROUTEDIALOG_H
 #define _FROMROUTEDIALOG_H
 
+#include <vector>
+
 #include <wx/event.h>
 #include <wx/string.h>
 
 #include "SailonlineUiBase.h"
 
 class SailonlineUi;
+class TrackCatalogue;
 
 /**
- * Class that handles the main DC from track functionality.
+ * Class that handles the main DC from track functionality. Tracks are listed
+ * from the track catalogue, tracks new to it are summarized while the dialog
+ * is idle.
  */
 class FromTrackDialog : public FromTrackDialogBase {
 public:
-  FromTrackDialog(SailonlineUi* psailonline);
+  FromTrackDialog(SailonlineUi* psailonline, TrackCatalogue& catalogue);
 
   void OnFromTrackDone(wxCommandEvent& event);
 
   wxString GetSelectedTrack() const { return m_selected_track; }
 
 private:
-  wxArrayString m_track_guids;
+  TrackCatalogue& m_catalogue;
+  // Catalogue entries shown in the track list
+  std::vector<size_t> m_visible;
   wxString m_selected_track;
+
+  void OnFilterText(wxCommandEvent& event);
+  void OnResetAll(wxCommandEvent& event);
+  void OnIdle(wxIdleEvent& event);
+
+  /// Show the catalogue entries that match the filter
+  void FillTrackList();
 };
 
 #endif
@@ -20,39 +20,40 @@
 #ifndef _RACE_H_
 #define _RACE_H_
 
+#include <cmath>
+#include <functional>
 #include <list>
 #include <string>
 #include <memory>
+#include <vector>
 
-#include <wx/datetime.h>
+#include <wx/string.h>
+
+#include "Dc.h"
+#include "DcTiming.h"
+#include "DriftMonitor.h"
+#include "PerformanceLedger.h"
+#include "PlanHistory.h"
+#include "Polar.h"
+#include "Providers.h"
+#include "Robustness.h"
+#include "StartSweep.h"
+#include "SolXml.h"
 
 typedef void CURL;
+class ClockSync;
+class DcUploader;
 class PlugIn_Waypoint;
+class WindGrid;
 class sailonline_pi;
 
 /**
- * Class that handles SOL delayed commands
+ * Class that handles a SOL race. Wind data for the DC algorithms (see
+ * DcModel) are taken from the weather of the race (see DownloadWeather()),
+ * elsewhere requested from the GRIB plugin. Boat data are requested from the
+ * weather routing plugin.
  */
-class Dc {
-public:
-  wxDateTime m_timestamp;
-  double m_lat_start;
-  double m_lon_start;
-  double m_course;
-  double m_tws;           // True wind speed
-  double m_twa;           // True wind angle
-  double m_stw;           // Boat speed through water
-  double m_opt_upwind;    // Optimal angle for going upwind
-  double m_opt_downwind;  // Optimal angle for going downwind
-  double m_perf_begin;    // Performance directly after course change
-  double m_perf_end;      // Performance directly before next course change
-  bool m_is_twa;
-
-  Dc(const wxDateTime& m_timestamp, const double m_lat_start,
-     const double m_lon_start, const double m_course, const bool m_is_twa);
-};
-
-class Race {
+class Race : public WindProvider, public PolarProvider {
 public:
   Race(sailonline_pi& plugin);
   ~Race();
@@ -74,19 +75,131 @@ public:
   /// Extract waypoints from race XML
   bool DownloadWaypoints();
 
+  /// Download the latest forecast of the race, the wind the server sails the
+  /// boats in. Every forecast is parsed once and cached as a binary grid in
+  /// the race directory, later it is only mapped into memory
+  bool DownloadWeather();
+  /// URL of the weather info (see WeatherPoller), empty on failure
+  std::string GetWeatherInfoUrl();
+  /// Swap in a new forecast and re-enrich the DCs still to come. Copies of
+  /// the race keep the forecast they had
+  void SetWeather(const SolXml::WeatherInfo& info,
+                  std::shared_ptr<const WindGrid> weather);
+  /// URL of the forecast in use, empty if there is none
+  const std::string& GetWeatherUrl() const { return m_weather_url; }
+  /// Directory of the cached files of the race
+  std::string GetCacheDir() const;
+
+  /// Download the DC list of the boat and apply the changes since the last
+  /// download to the DC list. DCs planned locally are kept. Unchanged server
+  /// lists are not transferred again
+  bool DownloadDcs();
+
+  /// Validate the DCs and prepare the requests for UploadDcs(), so that the
+  /// upload itself is as fast as possible. Requires a DownloadDcs() before
+  bool PrepareUpload();
+
+  /// Open the connection for UploadDcs() on a worker thread. handler is
+  /// called on the worker thread with the errors when done
+  void WarmUpUpload(
+      std::function<void(const std::vector<std::string>& errors)> handler);
+
+  /// Send the changes of the DC list against the server's list and read the
+  /// list back to confirm them
+  bool UploadDcs();
+
+  /// URL of the boat state (see BoatPoller), empty on failure
+  std::string GetBoatUrl();
+  /// Re-anchor the DC list at the actual state of the boat: the DCs after it
+  /// are simulated from its position and performance from now on. The state
+  /// is compared with the plan made by the last EnrichDcs()
+  void SetBoatState(const SolXml::BoatState& state);
+  /// Deviation of the last boat state from the plan
+  const DriftMonitor::Drift& GetDrift() const { return m_drift; }
+  bool HasBoatState() const { return m_has_boat_state; }
+  const SolXml::BoatState& GetBoatState() const { return m_boat_state; }
+
+  /// Estimate of the server clock, shared by all races. DCs are planned
+  /// against it, the local clock may be off by seconds
+  ClockSync& GetClock() const;
+
+  /// Milliseconds from the start of the last upload to its confirmation
+  double GetUploadLatency() const { return m_upload_latency; }
+  /// True if the DCs on the server are known, see DownloadDcs()
+  bool HasServerDcs() const { return m_has_server_dcs; }
+
+  /// Log in, download and parse the race XML and the polar, and optionally
+  /// the fleet data, without touching the GUI. Safe to call from a worker
+  /// thread as long as no other thread uses this race
+  bool Prefetch(bool fleet);
+
+  /// Boat polar parsed from race XML, empty before Prefetch()
+  const Polar& GetPolar() const { return m_polar; }
+
   const std::vector<std::shared_ptr<PlugIn_Waypoint>>& GetWaypoints() const;
 
   const std::list<Dc>& GetDcs() const;
   std::list<Dc>& GetDcs();
 
-  /// Enrich the DC list with calculated values for diagnostic purposes
+  /// Replace the DC list by the fewest DCs that follow the route
+  void CompileDcs(const std::vector<TrackPoint>& route);
+  /// Enrich the DC list with calculated values for diagnostic purposes, and
+  /// make it the plan the boat states are compared with. A changed plan is
+  /// recorded for undo and saved in the background (see LoadPlan())
   void EnrichDcs();
+  /// Versions of the DC list and plans kept for comparison
+  const PlanHistory& GetHistory() const { return m_history; }
+  /// Go back to the DC list before the last change. Returns false if there
+  /// is none
+  bool UndoPlan();
+  /// Go forward to the DC list undone last
+  bool RedoPlan();
+  /// Take over the DC list and its versions from another copy of the race
+  void CopyPlan(const Race& other);
+  /// Keep the DC list under name for ComparePlans()
+  void KeepPlan(const std::string& name);
+  /// Replace the DC list by the plan kept as index i of GetHistory(), which
+  /// can be undone
+  bool RestorePlan(size_t i);
+  /// Simulated ETAs at the course waypoints, see PlanHistory::GetEtas(), of
+  /// the DC list (first) and the kept plans
+  bool ComparePlans(double radius, std::vector<std::vector<double>>& etas);
+  /// Replace the DC list by the plan saved in the race directory, plan.dcs,
+  /// which survives restarts. Next to it is plan.txt, the same plan in the
+  /// format of the "Copy DCs" button with start positions. Returns false if
+  /// there is no plan or it can't be read
+  bool LoadPlan();
+  /// Distance and time the plan loses to maneuvers, per DC, as of the last
+  /// EnrichDcs() or new forecast
+  const PerformanceLedger& GetLedger() const { return m_ledger; }
   /// Try to shorten the DC list by joining legs with almost identical courses
   void SimplifyDcs();
   /// Try to minimize performance loss when tacking and jibing
   void OptimizeManeuvers();
   /// Create a track from the DC list
   void MakeTrack() const;
+  /// Replace the DC list by the fastest route (see Router) from the first
+  /// course waypoint through all others, starting at the race start or now,
+  /// whichever is later. Wind and boat data are requested by messaging, so
+  /// this runs on the GUI thread
+  bool RouteCourse();
+  /// Sail the DCs in perturbed versions of the forecast on all cores (see
+  /// Robustness), from the boat state if there is one. ETAs are reported for
+  /// the course waypoints
+  bool TestRobustness(const RobustnessSettings& settings,
+                      RobustnessResult& result);
+  /// Move the DCs still to come for the earliest arrival at the next course
+  /// waypoint (see DcTiming), the one after the waypoint nearest to the boat
+  /// or the first DC. DCs before now plus the upload lead stay. Runs on all
+  /// cores with the forecast of the race
+  bool OptimizeTiming(const DcTimingSettings& settings,
+                      DcTimingResult& result);
+  /// Sail departures from the race start or now, whichever is later, over
+  /// window seconds with the forecast of the race on all cores (see
+  /// StartSweep). The DCs are the template if there are any, otherwise the
+  /// course is routed for every departure
+  bool SweepStart(const StartSweepSettings& settings, std::time_t window,
+                  std::vector<Departure>& departures);
 
 private:
   sailonline_pi& m_sailonline_pi;
@@ -98,28 +211,83 @@ private:
 
   // This must be list because of element insertion in OnDcModify()
   std::list<Dc> m_dcs;
+  // Server state of the DCs at the last download, see DcSync
+  bool m_has_server_dcs = false;
+  std::vector<SolXml::ServerDc> m_server_dcs;
+  std::string m_server_dcs_etag;
+
+  // Created on first use. Copies of the race share the connection, but only
+  // the race shown in the GUI uploads
+  std::shared_ptr<DcUploader> m_uploader;
+  double m_upload_latency = 0.0;
+
+  /// The DCs after now to upload, see DcSync::ToServer()
+  bool GetPlannedDcs(std::time_t now, std::vector<SolXml::ServerDc>& planned);
+
+  // Last state of the boat from the poller
+  bool m_has_boat_state = false;
+  SolXml::BoatState m_boat_state;
+  DriftMonitor m_drift_monitor;
+  DriftMonitor::Drift m_drift{0, NAN, 0.0, false};
+  /// The boat state as seen by DcModel
+  bool GetAnchor(DcModel::Anchor& anchor) const;
+  /// Model for the DC algorithms, anchored at the boat state if there is one
+  DcModel GetModel() const;
+  // Losses of the plan, see GetLedger()
+  PerformanceLedger m_ledger;
+  /// Simulate the DCs for the ledger
+  void UpdateLedger(const DcModel& model);
+  // Versions of the DC list, see UndoPlan()
+  PlanHistory m_history;
+  /// Record the DC list for undo and queue it for saving, see LoadPlan()
+  void CommitPlan();
+  /// Path of a file in the race directory
+  std::string GetRaceFile(const wxString& name) const;
 
   std::vector<std::shared_ptr<PlugIn_Waypoint>> m_waypoints;
 
+  // Parsed race XML, to avoid reading the cache file again
+  bool m_has_raceinfo = false;
+  SolXml::RaceInfo m_raceinfo;
+  Polar m_polar;
+  // Forecast in use, see SetWeather(). Immutable and shared by copies of the
+  // race
+  std::string m_weather_url;
+  std::shared_ptr<const WindGrid> m_weather;
+
   /// Open connection to sailonline.org and get access token
   bool Login();
 
   /// Download detailed raceinfo XML
   wxString GetRaceInfo();
+  /// Download and parse detailed raceinfo XML
+  bool GetRaceInfo(SolXml::RaceInfo& info);
+  /// Download the fleet data (race_<id>.xml, compressed) into the race cache
+  bool DownloadFleet(const std::string& url);
+
+  // True wind speed (knots) and true wind direction (degrees) from the
+  // forecast, otherwise from the GRIB plugin
+  std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                        double lon) const override;
+  void GetWindDataBatch(size_t n, const std::time_t* t, const double* lat,
+                        const double* lon, double* tws,
+                        double* twd) const override;
 
   // Messaging
   // Request grib values: True wind speed (knots) and true wind direction
   // (degrees)
-  std::pair<double, double> GetWindData(const wxDateTime& t, double lat,
-                                        double lon) const;
+  std::pair<double, double> GetGribWindData(std::time_t t, double lat,
+                                            double lon) const;
   // Request boat data: Boat speed (knots)
-  double GetSpeedThroughWater(double tws, double twa) const;
+  double GetSpeedThroughWater(double tws, double twa) const override;
   // Request boat data: optimal upwind angle (degrees), optimal downwind angle
   // (degrees)
-  std::pair<double, double> GetBoatOptimalAngles(double tws) const;
+  std::pair<double, double> GetBoatOptimalAngles(double tws) const override;
 
   /// Convenience funtion to shorten curl_easy_perform calls
   bool CallCurl(CURL* curl);
+  /// GET url into data, compressed in transfer if the server supports it
+  bool Download(const std::string& url, std::string& data);
 
   /// Convencience function for placeholders in URLs
   std::string SetPlaceholders(const std::string& input) const;
@@ -20,12 +20,24 @@
 #ifndef _SAILONLINE_H_
 #define _SAILONLINE_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <wx/event.h>
 
 #include <ocpn_plugin.h>
 
 class sailonline_pi;
+class ClockSync;
 class Race;
+namespace SolFile {
+class BackgroundWriter;
+}
 
 /**
  * Class that handles the Sailonline data.
@@ -43,12 +55,39 @@ public:
   }
   std::unique_ptr<Race> GetRace(const std::string& racenumber) const;
 
+  /// Estimate of the sailonline.org clock, fed by the requests of all races
+  std::shared_ptr<ClockSync> GetClock() const { return m_clock; }
+  /// Writes the autosaved files of all races, see Race::EnrichDcs()
+  std::shared_ptr<SolFile::BackgroundWriter> GetWriter() const {
+    return m_writer;
+  }
+
+  /// Prefetch all races in the background (see Race::Prefetch()), at most
+  /// kPrefetchThreads at a time. When done, the races are replaced on the GUI
+  /// thread, errors are stored and the prefetch handler is called. Returns
+  /// false if a prefetch is already running or there are no races
+  bool PrefetchRaces(bool fleet);
+  bool IsPrefetching() const { return m_prefetching; }
+  /// Set the function that is called on the GUI thread after a prefetch
+  void SetPrefetchHandler(std::function<void()> handler) {
+    m_prefetch_handler = handler;
+  }
+
 private:
   sailonline_pi& m_sailonline_pi;
 
   std::vector<std::string> m_errors;
 
   std::unordered_map<std::string, Race> m_races;
+  std::shared_ptr<ClockSync> m_clock;
+  std::shared_ptr<SolFile::BackgroundWriter> m_writer;
+
+  // Prefetching
+  static constexpr size_t kPrefetchThreads = 4;
+  std::thread m_prefetch_thread;
+  std::atomic<bool> m_prefetching{false};
+  std::function<void()> m_prefetch_handler;
+  void OnPrefetchDone(std::vector<Race>& races);
 
   // Downloading
   void OnDownloadEvent(OCPN_downloadEvent& ev);
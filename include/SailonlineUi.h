@@ -23,10 +23,18 @@
 #include <memory>
 
 #include "SailonlineUiBase.h"
+#include "TrackCatalogue.h"
 
 class sailonline_pi;
 class Sailonline;
 class Race;
+class BoatPoller;
+class WeatherPoller;
+class WindGrid;
+namespace SolXml {
+struct BoatState;
+struct WeatherInfo;
+}
 
 /**
  * Class that handles the Sailonline user interface.
@@ -48,6 +56,20 @@ private:
 
   std::vector<std::string> m_init_errors;
 
+  // Download and upload of the DCs. Off unless "DcServerSync" is set in the
+  // configuration, until the DC endpoints of the server are confirmed
+  bool m_dc_server_sync = false;
+
+  // Summaries of the OpenCPN tracks, kept between "From track" dialogs
+  TrackCatalogue m_track_catalogue;
+
+  // State of the own boat in the current race, while the DCs are shown
+  std::unique_ptr<BoatPoller> m_boat_poller;
+  void StartBoatPolling();
+  // New forecasts of the current race, while the DCs are shown
+  std::unique_ptr<WeatherPoller> m_weather_poller;
+  void StartWeatherPolling();
+
   // Show data on selected notebook page
   void ShowPage(const int page);
 
@@ -56,6 +78,22 @@ private:
   void OnClose(wxCloseEvent& event) { Hide(); }
   void OnClose(wxCommandEvent& event) { Hide(); }
   void OnRaceSelected(wxListEvent& event);
+  void OnRaceListRightClick(wxListEvent& event);
+  void OnPrefetchDone();
+  /// Actions on the DCs of the current race
+  void OnDcListContextMenu(wxContextMenuEvent& event);
+  void OnRouteCourse();
+  void OnTestRobustness();
+  void OnOptimizeTiming();
+  void OnSweepStart();
+  /// Undo or redo the last change of the DCs
+  void OnUndoPlan(bool redo);
+  void OnKeepPlan();
+  void OnComparePlans();
+  void OnRestorePlan();
+  void OnBoatState(const SolXml::BoatState& state);
+  void OnWeather(const SolXml::WeatherInfo& info,
+                 std::shared_ptr<const WindGrid> weather);
   void OnPageChanged(wxBookCtrlEvent& event);
   void OnPolarDownload(wxCommandEvent& event);
   void OnDcDownload(wxCommandEvent& event);
@@ -40,6 +40,23 @@ const static std::string kSolPost =
 const static std::string kSolRaceXmlUrl =
     "https://www.sailonline.org/webclient/"
     "auth_raceinfo_$$racenumber.xml?token=$$token";
+// The DC endpoints below are not confirmed by sailonline.org yet. Download
+// and upload of DCs are off unless "DcServerSync" is set in the configuration
+//
+// DC list of the logged in boat, as used by the web client:
+// <dcs><dc><id/><time>YYYY/MM/DD HH:MM:SS</time><type>cc|twa</type><value/>
+// </dc>...</dcs>
+const static std::string kSolDcListUrl =
+    "https://www.sailonline.org/webclient/dcs_$$racenumber.xml?token=$$token";
+// Add a DC (time in UTC as in the DC list) or delete one by its ID
+const static std::string kSolDcAddUrl =
+    "https://www.sailonline.org/webclient/dcs_$$racenumber/add?token=$$token";
+const static std::string kSolDcAddPost =
+    "time=$$time&type=$$type&value=$$value";
+const static std::string kSolDcDeleteUrl =
+    "https://www.sailonline.org/webclient/dcs_$$racenumber/delete?"
+    "token=$$token";
+const static std::string kSolDcDeletePost = "id=$$id";
 };  // namespace SolApi
 
 #endif
@@ -0,0 +1,48 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SOLHTTP_H_
+#define _SOLHTTP_H_
+
+#include <ctime>
+#include <string>
+
+typedef void CURL;
+class ClockSync;
+
+/**
+ * Namespace for the HTTP details shared by the requests to sailonline.org.
+ */
+namespace SolHttp {
+/// Response headers the plugin is interested in
+struct Headers {
+  std::string m_etag;
+  std::time_t m_date = -1;  // Server time, -1 if unknown
+};
+
+/// CURLOPT_HEADERFUNCTION that fills the Headers in CURLOPT_HEADERDATA
+size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userp);
+
+/// Feed the Date header of the request just performed on curl, which was
+/// started at local_start (ClockSync::LocalNow()), to the clock
+void SampleClock(CURL* curl, double local_start, const Headers& headers,
+                 ClockSync& clock);
+}  // namespace SolHttp
+
+#endif
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _TRACKCATALOGUE_H_
+#define _TRACKCATALOGUE_H_
+
+#include <map>
+#include <vector>
+
+#include <wx/datetime.h>
+#include <wx/string.h>
+
+class PlugIn_Track;
+
+/**
+ * Class that lists the tracks of OpenCPN with their name, number of points
+ * and time span, without keeping their points. The plugin API only provides
+ * complete tracks, so every track is loaded once and its summary is cached.
+ * Refresh() picks up added and deleted tracks, new tracks are loaded one by
+ * one with LoadNext(), e.g. while the GUI is idle.
+ */
+class TrackCatalogue {
+public:
+  struct Entry {
+    wxString m_guid;
+    wxString m_name;
+    size_t m_points = 0;
+    wxDateTime m_begin;
+    wxDateTime m_end;
+    bool m_loaded = false;  // Name etc. are not known before
+  };
+
+  /// Update the list of tracks from OpenCPN. Cached entries are kept
+  void Refresh();
+
+  /// Load the summary of the next track that isn't loaded yet. Returns false
+  /// if there is none
+  bool LoadNext();
+
+  /// True if LoadNext() has work to do
+  bool HasPending() const { return m_next_pending < m_order.size(); }
+
+  /// Update an entry from a track that was loaded anyway
+  void Update(const PlugIn_Track& track);
+
+  size_t GetCount() const { return m_order.size(); }
+  /// Entries in the order of OpenCPN
+  const Entry& GetEntry(size_t i) const;
+
+  /// Label for a list: name, number of points and time span
+  static wxString GetLabel(const Entry& entry);
+
+private:
+  std::map<wxString, Entry> m_entries;
+  std::vector<const Entry*> m_order;
+  // All entries before this one are loaded
+  size_t m_next_pending = 0;
+
+  static void Summarize(const PlugIn_Track& track, Entry& entry);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _WEATHERPOLLER_H_
+#define _WEATHERPOLLER_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wx/event.h>
+
+#include "SolXml.h"
+
+typedef void CURL;
+class ClockSync;
+class WindGrid;
+
+/**
+ * Class that watches the weather info of a race (<weatherurl>, see
+ * Race::GetRaceInfo()) for new forecasts on a worker thread. The info is
+ * polled cheaply: unchanged replies transfer nothing but the status. A new
+ * forecast is downloaded, parsed and cached on the worker as well, and only
+ * the finished grid is passed to the handler on the GUI thread.
+ */
+class WeatherPoller : wxEvtHandler {
+public:
+  using Handler = std::function<void(const SolXml::WeatherInfo&,
+                                     std::shared_ptr<const WindGrid>)>;
+
+  /// Time between two polls, seconds. Forecasts are published a few times
+  /// a day
+  static constexpr double kInterval = 120.0;
+
+  explicit WeatherPoller(std::shared_ptr<ClockSync> clock);
+  ~WeatherPoller();
+
+  WeatherPoller(const WeatherPoller&) = delete;
+  WeatherPoller& operator=(const WeatherPoller&) = delete;
+
+  /// Return error messages and clear the error store. Thread safe
+  std::vector<std::string> GetErrors();
+
+  /// Poll url until Stop(). Forecasts are cached in cache_dir, the forecast
+  /// at known_url (the one in use) is not passed to the handler again. A
+  /// running poll of another url is stopped
+  void Start(const std::string& url, const std::string& cache_dir,
+             const std::string& known_url, Handler handler);
+  /// Stop polling, waits for a running request or download
+  void Stop();
+  bool IsRunning() const { return m_thread.joinable(); }
+  const std::string& GetUrl() const { return m_url; }
+
+  /// Grid of the forecast at url: mapped from its cache file in cache_dir if
+  /// there is one, otherwise downloaded, parsed and cached. nullptr on
+  /// failure, see errors. The download is aborted once cancelled returns
+  /// true
+  static std::shared_ptr<const WindGrid> LoadForecast(
+      const std::string& url, const std::string& cache_dir,
+      std::vector<std::string>& errors,
+      std::function<bool()> cancelled = nullptr);
+
+private:
+  std::shared_ptr<ClockSync> m_clock;
+  std::string m_url;
+  std::string m_cache_dir;
+  std::string m_known_url;
+  Handler m_handler;
+  std::thread m_thread;
+
+  // Shared with the worker
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_stop = false;
+  std::vector<std::string> m_errors;
+
+  void Run();
+  /// One request. Returns false on failure
+  bool Poll(CURL* curl, std::string& etag, std::string& last_text);
+};
+
+#endif
@@ -0,0 +1,180 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+
+#include <curl/curl.h>
+
+#include "BoatPoller.h"
+#include "ClockSync.h"
+#include "SolHttp.h"
+
+namespace {
+size_t curl_append_cb(void* contents, size_t size, size_t nmemb,
+                      void* userp) {
+  size_t realsize = size * nmemb;
+  static_cast<std::string*>(userp)->append(static_cast<const char*>(contents),
+                                           realsize);
+  return realsize;
+}
+}  // namespace
+
+BoatPoller::BoatPoller(std::shared_ptr<ClockSync> clock)
+    : m_clock(std::move(clock)) {}
+
+BoatPoller::~BoatPoller() {
+  // Pending handler calls are discarded together with this handler
+  Stop();
+}
+
+std::vector<std::string> BoatPoller::GetErrors() {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::swap(m_errors, result);
+  return result;
+}
+
+void BoatPoller::Start(const std::string& url, Handler handler) {
+  Stop();
+
+  m_url = url;
+  m_handler = handler;
+  m_stop = false;
+  m_thread = std::thread([this]() { Run(); });
+}
+
+void BoatPoller::Stop() {
+  if (!m_thread.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wakeup.notify_all();
+  m_thread.join();
+}
+
+void BoatPoller::SetNextDc(std::time_t time) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (time == m_next_dc) return;
+    m_next_dc = time;
+  }
+  // The worker recalculates its wait
+  m_wakeup.notify_all();
+}
+
+double BoatPoller::GetInterval(std::time_t now, std::time_t next_dc) {
+  if (next_dc <= now) return kMaxInterval;
+
+  // Four polls before the DC, the last one shortly before it
+  return std::clamp(std::difftime(next_dc, now) / 4.0, kMinInterval,
+                    kMaxInterval);
+}
+
+void BoatPoller::Run() {
+  // Note: curl_global_init() is called by class Sailonline
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return;
+  }
+
+  // One connection for all polls
+  curl_easy_setopt(curl, CURLOPT_URL, m_url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_append_cb);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, SolHttp::HeaderCallback);
+
+  std::string etag, last_text;
+  while (true) {
+    bool success = Poll(curl, etag, last_text);
+    auto polled = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+      double interval =
+          success ? GetInterval(m_clock->Now(), m_next_dc) : kMaxInterval;
+      auto deadline = polled + std::chrono::milliseconds(
+                                   static_cast<long>(interval * 1000.0));
+      if (m_wakeup.wait_until(lock, deadline) == std::cv_status::timeout)
+        break;
+    }
+    if (m_stop) break;
+  }
+
+  curl_easy_cleanup(curl);
+}
+
+bool BoatPoller::Poll(CURL* curl, std::string& etag, std::string& last_text) {
+  // Nothing but the status is transferred if the state is unchanged
+  struct curl_slist* headers = nullptr;
+  if (!etag.empty())
+    headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  SolHttp::Headers response_headers;
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)&response_headers);
+  std::string text;
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&text);
+
+  double local_start = ClockSync::LocalNow();
+  CURLcode result = curl_easy_perform(curl);
+  double local_receive = ClockSync::LocalNow();
+  long status = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(headers);
+
+  std::string error;
+  if (result != CURLE_OK) {
+    error = "Curl error: " + std::to_string(result);
+  } else if (status != 304 && (status < 200 || status >= 300)) {
+    error = "HTTP error " + std::to_string(status) + " for the boat state";
+  }
+  if (!error.empty()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  SolHttp::SampleClock(curl, local_start, response_headers, *m_clock);
+  if (status == 304 || text == last_text) return true;
+  etag = response_headers.m_etag;
+  last_text = text;
+
+  SolXml::BoatState state;
+  if (!SolXml::ParseBoatState(text, state, error)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back(error);
+    return false;
+  }
+  m_clock->AddLowerBound(state.m_time, local_receive);
+
+  CallAfter([this, state]() {
+    if (m_handler) m_handler(state);
+  });
+  return true;
+}
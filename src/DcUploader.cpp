@@ -0,0 +1,243 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+
+#include <curl/curl.h>
+
+#include "ClockSync.h"
+#include "DcUploader.h"
+#include "SolApi.h"
+#include "SolHttp.h"
+#include "SolTime.h"
+
+namespace {
+size_t curl_append_cb(void* contents, size_t size, size_t nmemb,
+                      void* userp) {
+  size_t realsize = size * nmemb;
+  static_cast<std::string*>(userp)->append(static_cast<const char*>(contents),
+                                           realsize);
+  return realsize;
+}
+
+std::string replaced(std::string text, const std::string& placeholder,
+                     const std::string& value) {
+  auto pos = text.find(placeholder);
+  if (pos != std::string::npos) text.replace(pos, placeholder.size(), value);
+  return text;
+}
+}  // namespace
+
+DcUploader::DcUploader(std::shared_ptr<ClockSync> clock)
+    : m_clock(std::move(clock)) {
+  // Note: curl_global_init() is called by class Sailonline
+  m_curl = curl_easy_init();
+  if (m_curl == nullptr) return;
+
+  curl_easy_setopt(m_curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  curl_easy_setopt(m_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(m_curl, CURLOPT_TCP_KEEPIDLE, 30L);
+  curl_easy_setopt(m_curl, CURLOPT_TCP_KEEPINTVL, 15L);
+  curl_easy_setopt(m_curl, CURLOPT_TCP_NODELAY, 1L);
+  curl_easy_setopt(m_curl, CURLOPT_CONNECTTIMEOUT, 10L);
+  curl_easy_setopt(m_curl, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, curl_append_cb);
+}
+
+DcUploader::~DcUploader() {
+  WaitForWarmUp();
+  if (m_curl != nullptr) curl_easy_cleanup(m_curl);
+}
+
+std::vector<std::string> DcUploader::GetErrors() {
+  std::vector<std::string> result;
+  std::swap(m_errors, result);
+  return result;
+}
+
+void DcUploader::WarmUp(const std::string& url, Handler handler) {
+  WaitForWarmUp();
+
+  // The worker has the handle to itself until it is joined, errors are
+  // passed to the handler instead of the error store
+  m_warm_up = std::thread([this, url, handler]() {
+    std::vector<std::string> errors;
+    if (m_curl == nullptr) {
+      errors.emplace_back("Curl error: curl_easy_init() failed");
+    } else {
+      // HEAD request: connects, or finds the connection still open
+      std::string response;
+      curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
+      curl_easy_setopt(m_curl, CURLOPT_NOBODY, 1L);
+      curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, (void*)&response);
+      CURLcode result = PerformSampled();
+      curl_easy_setopt(m_curl, CURLOPT_NOBODY, 0L);
+      if (result != CURLE_OK)
+        errors.emplace_back("Could not connect for the DC upload: " +
+                            std::string(curl_easy_strerror(result)));
+    }
+    if (handler) handler(errors);
+  });
+}
+
+void DcUploader::WaitForWarmUp() {
+  if (m_warm_up.joinable()) m_warm_up.join();
+}
+
+bool DcUploader::Prepare(const std::vector<SolXml::ServerDc>& server_dcs,
+                         const std::vector<SolXml::ServerDc>& planned_dcs,
+                         std::time_t now, const std::string& add_url,
+                         const std::string& delete_url) {
+  WaitForWarmUp();
+  m_prepared = false;
+  m_requests.clear();
+  if (m_curl == nullptr) {
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return false;
+  }
+
+  // Deletions first, SOL allows only one DC per second
+  auto changes = DcSync::DiffUpload(server_dcs, planned_dcs, now);
+  for (const auto& change : changes) {
+    if (change.m_kind == DcSync::Change::kAdded) continue;
+    if (change.m_dc.m_id.empty()) {
+      m_errors.emplace_back("DC at " + SolTime::FormatUtc(change.m_dc.m_time) +
+                            " has no ID on the server");
+      return false;
+    }
+    m_requests.push_back(
+        {change.m_dc.m_time, delete_url,
+         replaced(SolApi::kSolDcDeletePost, "$$id", Escape(change.m_dc.m_id))});
+  }
+  for (const auto& change : changes) {
+    if (change.m_kind == DcSync::Change::kRemoved) continue;
+    char value[32];
+    std::snprintf(value, sizeof(value), "%.3f", change.m_dc.m_value);
+    std::string post = replaced(SolApi::kSolDcAddPost, "$$time",
+                                Escape(SolTime::FormatUtc(change.m_dc.m_time)));
+    post = replaced(post, "$$type", change.m_dc.m_is_twa ? "twa" : "cc");
+    post = replaced(post, "$$value", value);
+    m_requests.push_back({change.m_dc.m_time, add_url, std::move(post)});
+  }
+
+  m_planned_dcs = planned_dcs;
+  m_prepared = true;
+  return true;
+}
+
+bool DcUploader::IsPrepared(
+    const std::vector<SolXml::ServerDc>& planned_dcs) const {
+  return m_prepared && planned_dcs.size() == m_planned_dcs.size() &&
+         std::equal(planned_dcs.begin(), planned_dcs.end(),
+                    m_planned_dcs.begin(),
+                    [](const SolXml::ServerDc& a, const SolXml::ServerDc& b) {
+                      return a.m_time == b.m_time &&
+                             a.m_is_twa == b.m_is_twa &&
+                             a.m_value == b.m_value;
+                    });
+}
+
+bool DcUploader::Send(std::time_t now) {
+  if (!m_prepared) {
+    m_errors.emplace_back("No DCs prepared for upload");
+    return false;
+  }
+
+  for (const auto& request : m_requests) {
+    if (request.m_time < now + kMinLead) {
+      m_errors.emplace_back("DC at " + SolTime::FormatUtc(request.m_time) +
+                            " is too close to now for an upload");
+      return false;
+    }
+  }
+
+  // Everything is sent, the server state is unknown until it is read back
+  m_prepared = false;
+  for (const auto& request : m_requests) {
+    std::string response;
+    if (!Perform(request.m_url, request.m_post, response)) return false;
+    if (response == "Bad token") {
+      m_errors.emplace_back("Race token is invalid. Try logging in again");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DcUploader::Get(const std::string& url, std::string& response) {
+  return Perform(url, "", response);
+}
+
+bool DcUploader::Perform(const std::string& url, const std::string& post,
+                         std::string& response) {
+  WaitForWarmUp();
+  if (m_curl == nullptr) {
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return false;
+  }
+
+  response.clear();
+  curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
+  if (post.empty()) {
+    curl_easy_setopt(m_curl, CURLOPT_HTTPGET, 1L);
+  } else {
+    curl_easy_setopt(m_curl, CURLOPT_POSTFIELDSIZE,
+                     static_cast<long>(post.size()));
+    curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, post.c_str());
+  }
+  curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, (void*)&response);
+
+  CURLcode result = PerformSampled();
+  if (result != CURLE_OK) {
+    m_errors.emplace_back("Curl error: " + std::to_string(result));
+    return false;
+  }
+  long status = 0;
+  curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &status);
+  if (status < 200 || status >= 300) {
+    m_errors.emplace_back("HTTP error " + std::to_string(status) + " for " +
+                          url.substr(0, url.find('?')));
+    return false;
+  }
+
+  return true;
+}
+
+CURLcode DcUploader::PerformSampled() {
+  SolHttp::Headers headers;
+  curl_easy_setopt(m_curl, CURLOPT_HEADERFUNCTION, SolHttp::HeaderCallback);
+  curl_easy_setopt(m_curl, CURLOPT_HEADERDATA, (void*)&headers);
+  double local_start = ClockSync::LocalNow();
+  CURLcode result = curl_easy_perform(m_curl);
+  if (result == CURLE_OK && m_clock != nullptr)
+    SolHttp::SampleClock(m_curl, local_start, headers, *m_clock);
+
+  return result;
+}
+
+std::string DcUploader::Escape(const std::string& value) {
+  char* escaped = curl_easy_escape(m_curl, value.c_str(),
+                                   static_cast<int>(value.size()));
+  if (escaped == nullptr) return value;
+  std::string result(escaped);
+  curl_free(escaped);
+  return result;
+}
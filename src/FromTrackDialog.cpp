@@ -18,31 +18,82 @@
  ***************************************************************************/
 
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
 
 #include <ocpn_plugin.h>
 
 #include "FromTrackDialog.h"
 #include "SailonlineUi.h"
+#include "TrackCatalogue.h"
 
-FromTrackDialog::FromTrackDialog(SailonlineUi* pui) : FromTrackDialogBase(pui) {
-  m_track_guids = GetTrackGUIDArray();
-  m_ptracklist->SetColumns(1);
+namespace {
+/// Time (ms) for loading tracks per idle event, so that the dialog stays
+/// responsive
+static constexpr long kIdleBudget = 20;
+}  // namespace
 
-  for (const auto& guid : m_track_guids) {
-    auto ptrack = GetTrack_Plugin(guid);
-    m_ptracklist->Append(ptrack->m_NameString);
-  }
+FromTrackDialog::FromTrackDialog(SailonlineUi* pui, TrackCatalogue& catalogue)
+    : FromTrackDialogBase(pui), m_catalogue(catalogue) {
+  m_ptracklist->SetColumns(1);
 
-  if (!m_track_guids.empty()) {
-    m_ptracklist->Select(0);
-    m_selected_track = m_track_guids[0];
-  }
+  m_catalogue.Refresh();
+  FillTrackList();
+  if (m_catalogue.HasPending())
+    Bind(wxEVT_IDLE, &FromTrackDialog::OnIdle, this);
 }
 
 void FromTrackDialog::OnFromTrackDone(wxCommandEvent& event) {
-  if (m_ptracklist->GetSelection() != wxNOT_FOUND)
-    m_selected_track = m_track_guids[m_ptracklist->GetSelection()];
+  int selection = m_ptracklist->GetSelection();
+  if (selection != wxNOT_FOUND)
+    m_selected_track = m_catalogue.GetEntry(m_visible[selection]).m_guid;
 
   Hide();
-  SetReturnCode(wxID_OK);
+  SetReturnCode(m_selected_track.IsEmpty() ? wxID_CANCEL : wxID_OK);
+}
+
+void FromTrackDialog::OnFilterText(wxCommandEvent& event) { FillTrackList(); }
+
+void FromTrackDialog::OnResetAll(wxCommandEvent& event) {
+  m_pfilter->Clear();  // Refills the list
+}
+
+void FromTrackDialog::OnIdle(wxIdleEvent& event) {
+  wxStopWatch watch;
+  bool more = true;
+  while (more && watch.Time() < kIdleBudget) more = m_catalogue.LoadNext();
+  FillTrackList();
+
+  if (more)
+    event.RequestMore();
+  else
+    Unbind(wxEVT_IDLE, &FromTrackDialog::OnIdle, this);
+}
+
+void FromTrackDialog::FillTrackList() {
+  // Keep the selection while tracks are loaded or filtered
+  wxString selected;
+  int selection = m_ptracklist->GetSelection();
+  if (selection != wxNOT_FOUND)
+    selected = m_catalogue.GetEntry(m_visible[selection]).m_guid;
+
+  wxString filter = m_pfilter->GetValue().Lower();
+  wxArrayString labels;
+  m_visible.clear();
+  selection = wxNOT_FOUND;
+  for (size_t i = 0; i < m_catalogue.GetCount(); ++i) {
+    const auto& entry = m_catalogue.GetEntry(i);
+    if (!filter.IsEmpty() && !entry.m_name.Lower().Contains(filter)) continue;
+
+    if (entry.m_guid == selected) selection = static_cast<int>(labels.size());
+    labels.Add(TrackCatalogue::GetLabel(entry));
+    m_visible.push_back(i);
+  }
+
+  m_ptracklist->Freeze();
+  m_ptracklist->Set(labels);
+  if (selection != wxNOT_FOUND)
+    m_ptracklist->SetSelection(selection);
+  else if (!labels.IsEmpty())
+    m_ptracklist->SetSelection(0);
+  m_ptracklist->Thaw();
 }
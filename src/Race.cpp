@@ -17,108 +17,41 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  ***************************************************************************/
 
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <ctime>
 
 #include <wx/wx.h>
 
 #include <curl/curl.h>
 
-#include <pugixml.hpp>
-
 #include "sailonline_pi.h"
+#include "ClockSync.h"
 #include "Sailonline.h"
 #include "Race.h"
 #include "SolApi.h"
+#include "DcFile.h"
+#include "DcModel.h"
+#include "DcSync.h"
+#include "DcTiming.h"
+#include "DcUploader.h"
+#include "Geodesy.h"
+#include "Performance.h"
+#include "Robustness.h"
+#include "Router.h"
+#include "SolFile.h"
+#include "SolHttp.h"
+#include "SolTime.h"
+#include "StartSweep.h"
+#include "ThreadPool.h"
+#include "WeatherPoller.h"
+#include "WindGrid.h"
 
 Race::Race(sailonline_pi& plugin) : m_sailonline_pi(plugin) {}
 
 Race::~Race() {}
 
-namespace {
-    // Constants local to this file
-    /// Use this to approximate zero TWA
-    static constexpr double kTwaZero = 1E-3;
-}
-
-namespace {
-// TODO duplicate code with WR plugin
-
-// Performance loss is half the boat speed after the tack/jibe, in percent.
-double get_performance_loss_tack_jibe(const double stw) {
-  return 0.5 * stw / 100.0;
-}
-
-// Performance loss is ca. 0.07% per degree
-// Assumes that first_twa and next_twa have the same sign
-double get_performance_loss_course_change(const double first_twa,
-                                          const double next_twa) {
-  return std::fabs(next_twa - first_twa) / 180.0 * M_PI / 25.0;
-}
-
-double get_performance(const double performance, const double theoretical_stw,
-                       const double first_twa, const double next_twa) {
-  if (performance < 0.93) return performance;
-
-  if (first_twa * next_twa > 0) {
-    // Course change
-    return performance -
-           get_performance_loss_course_change(first_twa, next_twa);
-  } else {
-    // Tack or jibe
-    return performance -
-           get_performance_loss_tack_jibe(theoretical_stw * performance);
-  }
-}
-
-double get_recovery_step(const double performance, const double step_seconds,
-                         const double stw) {
-  return std::min(1.0, performance + step_seconds * 3.0 / (20.0 * stw) / 100.0);
-}
-
-double get_recovery(const double performance, const double time_seconds,
-                    const double theoretical_stw) {
-  if (performance >= 1.0) return 1.0;
-
-  std::cout << "Recovery from " << performance << " at " << theoretical_stw
-            << " kn in " << time_seconds << " s" << std::endl;
-
-  double jump =
-      std::min(time_seconds, 30.0);  // TODO Find correct value for jump
-  double current_stw = theoretical_stw * performance;
-  double newperformance = performance;
-  double current_time;
-
-  // TODO Find closed formula for this
-  for (current_time = jump; current_time <= time_seconds;
-       current_time += jump) {
-    newperformance = get_recovery_step(newperformance, jump, current_stw);
-    if (newperformance >= 1.0) return 1.0;
-
-    current_stw = theoretical_stw * newperformance;
-  }
-
-  // Remaining fractional jump
-  double remainder = time_seconds - current_time;
-  if (remainder > 0.0)
-    return get_recovery_step(newperformance, remainder, current_stw);
-
-  return newperformance;
-}
-}  // namespace
-
-Dc::Dc(const wxDateTime& timestamp, const double lat_start,
-       const double lon_start, const double course, const bool is_twa)
-    : m_timestamp(timestamp),
-      m_lat_start(lat_start),
-      m_lon_start(lon_start),
-      m_is_twa(is_twa) {
-  if (m_is_twa)
-    m_twa = course;
-  else
-    m_course = course;
-}
-
 std::vector<std::string> Race::GetErrors() {
   std::vector<std::string> result;
   std::swap(m_errors, result);
@@ -158,8 +91,13 @@ static size_t curl_write_cb(void* contents, size_t size, size_t nmemb,
   data->append(static_cast<const char*>(contents), realsize);
   return realsize;
 }
+
 }  // namespace
 
+ClockSync& Race::GetClock() const {
+  return *m_sailonline_pi.GetSol()->GetClock();
+}
+
 bool Race::CallCurl(CURL* curl) {
   CURLcode result = curl_easy_perform(curl);
   if (result != CURLE_OK) {
@@ -170,15 +108,32 @@ bool Race::CallCurl(CURL* curl) {
   return true;
 }
 
+bool Race::Download(const std::string& url, std::string& data) {
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return false;
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_cb);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&data);
+  bool success = CallCurl(curl);
+  curl_easy_cleanup(curl);
+  return success;
+}
+
 std::string Race::SetPlaceholders(const std::string& input) const {
   // TODO Should this map be a member of class Race?
-  static std::map<std::string, std::string> placeholders{
+  // Note: Not static, races are prefetched concurrently
+  const std::map<std::string, std::string> placeholders{
       {"$$password", "21shukur%3AGozorI21"},
       {"$$username", "Ibis"},
-      {"$$racenumber", ""},
-      {"$$token", ""}};
-  placeholders["$$racenumber"] = m_id;
-  placeholders["$$token"] = m_sol_token;
+      {"$$racenumber", m_id},
+      {"$$token", m_sol_token}};
 
   std::string result = input;
 
@@ -201,13 +156,9 @@ bool Race::Login() {
   // accessible
   // Note: OCPN_postDataHttp() does not handle cookies
   // Therefore we must use another method
+  // Note: curl_global_init() is called by class Sailonline, because it is not
+  // thread safe
   wxLogMessage("Logging into race %s", m_id);
-  CURLcode result = curl_global_init(CURL_GLOBAL_ALL);
-  if (result != CURLE_OK) {
-    m_errors.emplace_back("Curl error: " + std::to_string(result));
-    return false;
-  }
-
   CURL* curl = curl_easy_init();
   if (curl == nullptr) {
     m_errors.emplace_back("Curl error: curl_easy_init() failed");
@@ -286,12 +237,6 @@ wxString Race::GetRaceInfo() {
   }
 
   wxLogMessage("Downloading auth_raceinfo_%s.xml", m_id);
-  CURLcode cresult = curl_global_init(CURL_GLOBAL_ALL);
-  if (cresult != CURLE_OK) {
-    m_errors.emplace_back("Curl error: " + std::to_string(cresult));
-    return result;
-  }
-
   CURL* curl = curl_easy_init();
   if (curl == nullptr) {
     m_errors.emplace_back("Curl error: curl_easy_init() failed");
@@ -325,6 +270,7 @@ wxString Race::GetRaceInfo() {
   }
   raceinfo_file.Write(pagedata);
   raceinfo_file.Close();
+  result = pagedata;
   wxLogMessage("Cached raceinfo to auth_raceinfo_%s.xml", m_id.c_str());
 
   // Available information
@@ -357,125 +303,424 @@ wxString Race::GetRaceInfo() {
   return result;
 }
 
+bool Race::GetRaceInfo(SolXml::RaceInfo& info) {
+  if (m_has_raceinfo) {
+    info = m_raceinfo;
+    return true;
+  }
+
+  std::string error;
+  if (!SolXml::ParseRaceInfo(GetRaceInfo().ToStdString(), info, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  m_raceinfo = info;
+  m_has_raceinfo = true;
+  return true;
+}
+
+bool Race::DownloadFleet(const std::string& url) {
+  if (url.empty()) {
+    m_errors.emplace_back("No fleet data URL for race " + m_id);
+    return false;
+  }
+
+  wxLogMessage("Downloading fleet data of race %s", m_id);
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return false;
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  std::string pagedata;
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_cb);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&pagedata);
+  bool success = CallCurl(curl);
+  curl_easy_cleanup(curl);
+  if (!success) return false;
+  if (pagedata == "Bad token") {
+    m_errors.emplace_back("Race token is invalid. Try logging in again");
+    return false;
+  }
+
+  // Stored as served, see GetRaceInfo()
+  wxFileName fleet =
+      m_sailonline_pi.GetDataDir(wxString::Format("Race_%s", m_id.c_str()));
+  fleet.SetFullName(wxString::Format("race_%s.xml", m_id.c_str()));
+  wxFile fleet_file(fleet.GetFullPath(), wxFile::write);
+  if (fleet_file.Error() ||
+      !fleet_file.Write(pagedata.data(), pagedata.size())) {
+    m_errors.emplace_back("Could not write to race_" + m_id + ".xml");
+    return false;
+  }
+
+  wxLogMessage("Cached fleet data to race_%s.xml", m_id.c_str());
+  return true;
+}
+
+bool Race::Prefetch(bool fleet) {
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info) || !DownloadPolar()) return false;
+
+  if (fleet) {
+    // A cached race XML may contain an outdated token
+    Login();
+    std::string url = info.m_url;
+    if (!m_sol_token.empty())
+      url = url.substr(0, url.find('?')) + "?token=" + m_sol_token;
+    if (!DownloadFleet(url)) return false;
+  }
+
+  return true;
+}
+
 bool Race::DownloadPolar() {
-  pugi::xml_document race_doc;
-  auto status = race_doc.load_string(GetRaceInfo());
-  if (!status) {
-    m_errors.emplace_back("Could not parse race file: %s",
-                          status.description());
-    return false;
-  }
-
-  // Get boat polar
-  // TWS: Space-separated list of true wind speeds (columns, integer, knots)
-  // TWA: Space-separated list of true wind angles (rows, integer, degrees)
-  // BS: Semicolon-separated list of space-separated lists of wind speeds
-  // (float, m/s)
-  pugi::xml_node node_name = race_doc.select_node("/race/boat/vpp/name").node();
-  pugi::xml_node node_tws =
-      race_doc.select_node("/race/boat/vpp/tws_splined").node();
-  pugi::xml_node node_twa =
-      race_doc.select_node("/race/boat/vpp/twa_splined").node();
-  pugi::xml_node node_bs =
-      race_doc.select_node("/race/boat/vpp/bs_splined").node();
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+
+  // The binary cache is derived from the cached race XML, so it is valid as
+  // long as that exists
+  wxFileName polar_cache =
+      m_sailonline_pi.GetDataDir(wxString::Format("Race_%s", m_id.c_str()));
+  polar_cache.SetFullName("polar.bin");
+  if (m_polar.IsEmpty() && polar_cache.FileExists() &&
+      !m_polar.LoadBinary(polar_cache.GetFullPath().ToStdString()))
+    m_polar.GetErrors();  // Parse again below
+  if (m_polar.IsEmpty()) {
+    if (!m_polar.Parse(info.m_vpp)) {
+      for (auto& e : m_polar.GetErrors()) m_errors.emplace_back(std::move(e));
+      return false;
+    }
+    if (!m_polar.SaveBinary(polar_cache.GetFullPath().ToStdString()))
+      for (auto& e : m_polar.GetErrors()) wxLogMessage("%s", e.c_str());
+  }
 
   // Write polar to .csv file for import into weather routing plugin
-  std::string polar_name(node_name.first_child().value());
+  std::string polar_name(info.m_vpp.m_name);
   std::replace(polar_name.begin(), polar_name.end(), ' ', '_');
   wxFileName download_target = m_sailonline_pi.GetDataDir("Polar");
   download_target.SetFullName(
       wxString::Format("SOL_%s_polar.csv", polar_name.c_str()));
   wxLogMessage("Writing boat polar to %s", download_target.GetFullPath());
-  wxFile polar_file(download_target.GetFullPath(), wxFile::write);
-  if (polar_file.Error()) {
-    m_errors.emplace_back("Could not write to polar file");
+  if (!m_polar.WriteCsv(download_target.GetFullPath().ToStdString())) {
+    for (auto& e : m_polar.GetErrors()) m_errors.emplace_back(std::move(e));
     return false;
   }
 
-  polar_file.Write("twa/tws;");
-  std::stringstream tws_stream(node_tws.first_child().value());
-  unsigned tws;
-  while (tws_stream >> tws) {
-    if (tws_stream.bad()) {
-      m_errors.emplace_back(
-          "Format error in TWS data, wind speed is not a valid integer");
-      return false;
-    }
-    polar_file.Write(std::to_string(
-        tws * 3600.0 / 1852.0));  // TODO is this constant defined somewhere?
-    if (!tws_stream.eof()) polar_file.Write(";");
+  m_polarfile = download_target.GetFullName();
+  wxLogMessage("Saved polar data to %s", download_target.GetFullPath());
+  return true;
+}
+
+std::string Race::GetWeatherInfoUrl() {
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return "";
+  if (info.m_weatherurl.empty()) {
+    m_errors.emplace_back("No weather URL for race " + m_id);
+    return "";
   }
-  polar_file.Write("\n");
 
-  std::stringstream twa_stream(node_twa.first_child().value());
-  std::stringstream bss_stream(node_bs.first_child().value());
-  std::string twa;
+  // A cached race XML may contain an outdated token
+  Login();
+  std::string url = info.m_weatherurl;
+  if (!m_sol_token.empty())
+    url = url.substr(0, url.find('?')) + "?token=" + m_sol_token;
 
-  while (twa_stream >> twa) {
-    std::string bs_line;
-    if (!std::getline(bss_stream, bs_line, ';')) {
-      m_errors.emplace_back(
-          "Format error in TWA data, could not read next set of wind angles");
-      return false;
-    }
+  return url;
+}
+
+std::string Race::GetCacheDir() const {
+  return m_sailonline_pi
+      .GetDataDir(wxString::Format("Race_%s", m_id.c_str()))
+      .GetPath()
+      .ToStdString();
+}
+
+bool Race::DownloadWeather() {
+  std::string url = GetWeatherInfoUrl();
+  if (url.empty()) return false;
 
-    polar_file.Write(twa);
-    polar_file.Write(";");
-    std::replace(bs_line.begin(), bs_line.end(), ' ', ';');
-    polar_file.Write(bs_line);
-    polar_file.Write("\n");
+  std::string text, error;
+  SolXml::WeatherInfo info;
+  if (!Download(url, text)) return false;
+  if (!SolXml::ParseWeatherInfo(text, info, error)) {
+    m_errors.emplace_back(error);
+    return false;
   }
+  if (m_weather != nullptr && info.m_url == m_weather_url) return true;
 
-  polar_file.Close();
-  m_polarfile = download_target.GetFullName();
-  wxLogMessage("Saved polar data to %s", download_target.GetFullPath());
+  std::vector<std::string> errors;
+  auto weather = WeatherPoller::LoadForecast(info.m_url, GetCacheDir(), errors);
+  if (weather == nullptr) {
+    for (auto& e : errors) m_errors.emplace_back(std::move(e));
+    return false;
+  }
+  for (const auto& e : errors) wxLogMessage("%s", e.c_str());
+
+  SetWeather(info, std::move(weather));
   return true;
 }
 
+void Race::SetWeather(const SolXml::WeatherInfo& info,
+                      std::shared_ptr<const WindGrid> weather) {
+  m_weather = std::move(weather);
+  m_weather_url = info.m_url;
+  wxLogMessage("Forecast of race %s from %s, %s to %s", m_id,
+               SolTime::FormatUtc(info.m_time),
+               SolTime::FormatUtc(m_weather->GetStartTime()),
+               SolTime::FormatUtc(m_weather->GetEndTime()));
+
+  // Only the DCs still to come are sailed in the new forecast
+  std::time_t now = m_has_boat_state ? m_boat_state.m_time : GetClock().Now();
+  auto first = std::find_if(m_dcs.begin(), m_dcs.end(),
+                            [&](const Dc& dc) { return dc.m_timestamp > now; });
+  DcModel model = GetModel();
+  model.EnrichDcs(m_dcs, first);
+
+  DcModel::Anchor anchor;
+  if (GetAnchor(anchor)) m_drift_monitor.SetPlan(model, m_dcs, anchor);
+  UpdateLedger(model);
+}
+
 bool Race::DownloadWaypoints() {
-  pugi::xml_document race_doc;
-  auto status = race_doc.load_string(GetRaceInfo());
-  if (!status) {
-    m_errors.emplace_back("Could not parse race file: %s",
-                          status.description());
-    return false;
-  }
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
 
   // Get waypoints
   m_waypoints.clear();
 
-  pugi::xml_node node_course = race_doc.select_node("/race/course").node();
-  for (pugi::xml_node node_wp = node_course.first_child(); node_wp != nullptr;
-       node_wp = node_wp.next_sibling()) {
-    if (strcmp(node_wp.name(), "waypoint") == 0) {
-      std::shared_ptr<PlugIn_Waypoint> wp = std::make_shared<PlugIn_Waypoint>();
-
-      for (pugi::xml_node node_wp_child = node_wp.first_child();
-           node_wp_child != nullptr;
-           node_wp_child = node_wp_child.next_sibling()) {
-        if (strcmp(node_wp_child.name(), "order") == 0)
-          wp->m_GUID = wxString::Format("SOL_%s_%s", m_id,
-                                        node_wp_child.first_child().value());
-        else if (strcmp(node_wp_child.name(), "name") == 0)
-          wp->m_MarkName = wxString(node_wp_child.first_child().value()).Trim();
-        else if (strcmp(node_wp_child.name(), "lon") == 0) {
-          double lon = NAN;
-          if (wxString(node_wp_child.first_child().value()).ToDouble(&lon))
-            wp->m_lon = lon;
-        } else if (strcmp(node_wp_child.name(), "lat") == 0) {
-          double lat = NAN;
-          if (wxString(node_wp_child.first_child().value()).ToDouble(&lat))
-            wp->m_lat = lat;
-        }
-      }
+  for (const auto& course_wp : info.m_course) {
+    std::shared_ptr<PlugIn_Waypoint> wp = std::make_shared<PlugIn_Waypoint>();
+    wp->m_GUID = wxString::Format("SOL_%s_%s", m_id, course_wp.m_order);
+    wp->m_MarkName = course_wp.m_name;
+    if (!std::isnan(course_wp.m_lat)) wp->m_lat = course_wp.m_lat;
+    if (!std::isnan(course_wp.m_lon)) wp->m_lon = course_wp.m_lon;
+
+    m_waypoints.emplace_back(wp);
 
-      m_waypoints.emplace_back(wp);
+    // Add permanent waypoint to main application. Note: data is copied
+    if (!UpdateSingleWaypoint(wp.get())) AddSingleWaypoint(wp.get(), true);
+  }
+
+  return true;
+}
 
-        // Add permanent waypoint to main application. Note: data is copied
-        if (!UpdateSingleWaypoint(wp.get())) AddSingleWaypoint(wp.get(), true);
+bool Race::DownloadDcs() {
+  wxFileName cache =
+      m_sailonline_pi.GetDataDir(wxString::Format("Race_%s", m_id.c_str()));
+  cache.SetFullName("dcs.xml");
+  std::string cache_path = cache.GetFullPath().ToStdString();
+  std::string error;
+
+  // The last server state survives restarts, and shows the DCs until the
+  // download is done
+  if (!m_has_server_dcs) {
+    std::string xml;
+    if (SolFile::Read(cache_path, xml) &&
+        SolXml::ParseDcList(xml, m_server_dcs, error)) {
+      auto first = DcSync::Apply(DcSync::Diff({}, m_server_dcs), m_dcs);
+      GetModel().EnrichDcs(m_dcs, first);
+      if (first != m_dcs.end()) CommitPlan();
+      m_has_server_dcs = true;
     }
   }
 
+  Login();
+  if (m_sol_token.empty()) {
+    m_errors.emplace_back("Not logged into race " + m_id +
+                          ", did you register?");
+    return false;
+  }
+
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return false;
+  }
+
+  std::string url = SetPlaceholders(SolApi::kSolDcListUrl);
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  // Compressed if the server supports it
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+  // Nothing but the status is transferred if the list is unchanged
+  struct curl_slist* headers = nullptr;
+  if (m_has_server_dcs && !m_server_dcs_etag.empty())
+    headers = curl_slist_append(
+        headers, ("If-None-Match: " + m_server_dcs_etag).c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  SolHttp::Headers response_headers;
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, SolHttp::HeaderCallback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)&response_headers);
+  std::string pagedata;
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_cb);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&pagedata);
+  double local_start = ClockSync::LocalNow();
+  bool success = CallCurl(curl);
+  if (success)
+    SolHttp::SampleClock(curl, local_start, response_headers, GetClock());
+  long status = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+  curl_easy_cleanup(curl);
+  curl_slist_free_all(headers);
+  if (!success) return false;
+
+  if (status == 304) {
+    wxLogMessage("DCs of race %s are unchanged", m_id);
+    return true;
+  }
+  if (pagedata == "Bad token") {
+    m_errors.emplace_back("Race token is invalid. Try logging in again");
+    return false;
+  }
+
+  std::vector<SolXml::ServerDc> server_dcs;
+  if (!SolXml::ParseDcList(pagedata, server_dcs, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  // Only the changed DCs and the ones after them are enriched again
+  auto changes = DcSync::Diff(m_server_dcs, server_dcs);
+  auto first = DcSync::Apply(changes, m_dcs);
+  GetModel().EnrichDcs(m_dcs, first);
+  if (first != m_dcs.end()) CommitPlan();
+  wxLogMessage("%d DCs of race %s changed on the server",
+               static_cast<int>(changes.size()), m_id);
+
+  m_server_dcs = std::move(server_dcs);
+  m_server_dcs_etag = response_headers.m_etag;
+  m_has_server_dcs = true;
+  if (!SolFile::WriteAtomic(cache_path, pagedata, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+std::string Race::GetBoatUrl() {
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return "";
+  if (info.m_boaturl.empty())
+    m_errors.emplace_back("No boat state URL for race " + m_id);
+
+  return info.m_boaturl;
+}
+
+void Race::SetBoatState(const SolXml::BoatState& state) {
+  m_boat_state = state;
+  m_has_boat_state = true;
+
+  DcModel model = GetModel();
+  DcModel::Anchor anchor;
+  GetAnchor(anchor);
+  m_drift = m_drift_monitor.Update(model, m_dcs, anchor);
+  if (m_drift.m_exceeded)
+    wxLogMessage("Boat of race %s is %.2f nm off the plan, performance %+.3f",
+                 m_id, m_drift.m_distance, m_drift.m_performance);
+
+  // The DCs before the boat state are history
+  auto first = std::find_if(m_dcs.begin(), m_dcs.end(), [&](const Dc& dc) {
+    return dc.m_timestamp > state.m_time;
+  });
+  model.EnrichDcs(m_dcs, first);
+}
+
+bool Race::GetPlannedDcs(std::time_t now,
+                         std::vector<SolXml::ServerDc>& planned) {
+  std::string error;
+  if (!DcSync::ToServer(m_dcs, now, planned, error)) {
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  return true;
+}
+
+bool Race::PrepareUpload() {
+  // The IDs of the server's DCs are needed to change them
+  if (!m_has_server_dcs) {
+    m_errors.emplace_back("DCs of race " + m_id + " were not downloaded yet");
+    return false;
+  }
+
+  // The executed DCs stay on the server, only the future ones are changed
+  std::time_t now = GetClock().Now();
+  std::vector<SolXml::ServerDc> planned;
+  if (!GetPlannedDcs(now, planned)) return false;
+
+  if (m_uploader == nullptr)
+    m_uploader = std::make_shared<DcUploader>(
+        m_sailonline_pi.GetSol()->GetClock());
+  bool success = m_uploader->Prepare(
+      m_server_dcs, planned, now, SetPlaceholders(SolApi::kSolDcAddUrl),
+      SetPlaceholders(SolApi::kSolDcDeleteUrl));
+  for (auto& e : m_uploader->GetErrors()) m_errors.emplace_back(std::move(e));
+
+  return success;
+}
+
+void Race::WarmUpUpload(
+    std::function<void(const std::vector<std::string>& errors)> handler) {
+  if (m_uploader == nullptr)
+    m_uploader = std::make_shared<DcUploader>(
+        m_sailonline_pi.GetSol()->GetClock());
+  m_uploader->WarmUp(SetPlaceholders(SolApi::kSolDcListUrl),
+                     std::move(handler));
+}
+
+bool Race::UploadDcs() {
+  auto start = std::chrono::steady_clock::now();
+
+  // Usually prepared while the DCs were edited
+  std::vector<SolXml::ServerDc> planned;
+  if (!GetPlannedDcs(GetClock().Now(), planned)) return false;
+  if (!m_has_server_dcs && !DownloadDcs()) return false;
+  if ((m_uploader == nullptr || !m_uploader->IsPrepared(planned)) &&
+      !PrepareUpload())
+    return false;
+  if (m_uploader->GetRequestCount() == 0) {
+    wxLogMessage("DCs of race %s are up to date on the server", m_id);
+    return true;
+  }
+
+  // Read back, the server state is unknown after a failure as well
+  std::time_t now = GetClock().Now();
+  bool sent = m_uploader->Send(now);
+  std::string xml;
+  bool read_back =
+      m_uploader->Get(SetPlaceholders(SolApi::kSolDcListUrl), xml);
+  for (auto& e : m_uploader->GetErrors()) m_errors.emplace_back(std::move(e));
+  std::vector<SolXml::ServerDc> server_dcs;
+  std::string error;
+  if (!read_back || !SolXml::ParseDcList(xml, server_dcs, error)) {
+    if (!error.empty()) m_errors.emplace_back(error);
+    m_has_server_dcs = false;
+    return false;
+  }
+  m_server_dcs = std::move(server_dcs);
+  m_server_dcs_etag.clear();
+  if (!sent) return false;
+
+  // Confirmed if the server has exactly the planned future DCs
+  auto differences = DcSync::DiffUpload(m_server_dcs, planned, now);
+  m_upload_latency = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  if (!differences.empty()) {
+    m_errors.emplace_back(std::to_string(differences.size()) +
+                          " DCs differ on the server after the upload");
+    return false;
+  }
+
+  wxLogMessage("DCs of race %s uploaded and confirmed in %.0f ms", m_id,
+               m_upload_latency);
   return true;
 }
 
@@ -485,11 +730,34 @@ const std::list<Dc>& Race::GetDcs() const { return m_dcs; }
 
 std::list<Dc>& Race::GetDcs() { return m_dcs; }
 
-std::pair<double, double> Race::GetWindData(const wxDateTime& t, double lat,
+std::pair<double, double> Race::GetWindData(std::time_t t, double lat,
                                             double lon) const {
+  if (m_weather != nullptr) {
+    auto wind = m_weather->GetWindData(t, lat, lon);
+    if (wind.first >= 0.0) return wind;
+  }
+
+  return GetGribWindData(t, lat, lon);
+}
+
+void Race::GetWindDataBatch(size_t n, const std::time_t* t, const double* lat,
+                            const double* lon, double* tws,
+                            double* twd) const {
+  if (m_weather != nullptr)
+    m_weather->GetWindDataBatch(n, t, lat, lon, tws, twd);
+  else
+    std::fill(tws, tws + n, -1.0);
+
+  for (size_t i = 0; i < n; ++i)
+    if (tws[i] < 0.0)
+      std::tie(tws[i], twd[i]) = GetGribWindData(t[i], lat[i], lon[i]);
+}
+
+std::pair<double, double> Race::GetGribWindData(std::time_t t, double lat,
+                                                double lon) const {
   Json::Value v;
   Json::FastWriter writer;
-  wxDateTime time = t.FromUTC();
+  wxDateTime time = wxDateTime(t).FromUTC();
   if (!time.IsValid()) return {-1.0, -1.0};
 
   v["Day"] = time.GetDay();
@@ -518,7 +786,7 @@ std::pair<double, double> Race::GetWindData(const wxDateTime& t, double lat,
 }
 
 double Race::GetSpeedThroughWater(double tws, double twa) const {
-  if (std::fabs(twa) <= kTwaZero) return 0.0;
+  if (std::fabs(twa) <= Performance::kTwaZero) return 0.0;
 
   Json::Value v;
   Json::FastWriter writer;
@@ -569,277 +837,352 @@ std::pair<double, double> Race::GetBoatOptimalAngles(double tws) const {
   return {-1.0, -1.0};
 }
 
-void Race::SimplifyDcs() {
-  if (m_dcs.size() < 2) return;
-
-  // TODO This must use the functionality already implemented in WR plugin to
-  // simplify the route
-
-  // Current leg is from first_dc to last_dc
-  auto first_dc = m_dcs.begin();  // First DC of a leg
-  auto second_dc =
-      first_dc;  // Required because std::list does not allow first_dc + 1
-  ++second_dc;
-  auto last_dc = m_dcs.begin();  // Last DC that was investigated
-
-  for (auto dc = second_dc; dc != m_dcs.end();) {
-    double diff_course = std::fabs(dc->m_course - first_dc->m_course);
-    double diff_twa = std::fabs(dc->m_twa - first_dc->m_twa);
-    if (diff_course > 360.0) diff_course -= 360.0;
-    if (diff_twa > 360.0) diff_twa -= 360.0;
-
-    // Check for minimal course or twa changes and delete unnecessary waypoints
-    // TODO Make limits for course/twa change configurable and maybe depend on
-    // distance between waypoints (how detailed was the WR?)
-    // TODO No land collision check!!!
-    wxLogMessage(
-        "First DC: %3.3f, TWA %3.3f, last DC: %3.3f, TWA %3.3f, this DC: "
-        "%3.3f, TWA %3.3f",
-        first_dc->m_course, first_dc->m_twa, last_dc->m_course, last_dc->m_twa,
-        dc->m_course, dc->m_twa);
-
-    if (diff_course < 2.0 && (!first_dc->m_is_twa || first_dc == last_dc)) {
-      wxLogMessage("Continuing current leg because of minimal course change");
-      first_dc->m_is_twa = false;
-      if (last_dc != first_dc)
-        last_dc = m_dcs.erase(last_dc);
-      else
-        last_dc = dc;
-      dc = last_dc;
-      ++dc;
-    } else if (diff_twa < 1.0 && (first_dc->m_is_twa || first_dc == last_dc)) {
-      wxLogMessage("Continuing current leg because of minimal twa change");
-      first_dc->m_is_twa = true;
-      if (last_dc != first_dc)
-        last_dc = m_dcs.erase(last_dc);
-      else
-        last_dc = dc;
-      dc = last_dc;
-      ++dc;
-    } else {
-      // Calculate new course / TWA
-      if (first_dc != last_dc) {
-        first_dc->m_twa =
-            0.5 *
-            (first_dc->m_twa +
-             last_dc
-                 ->m_twa);  // TODO calculate exact twa that will bring us from
-                            // start to end waypoint when course is finalized
-        double new_dist;
-        DistanceBearingMercator_Plugin(
-            last_dc->m_lat_start, last_dc->m_lon_start, first_dc->m_lat_start,
-            first_dc->m_lon_start, &first_dc->m_course, &new_dist);
-        wxLogMessage("Wrote DC: %3.3f, TWA %3.3f", first_dc->m_course,
-                     first_dc->m_twa);
-        first_dc = last_dc;
-        // Note: dc must not be incremented, leg between first_dc and dc has not
-        // been investigated yet
-      } else {
-        wxLogMessage("Wrote DC: %3.3f, TWA %3.3f", first_dc->m_course,
-                     first_dc->m_twa);
-        first_dc = dc;
-        last_dc = dc;
-        ++dc;
-      }
-    }
+void Race::CompileDcs(const std::vector<TrackPoint>& route) {
+  GetModel().CompileDcs(route, DcModel::kRouteTolerance, m_dcs);
+}
+
+bool Race::GetAnchor(DcModel::Anchor& anchor) const {
+  if (!m_has_boat_state) return false;
+
+  const auto& state = m_boat_state;
+  double twd = GetWindData(state.m_time, state.m_lat, state.m_lon).second;
+  double course = state.m_is_twa ? twd - state.m_value : state.m_value;
+  double twa = state.m_is_twa ? state.m_value : twd - course;
+  course = std::fmod(course + 360.0, 360.0);
+  if (twa < -180.0)
+    twa += 360.0;
+  else if (twa > 180.0)
+    twa -= 360.0;
+  anchor = {state.m_time, state.m_lat, state.m_lon, course, twa,
+            state.m_is_twa, state.m_performance};
+  return true;
+}
+
+DcModel Race::GetModel() const {
+  DcModel model(*this, *this);
+  DcModel::Anchor anchor;
+  if (GetAnchor(anchor)) model.SetAnchor(anchor);
+
+  return model;
+}
+
+void Race::EnrichDcs() {
+  DcModel model = GetModel();
+  model.EnrichDcs(m_dcs);
+
+  // Changed DCs or wind make a new plan
+  DcModel::Anchor anchor;
+  if (GetAnchor(anchor)) m_drift_monitor.SetPlan(model, m_dcs, anchor);
+  UpdateLedger(model);
+  CommitPlan();
+}
+
+bool Race::UndoPlan() {
+  if (!m_history.Undo(m_dcs)) return false;
+
+  EnrichDcs();
+  return true;
+}
+
+bool Race::RedoPlan() {
+  if (!m_history.Redo(m_dcs)) return false;
+
+  EnrichDcs();
+  return true;
+}
+
+void Race::CopyPlan(const Race& other) {
+  m_dcs = other.m_dcs;
+  m_history = other.m_history;
+}
+
+void Race::KeepPlan(const std::string& name) { m_history.Keep(name); }
+
+bool Race::RestorePlan(size_t i) {
+  if (!m_history.Restore(i, m_dcs)) return false;
+
+  EnrichDcs();
+  return true;
+}
+
+bool Race::ComparePlans(double radius,
+                        std::vector<std::vector<double>>& etas) {
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+  std::vector<std::pair<double, double>> waypoints;
+  for (const auto& wp : info.m_course)
+    if (!std::isnan(wp.m_lat) && !std::isnan(wp.m_lon))
+      waypoints.emplace_back(wp.m_lat, wp.m_lon);
+
+  DcModel model = GetModel();
+  const auto& kept = m_history.GetKept();
+  etas.resize(kept.size() + 1);
+  PlanHistory::GetEtas(model, m_history.GetCurrent(), waypoints, radius,
+                       etas[0]);
+  for (size_t i = 0; i < kept.size(); ++i)
+    PlanHistory::GetEtas(model, kept[i].second, waypoints, radius,
+                         etas[i + 1]);
+
+  return true;
+}
+
+std::string Race::GetRaceFile(const wxString& name) const {
+  wxFileName path =
+      m_sailonline_pi.GetDataDir(wxString::Format("Race_%s", m_id.c_str()));
+  path.SetFullName(name);
+  return path.GetFullPath().ToStdString();
+}
+
+bool Race::LoadPlan() {
+  std::string data, error;
+  if (!SolFile::Read(GetRaceFile("plan.dcs"), data)) return false;
+
+  std::list<Dc> dcs;
+  if (!DcFile::ParseDcPlan(data, dcs, error)) {
+    m_errors.emplace_back("Saved plan of race " + m_id + ": " + error);
+    return false;
   }
+  m_dcs.swap(dcs);
+
+  return true;
 }
 
-namespace {
-// Course change required to reach 93% performance is ca. 100.3 degrees
-// Add 6 seconds of performance recovery at 5kn
-// TODO Make that precise in calculation below
-// TODO Give safety margin for weather beyond next forecast
-static constexpr double max_recovery = 6.0 * 3.0 / (20.0 * 5.0) / 100.0;
-static constexpr double course_change_for_max_loss =
-    (0.07 + max_recovery) * 180.0 / M_PI * 25.0;
-}  // namespace
+void Race::CommitPlan() {
+  m_history.Commit(m_dcs);
+
+  // Only the binary plan is read back, the text is for the user
+  auto writer = m_sailonline_pi.GetSol()->GetWriter();
+  writer->Write(GetRaceFile("plan.dcs"), DcFile::FormatDcPlan(m_dcs));
+  writer->Write(GetRaceFile("plan.txt"), DcFile::FormatDcList(m_dcs, true));
+  for (auto& e : writer->GetErrors()) m_errors.emplace_back(std::move(e));
+}
+
+void Race::UpdateLedger(const DcModel& model) {
+  m_ledger.Clear();
+  model.MakeTrack(m_dcs, m_ledger);
+}
+
+void Race::SimplifyDcs() { GetModel().SimplifyDcs(m_dcs); }
 
 void Race::OptimizeManeuvers() {
-  // Note: This assumes that EnrichDcs() has been called
-  // TODO If this is called twice on the same list, it will create duplicate
-  // TWAs
-  // Note: This assumes a symmetric polar throughout
-  // Note: A course change of exactly 180 degrees will be treated as a tack
-  // (not sure what SOL does)
-  // TODO Take into account that performance may not be 100% to start with
-  double first_twa = m_dcs.begin()->m_twa;
-  auto second_dc = m_dcs.begin();
-  ++second_dc;
-
-  for (auto p_dc = second_dc; p_dc != m_dcs.end(); ++p_dc) {
-    double next_twa = p_dc->m_twa;
-    double sign = first_twa > 0.0 ? 1.0 : -1.0;
-    std::cout << "      DC course" << p_dc->m_course
-              << ": Checking course change TWA=" << first_twa << " to "
-              << next_twa << std::endl;
-
-    if (first_twa * next_twa > 0) {
-      // Course change. Performance loss is ca. 0.07% per degree
-      // TODO Optimize by calculating performance recovery to reach exactly 93%
-      if (std::fabs(next_twa - first_twa) > course_change_for_max_loss) {
-        // Note: std::list::emplace() does not invalidate any iterators
-        // Note: Two seconds difference is required to preserve the order of the
-        // DCs
-        m_dcs.emplace(
-            p_dc,
-            Dc{wxDateTime(p_dc->m_timestamp).Subtract(wxTimeSpan::Seconds(2)),
-               -1.0, -1.0, first_twa + sign * course_change_for_max_loss,
-               true});
-        // ... and the existing dc finalizes the course change to next_twa
-      }
-    } else if (std::fabs(first_twa - next_twa) > 180.0) {
-      // Jibe
-      /* The performance loss for a jibe is half the boat speed after the jibe,
-       * in percent. The performance loss for a course change (without jibe) is
-       * ca. 0.07% per degree There are two possible strategies:
-       * 1. Drive performance just below the 93% limit by two course changes.
-       *    Then jibe to next_twa without further performance loss.
-       *    This only makes sense if boat speed after the jibe is greater than
-       * 14 knots, because in this case the jibe performance loss would be
-       * greater than 7%
-       * 2. Jibe to TWA 180 degrees, then harden in to next_twa
-       *    This only makes sense if the added performance loss for jibe and
-       * course change is less than the performance loss for directly jibing to
-       * next_twa
-       */
-      double stw_before_wind = GetSpeedThroughWater(p_dc->m_tws, 180.0);
-      double next_stw = GetSpeedThroughWater(p_dc->m_tws, next_twa);
-      std::cout << "Optimizing jibe, speed twa 180=" << stw_before_wind
-                << ", speed after jibe=" << next_stw << std::endl;
-
-      if (next_stw > 14.0) {
-        // Strategy 1
-        // TODO Optimize by calculating performance recovery to reach exactly
-        // 93%
-        double twa_delta = 180.0 - std::fabs(first_twa);
-        // Change course upwind (delta1), then downwind to 180 degrees (delta2):
-        // twa_delta + 2 * delta1 = course_change_for_max_loss
-        double delta1 = 0.5 * (course_change_for_max_loss - twa_delta);
-        // TODO Take into account loss in VMG due to the course changes and
-        // their duration Insert two course changes, filling only required
-        // fields
-        m_dcs.emplace(
-            p_dc,
-            Dc{wxDateTime(p_dc->m_timestamp).Subtract(wxTimeSpan::Seconds(4)),
-               -1.0, -1.0, first_twa - sign * delta1, true});
-        m_dcs.emplace(
-            p_dc,
-            Dc{wxDateTime(p_dc->m_timestamp).Subtract(wxTimeSpan::Seconds(2)),
-               -1.0, -1.0, sign * 180.0, true});
-        // ... and the existing dc finalizes the course change to next_twa
-      } else {
-        // Strategy 2
-        // Performance loss for direct jibe to next_twa
-        double loss = get_performance_loss_tack_jibe(next_stw);
-        // Performance loss for jibe to 180 degrees, then course change to
-        // next_twa
-        double loss1 = get_performance_loss_tack_jibe(stw_before_wind);
-        double loss2 =
-            get_performance_loss_course_change(180.0, std::fabs(next_twa));
-        if (loss1 + loss2 < loss) {
-          // TODO optimize this by jibing to some course between 180 degrees and
-          // next_twa
-          // TODO Take into account loss in VMG due to the course changes and
-          // their duration
-          m_dcs.emplace(
-              p_dc,
-              Dc{wxDateTime(p_dc->m_timestamp).Subtract(wxTimeSpan::Seconds(2)),
-                 -1.0, -1.0, sign * 180.0, true});
-          // ... and the existing dc finalizes the course change to next_twa
-        }
-      }
-    } else {
-      // Tack
-      /* The performance loss for a tack is half the boat speed after the tack,
-       * in percent. The performance loss for a course change (without tack) is
-       * ca. 0.07% per degree Strategy: Tack to 0 (zero boat speed) with no
-       * performance loss Change course to next_twa
-       */
-      double next_speed = GetSpeedThroughWater(p_dc->m_tws, next_twa);
-      // Performance loss for direct tack to next_twa
-      double loss1 = get_performance_loss_tack_jibe(next_speed);
-      // Performance loss for course change from 0 to next_twa
-      double loss2 = get_performance_loss_course_change(0.0, next_twa);
-      std::cout << "Optimizing tack, speed after tack=" << next_speed
-                << ", loss1=" << loss1 << ", loss2=" << loss2 << std::endl;
-      if (loss1 > loss2) {
-        m_dcs.emplace(
-            p_dc,
-            Dc{wxDateTime(p_dc->m_timestamp).Subtract(wxTimeSpan::Seconds(2)),
-               -1.0, -1.0, -sign * kTwaZero, true});
-        // ... and the existing dc finalizes the course change to next_twa
-      }
-    }
+  GetModel().OptimizeManeuvers(m_dcs);
+}
+
+bool Race::RouteCourse() {
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+
+  std::vector<std::pair<double, double>> waypoints;
+  for (const auto& wp : info.m_course)
+    if (!std::isnan(wp.m_lat) && !std::isnan(wp.m_lon))
+      waypoints.emplace_back(wp.m_lat, wp.m_lon);
+  if (waypoints.size() < 2) {
+    m_errors.emplace_back("Race " + m_id + " has no course to route");
+    return false;
+  }
+
+  std::time_t now = GetClock().Now();
+  std::time_t start;
+  if (!SolTime::ParseUtc(m_start, start) || start < now) start = now;
+  TrackPoint from{start, waypoints.front().first, waypoints.front().second};
+  waypoints.erase(waypoints.begin());
+
+  // The forecast and the polar of the race are thread safe and expand the
+  // isochrones on all cores. Messaging to the GRIB and weather routing
+  // plugins is not: without them the route is calculated on this thread
+  std::vector<RoutePoint> route;
+  std::vector<std::string> errors;
+  bool routed;
+  if (m_weather != nullptr && !m_polar.IsEmpty()) {
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    Router router(*m_weather, m_polar, RouterSettings(), &pool);
+    routed = router.Route(from, waypoints, route);
+    errors = router.GetErrors();
+  } else {
+    Router router(*this, *this, RouterSettings());
+    routed = router.Route(from, waypoints, route);
+    errors = router.GetErrors();
+  }
+  if (!routed) {
+    for (auto& e : errors) m_errors.emplace_back(std::move(e));
+    return false;
+  }
+
+  std::vector<TrackPoint> track;
+  track.reserve(route.size());
+  for (const auto& point : route)
+    track.push_back({point.m_time, point.m_lat, point.m_lon});
+  CompileDcs(track);
 
-    first_twa = next_twa;
+  return true;
+}
+
+bool Race::TestRobustness(const RobustnessSettings& settings,
+                          RobustnessResult& result) {
+  // The runs need thread safe providers: the forecast and the polar of the
+  // race instead of messaging
+  if (m_weather == nullptr || m_polar.IsEmpty()) {
+    m_errors.emplace_back("Race " + m_id +
+                          " has no forecast or polar to test the DCs with");
+    return false;
+  }
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+  std::vector<std::pair<double, double>> waypoints;
+  for (const auto& wp : info.m_course)
+    if (!std::isnan(wp.m_lat) && !std::isnan(wp.m_lon))
+      waypoints.emplace_back(wp.m_lat, wp.m_lon);
+
+  DcModel::Plan plan;
+  GetModel().MakePlan(m_dcs, plan);
+  ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  Robustness robustness(*m_weather, m_polar, settings, &pool);
+  if (!robustness.Evaluate(plan, waypoints, result)) {
+    for (auto& e : robustness.GetErrors()) m_errors.emplace_back(std::move(e));
+    return false;
   }
+
+  return true;
 }
 
-void Race::EnrichDcs() {
-  auto previous_dc = m_dcs.begin();
-
-  for (auto dc = m_dcs.begin(); dc != m_dcs.end(); ++dc) {
-    // Calculate extra values
-    if (dc->m_lat_start == -1.0 && dc != m_dcs.begin()) {
-      // DC course change optimization doesn't fill these fields
-      double dist =
-          previous_dc->m_stw *
-          (dc->m_timestamp - previous_dc->m_timestamp).GetSeconds().ToDouble() /
-          3600.0;
-      PositionBearingDistanceMercator_Plugin(
-          previous_dc->m_lat_start, previous_dc->m_lon_start,
-          previous_dc->m_course, dist, &dc->m_lat_start, &dc->m_lon_start);
-    }
+bool Race::OptimizeTiming(const DcTimingSettings& settings,
+                          DcTimingResult& result) {
+  if (m_weather == nullptr || m_polar.IsEmpty()) {
+    m_errors.emplace_back("Race " + m_id +
+                          " has no forecast or polar to optimize the DCs with");
+    return false;
+  }
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+
+  DcModel::Anchor anchor;
+  bool anchored = GetAnchor(anchor);
+  DcModel::Plan plan;
+  GetModel().MakePlan(m_dcs, plan);
+  if (plan.m_legs.size() < 2) {
+    m_errors.emplace_back("Race " + m_id + " has no DCs to optimize");
+    return false;
+  }
 
-    double twd;
-    std::tie(dc->m_tws, twd) =
-        GetWindData(dc->m_timestamp, dc->m_lat_start, dc->m_lon_start);
-    if (dc->m_is_twa) {
-      dc->m_course = twd - dc->m_twa;
-      if (dc->m_course > 360.0)
-        dc->m_course -= 360.0;
-      else if (dc->m_course < 0.0)
-        dc->m_course += 360.0;
-    } else {
-      // Get TWA from course
-      dc->m_twa = NAN;
-      if (dc->m_tws >= 0.0) {
-        dc->m_twa = twd - dc->m_course;  // positive sign: starboard tack
-        if (dc->m_twa < -180.0)
-          dc->m_twa += 360.0;
-        else if (dc->m_twa > 180.0)
-          dc->m_twa -= 360.0;
-      }
-    }
+  // The waypoint after the nearest one, unless that is the finish
+  const Dc& start = plan.m_legs.front();
+  std::vector<std::pair<double, double>> waypoints;
+  for (const auto& wp : info.m_course)
+    if (!std::isnan(wp.m_lat) && !std::isnan(wp.m_lon))
+      waypoints.emplace_back(wp.m_lat, wp.m_lon);
+  if (waypoints.empty()) {
+    m_errors.emplace_back("Race " + m_id + " has no course waypoints");
+    return false;
+  }
+  auto distance = [&](const std::pair<double, double>& wp) {
+    return Geodesy::DistanceGreatCircle(wp.first, wp.second, start.m_lat_start,
+                                        start.m_lon_start);
+  };
+  auto nearest = std::min_element(
+      waypoints.begin(), waypoints.end(),
+      [&](const auto& a, const auto& b) { return distance(a) < distance(b); });
+  auto target = std::min(nearest + 1, waypoints.end() - 1);
+
+  // Executed DCs and those too close to upload stay as they are
+  DcTimingSettings bounded = settings;
+  bounded.m_min_time = std::max(bounded.m_min_time,
+                                GetClock().Now() + DcUploader::kMinLead);
+  ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  DcTiming timing(*m_weather, m_polar, bounded, &pool);
+  if (!timing.Optimize(plan, target->first, target->second, result)) {
+    for (auto& e : timing.GetErrors()) m_errors.emplace_back(std::move(e));
+    return false;
+  }
 
-    dc->m_stw = GetSpeedThroughWater(dc->m_tws, dc->m_twa);
-    auto [max_up, max_down] = GetBoatOptimalAngles(dc->m_tws);
-    if (max_up > 180.0) max_up = 360.0 - max_up;
-    if (max_down > 180.0) max_down = 360.0 - max_down;
-    double sign = (dc->m_twa > 0 ? 1.0 : -1.0);
-    dc->m_opt_upwind = max_up * sign;
-    dc->m_opt_downwind = max_down * sign;
-    // Performance right after the course change
-    // TODO Get parent heading at begin of DC from WR
-    dc->m_perf_begin = (previous_dc->m_twa == 0.0)
-                           ? 1.0
-                           : get_performance(previous_dc->m_perf_end, dc->m_stw,
-                                             previous_dc->m_twa, dc->m_twa);
-    auto next_dc = dc;
-    ++next_dc;
-    dc->m_perf_end = (next_dc == m_dcs.end())
-                         ? 1.0
-                         : get_recovery(dc->m_perf_begin,
-                                        (next_dc->m_timestamp - dc->m_timestamp)
-                                            .GetSeconds()
-                                            .ToDouble(),
-                                        dc->m_stw);
-
-    previous_dc = dc;
+  // The legs are the DCs after the boat state, behind its current leg. The
+  // new list is built aside and replaces the old one only if they match
+  auto leg = plan.m_legs.begin();
+  if (anchored) ++leg;
+  std::list<Dc> dcs;
+  size_t planned = 0;
+  for (const auto& dc : m_dcs) {
+    if (anchored && dc.m_timestamp <= anchor.m_time)
+      dcs.push_back(dc);
+    else
+      ++planned;
   }
+  if (static_cast<size_t>(std::distance(leg, plan.m_legs.end())) != planned) {
+    m_errors.emplace_back("Optimized legs don't match the DCs of race " +
+                          m_id);
+    return false;
+  }
+  dcs.insert(dcs.end(), leg, plan.m_legs.end());
+  m_dcs = std::move(dcs);
+  EnrichDcs();
+
+  return true;
+}
+
+bool Race::SweepStart(const StartSweepSettings& settings,
+                      std::time_t window, std::vector<Departure>& departures) {
+  if (m_weather == nullptr || m_polar.IsEmpty()) {
+    m_errors.emplace_back("Race " + m_id +
+                          " has no forecast or polar to sweep the start with");
+    return false;
+  }
+  SolXml::RaceInfo info;
+  if (!GetRaceInfo(info)) return false;
+  std::vector<std::pair<double, double>> waypoints;
+  for (const auto& wp : info.m_course)
+    if (!std::isnan(wp.m_lat) && !std::isnan(wp.m_lon))
+      waypoints.emplace_back(wp.m_lat, wp.m_lon);
+  if (waypoints.size() < 2) {
+    m_errors.emplace_back("Race " + m_id + " has no course to sail");
+    return false;
+  }
+
+  std::time_t begin = GetClock().Now();
+  std::time_t start;
+  if (SolTime::ParseUtc(m_start, start) && start > begin) begin = start;
+  std::time_t end = std::min(begin + window, m_weather->GetEndTime());
+
+  ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  StartSweep sweep(*m_weather, m_polar, settings, &pool);
+  bool ok;
+  if (!m_dcs.empty()) {
+    // The DCs as planned from the start, not from the boat
+    DcModel::Plan plan;
+    DcModel(*m_weather, m_polar).MakePlan(m_dcs, plan);
+    ok = sweep.SweepDcs(plan, begin, end, waypoints.back().first,
+                        waypoints.back().second, departures);
+  } else {
+    auto [lat, lon] = waypoints.front();
+    waypoints.erase(waypoints.begin());
+    ok = sweep.SweepRoutes(lat, lon, waypoints, begin, end, departures);
+  }
+  if (!ok) {
+    for (auto& e : sweep.GetErrors()) m_errors.emplace_back(std::move(e));
+    return false;
+  }
+
+  return true;
 }
 
+namespace {
+/// Collects the track points for AddPlugInTrack()
+class PluginTrackSink : public TrackSink {
+public:
+  PluginTrackSink(PlugIn_Track& track) : m_track(track) {}
+
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {
+    // Note that pWaypointList stores pointers only, and does not manage their
+    // memory
+    PlugIn_Waypoint* pwaypoint = new PlugIn_Waypoint(
+        lat, lon, "dot", _("SOL route point"), wxEmptyString);
+    pwaypoint->m_CreateTime = wxDateTime(t);
+    m_track.pWaypointList->Append(pwaypoint);
+  }
+
+private:
+  PlugIn_Track& m_track;
+};
+}  // namespace
+
 void Race::MakeTrack() const {
   if (m_dcs.empty()) return;
 
@@ -851,92 +1194,8 @@ void Race::MakeTrack() const {
   track.m_EndString = "End";
   track.m_GUID = GetNewGUID();
 
-  double current_lat = m_dcs.front().m_lat_start;
-  double current_lon = m_dcs.front().m_lon_start;
-  double performance = 1.0;
-  double previous_twa =
-      m_dcs.front().m_twa;  // TODO Get parent heading at begin of DC from WR
-
-  // Recalculate the track from the dcs as precisely as possible
-  for (auto dc = m_dcs.begin(); dc != m_dcs.end(); ++dc) {
-    // Note that pWaypointList stores pointers only, and does not manage their
-    // memory
-    PlugIn_Waypoint* pwaypoint = new PlugIn_Waypoint(
-        current_lat, current_lon, "dot", _("SOL route point"), wxEmptyString);
-    pwaypoint->m_CreateTime = dc->m_timestamp;
-    track.pWaypointList->Append(pwaypoint);
-
-    auto [tws, twd] = GetWindData(dc->m_timestamp, current_lat, current_lon);
-    double twa;
-    double course;
-    if (dc->m_is_twa) {
-      twa = dc->m_twa;
-      course = twd - twa;
-    } else {
-      twa = twd - dc->m_course;  // positive sign: starboard tack
-      course = dc->m_course;
-    }
-    if (twa < -180.0)
-      twa += 360.0;
-    else if (twa > 180.0)
-      twa -= 360.0;
-    double theoretical_stw = GetSpeedThroughWater(tws, twa);
-
-    // Performance loss for initial course change of the Dc
-    performance =
-        get_performance(performance, theoretical_stw, previous_twa, twa);
-
-    auto next_dc = dc;
-    ++next_dc;
-    double time_seconds =
-        (next_dc != m_dcs.end())
-            ? (next_dc->m_timestamp - dc->m_timestamp).GetSeconds().ToDouble()
-            : 3600.0;  // Go on for one more hour after last Dc
-
-    // Note: Waypoints are only created at DC timestamps, not at every jump
-    double jump = std::min(time_seconds, 30.0);
-    double current_time;
-    double current_stw = theoretical_stw * performance;
-    double total_dist = 0.0;
-
-    for (current_time = jump; current_time <= time_seconds;
-         current_time += jump) {
-      // TODO TODO New wind and theoretical speed!
-
-      // The loop always calculates the performance and distance at current_time
-      if (performance < 1.0) {
-        performance = get_recovery_step(performance, jump, current_stw);
-        current_stw = theoretical_stw * performance;
-      }
-
-      // TODO It is not clear whether dist is calculated with old or new
-      // performance
-      double dist = current_stw * jump / 3600.0;
-      if (dc->m_is_twa)
-        PositionBearingDistanceMercator_Plugin(
-            current_lat, current_lon, course, dist, &current_lat, &current_lon);
-
-      total_dist += dist;
-    }
-
-    // Remaining fractional jump
-    double remainder = time_seconds - current_time;
-    if (remainder > 0.0) {
-      performance =
-          std::min(1.0, get_recovery_step(performance, remainder, current_stw));
-      double dist = theoretical_stw * performance * remainder / 3600.0;
-      if (dc->m_is_twa)
-        PositionBearingDistanceMercator_Plugin(
-            current_lat, current_lon, course, dist, &current_lat, &current_lon);
-
-      total_dist += dist;
-    }
-
-    if (!dc->m_is_twa)
-      PositionBearingDistanceMercator_Plugin(current_lat, current_lon,
-                                             dc->m_course, total_dist,
-                                             &current_lat, &current_lon);
-  }
+  PluginTrackSink sink(track);
+  GetModel().MakeTrack(m_dcs, sink);
 
   AddPlugInTrack(&track);  // Note: Contents are copied
   // The destructor does not do this
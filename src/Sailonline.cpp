@@ -17,20 +17,35 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  ***************************************************************************/
 
-#include <wx/wx.h>
+#include <algorithm>
+#include <fstream>
 
-#include <boost/algorithm/string.hpp>
+#include <wx/wx.h>
 
-#include <pugixml.hpp>
+#include <curl/curl.h>
 
 #include "sailonline_pi.h"
+#include "ClockSync.h"
 #include "Sailonline.h"
 #include "Race.h"
 #include "SolApi.h"
-
-Sailonline::Sailonline(sailonline_pi& plugin) : m_sailonline_pi(plugin) {
+#include "SolFile.h"
+#include "SolXml.h"
+#include "ThreadPool.h"
+
+Sailonline::Sailonline(sailonline_pi& plugin)
+    : m_sailonline_pi(plugin),
+      m_clock(std::make_shared<ClockSync>()),
+      m_writer(std::make_shared<SolFile::BackgroundWriter>()) {
   wxLogMessage("Initializing Sailonline");
 
+  // Once for all races, because it is not thread safe
+  CURLcode result = curl_global_init(CURL_GLOBAL_ALL);
+  if (result != CURLE_OK) {
+    m_errors.emplace_back("Curl error: " + std::to_string(result));
+    return;
+  }
+
   // Check if we are online
   if (!OCPN_isOnline()) {
     m_errors.emplace_back("No internet access");
@@ -72,54 +87,39 @@ Sailonline::Sailonline(sailonline_pi& plugin) : m_sailonline_pi(plugin) {
   }
 
   // Load racelist into xml parser
-  pugi::xml_document racelist_doc;
-  auto status = racelist_doc.load_file(download_target.GetFullPath().mb_str());
-  if (!status) {
-    wxLogError("Could not parse racelist file: %s", status.description());
+  std::ifstream racelist_file(download_target.GetFullPath().ToStdString(),
+                              std::ios::binary);
+  std::string racelist((std::istreambuf_iterator<char>(racelist_file)),
+                       std::istreambuf_iterator<char>());
+  std::vector<SolXml::RaceEntry> entries;
+  std::string error;
+  if (!SolXml::ParseRaceList(racelist, entries, error)) {
+    wxLogError(error);
     return;
   }
 
-  // Parse xml and fill list of races
+  // Fill list of races
   m_races.clear();
-  pugi::xml_node node_races = racelist_doc.child("races");
-
-  for (pugi::xml_node node_race = node_races.first_child();
-       node_race != nullptr; node_race = node_race.next_sibling()) {
-    if (strcmp(node_race.name(), "race") == 0) {
-      Race race(m_sailonline_pi);
-
-      for (pugi::xml_node node_race_child = node_race.first_child();
-           node_race_child != nullptr;
-           node_race_child = node_race_child.next_sibling()) {
-        if (strcmp(node_race_child.name(), "id") == 0) {
-          race.m_id = node_race_child.first_child().value();
-          boost::trim(race.m_id);
-        } else if (strcmp(node_race_child.name(), "name") == 0) {
-          race.m_name = node_race_child.first_child().value();
-          boost::trim(race.m_name);
-        } else if (strcmp(node_race_child.name(), "description") == 0) {
-          race.m_description = node_race_child.first_child().value();
-          boost::trim(race.m_description);
-        } else if (strcmp(node_race_child.name(), "message") == 0) {
-          race.m_message = node_race_child.first_child().value();
-          boost::trim(race.m_message);
-        } else if (strcmp(node_race_child.name(), "start_time") == 0) {
-          race.m_start = node_race_child.first_child().value();
-          boost::trim(race.m_start);
-        } else if (strcmp(node_race_child.name(), "url") == 0) {
-          race.m_url = node_race_child.first_child().value();
-          boost::trim(race.m_url);
-        }
-      }
-
-      m_races.emplace(race.m_id, std::move(race));
-    }
+  for (const auto& entry : entries) {
+    Race race(m_sailonline_pi);
+    race.m_id = entry.m_id;
+    race.m_name = entry.m_name;
+    race.m_description = entry.m_description;
+    race.m_message = entry.m_message;
+    race.m_start = entry.m_start;
+    race.m_url = entry.m_url;
+
+    m_races.emplace(race.m_id, std::move(race));
   }
 }
 
 Sailonline::~Sailonline() {
   CleanupDownload();
 
+  // Pending OnPrefetchDone() calls are discarded together with this handler
+  if (m_prefetch_thread.joinable()) m_prefetch_thread.join();
+
+  curl_global_cleanup();
 }
 
 std::unique_ptr<Race> Sailonline::GetRace(const std::string& racenumber) const {
@@ -129,6 +129,53 @@ std::unique_ptr<Race> Sailonline::GetRace(const std::string& racenumber) const {
   return std::make_unique<Race>(prace->second);
 }
 
+bool Sailonline::PrefetchRaces(bool fleet) {
+  if (m_prefetching || m_races.empty()) return false;
+  if (m_prefetch_thread.joinable()) m_prefetch_thread.join();
+
+  // The workers get copies of the races, so the GUI can go on using m_races
+  auto races = std::make_shared<std::vector<Race>>();
+  races->reserve(m_races.size());
+  // Create the cache and polar directories on the GUI thread
+  m_sailonline_pi.GetDataDir("Polar");
+  for (const auto& race : m_races) {
+    races->push_back(race.second);
+    m_sailonline_pi.GetDataDir(wxString::Format("Race_%s", race.first.c_str()));
+  }
+
+  wxLogMessage("Prefetching %u races", static_cast<unsigned>(races->size()));
+  m_prefetching = true;
+  m_prefetch_thread = std::thread([this, races, fleet]() {
+    {
+      // Each race uses its own curl handles, so the transfers of up to
+      // kPrefetchThreads races run in parallel
+      ThreadPool pool(std::min(kPrefetchThreads, races->size()) - 1);
+      pool.ParallelFor(races->size(),
+                       [&](size_t i) { (*races)[i].Prefetch(fleet); });
+    }
+
+    CallAfter([this, races]() { OnPrefetchDone(*races); });
+  });
+
+  return true;
+}
+
+void Sailonline::OnPrefetchDone(std::vector<Race>& races) {
+  for (auto& race : races) {
+    for (const auto& e : race.GetErrors())
+      m_errors.emplace_back("Race " + race.m_id + ": " + e);
+
+    std::string id = race.m_id;
+    m_races.erase(id);
+    m_races.emplace(id, race);
+  }
+
+  m_prefetching = false;
+  wxLogMessage("Prefetching races finished");
+
+  if (m_prefetch_handler) m_prefetch_handler();
+}
+
 std::vector<std::string> Sailonline::GetErrors() {
   std::vector<std::string> result;
   std::swap(m_errors, result);
@@ -17,6 +17,8 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <wx-3.2/wx/event.h>
 #include <wx/wx.h>
 #include <wx/clipbrd.h>
@@ -28,7 +30,12 @@
 #include "SailonlineUi.h"
 #include "Sailonline.h"
 #include "Race.h"
+#include "BoatPoller.h"
+#include "ClockSync.h"
+#include "DcFile.h"
 #include "FromTrackDialog.h"
+#include "SolTime.h"
+#include "WeatherPoller.h"
 
 const std::shared_ptr<Sailonline> SailonlineUi::GetSol() const {
   return m_sailonline_pi.GetSol();
@@ -66,6 +73,7 @@ SailonlineUi::SailonlineUi(wxWindow* parent, sailonline_pi& plugin)
   pconf->Read("DialogWidth", &rect.width, 800);
   pconf->Read("DialogHeight", &rect.height, 450);
   pconf->Read("DialogSplit", &sashpos, rect.width / 4);
+  pconf->Read("DcServerSync", &m_dc_server_sync, false);
   SetPosition(rect.GetPosition());
   SetInitialSize(rect.GetSize());
   m_ppanel->m_psplitter->SetSashPosition(sashpos, true);
@@ -97,6 +105,10 @@ SailonlineUi::SailonlineUi(wxWindow* parent, sailonline_pi& plugin)
   m_ppanel->m_pracelist->Connect(
       wxEVT_LIST_ITEM_SELECTED,
       wxListEventHandler(SailonlineUi::OnRaceSelected), nullptr, this);
+  m_ppanel->m_pracelist->Connect(
+      wxEVT_LIST_ITEM_RIGHT_CLICK,
+      wxListEventHandler(SailonlineUi::OnRaceListRightClick), nullptr, this);
+  GetSol()->SetPrefetchHandler([this]() { OnPrefetchDone(); });
 
   if (!GetSol()->GetRaces().empty())
     m_ppanel->m_pracelist->SetItemState(m_ppanel->m_pracelist->GetTopItem(),
@@ -121,6 +133,12 @@ SailonlineUi::SailonlineUi(wxWindow* parent, sailonline_pi& plugin)
   m_ppanel->m_pdclist->InsertColumn(5, _("Opt"));
   m_ppanel->m_pdclist->InsertColumn(6, _("Perf1"));
   m_ppanel->m_pdclist->InsertColumn(7, _("Perf2"));
+  m_ppanel->m_pdclist->InsertColumn(8, _("Loss nm"));
+  m_ppanel->m_pdclist->InsertColumn(9, _("Loss s"));
+  m_ppanel->m_pdclist->Connect(
+      wxEVT_CONTEXT_MENU,
+      wxContextMenuEventHandler(SailonlineUi::OnDcListContextMenu), nullptr,
+      this);
 
   m_ppanel->m_pbutton_downloadpolar->Connect(
       wxEVT_COMMAND_BUTTON_CLICKED,
@@ -144,14 +162,32 @@ SailonlineUi::SailonlineUi(wxWindow* parent, sailonline_pi& plugin)
   m_ppanel->m_pbutton_copydcs->Connect(
       wxEVT_COMMAND_BUTTON_CLICKED,
       wxCommandEventHandler(SailonlineUi::OnCopyDcs), nullptr, this);
+  if (!m_dc_server_sync) {
+    wxString reason = _("Not available until the DC interface of "
+                        "sailonline.org is confirmed");
+    m_ppanel->m_pbutton_download->SetToolTip(reason);
+    m_ppanel->m_pbutton_download->Disable();
+    m_ppanel->m_pbutton_upload->SetToolTip(reason);
+    m_ppanel->m_pbutton_upload->Disable();
+  }
 }
 
 SailonlineUi::~SailonlineUi() {
+  m_boat_poller.reset();
+  m_weather_poller.reset();
   std::cout << "Destructor of SailonlineUi" << std::endl;
 
   m_ppanel->m_pracelist->Disconnect(
       wxEVT_LIST_ITEM_SELECTED,
       wxListEventHandler(SailonlineUi::OnRaceSelected), nullptr, this);
+  GetSol()->SetPrefetchHandler(nullptr);
+  m_ppanel->m_pracelist->Disconnect(
+      wxEVT_LIST_ITEM_RIGHT_CLICK,
+      wxListEventHandler(SailonlineUi::OnRaceListRightClick), nullptr, this);
+  m_ppanel->m_pdclist->Disconnect(
+      wxEVT_CONTEXT_MENU,
+      wxContextMenuEventHandler(SailonlineUi::OnDcListContextMenu), nullptr,
+      this);
   m_ppanel->m_pbutton_download->Disconnect(
       wxEVT_COMMAND_BUTTON_CLICKED,
       wxCommandEventHandler(SailonlineUi::OnDcDownload), nullptr, this);
@@ -244,7 +280,11 @@ void SailonlineUi::ShowPage(const int page) {
     case 2:  // DC list
     {
       m_prace->DownloadWaypoints();
-      // m_prace->DownloadDcs();
+      // Wind data may have changed meanwhile
+      m_prace->EnrichDcs();
+      StartBoatPolling();
+      // The forecast follows in the background, the GRIB plugin until then
+      StartWeatherPolling();
       FillDcList();
 
       break;
@@ -260,14 +300,357 @@ void SailonlineUi::OnRaceSelected(wxListEvent& event) {
   if (racenumber.empty()) return;
   // TODO Error message
   std::cout << "Race selected: " << racenumber << std::endl;
+  if (m_boat_poller != nullptr) m_boat_poller->Stop();
+  if (m_weather_poller != nullptr) m_weather_poller->Stop();
   m_prace = GetSol()->GetRace(racenumber);
   if (m_prace == nullptr) return;
   // TODO Clear panel if nothing is found?
+  // The DCs of the last session, the server's follow on download
+  if (!m_prace->LoadPlan())
+    for (const auto& e : m_prace->GetErrors()) wxLogMessage("%s", e);
+
+  // Connect for the upload while the DCs are edited. Errors arriving after a
+  // change of race are dropped
+  if (m_dc_server_sync) {
+    std::string id = m_prace->m_id;
+    m_prace->WarmUpUpload([this, id](const std::vector<std::string>& errors) {
+      if (errors.empty()) return;
+      CallAfter([this, id, errors]() {
+        if (m_prace == nullptr || m_prace->m_id != id) return;
+        for (const auto& e : errors) wxLogMessage("%s", e);
+      });
+    });
+  }
 
   // Show race description
   ShowPage(0);
 }
 
+void SailonlineUi::OnRaceListRightClick(wxListEvent& event) {
+  enum { kIdPrefetch = wxID_HIGHEST + 1, kIdPrefetchFleet };
+
+  wxMenu menu;
+  menu.Append(kIdPrefetch, _("Prefetch all races"));
+  menu.Append(kIdPrefetchFleet, _("Prefetch all races with fleet data"));
+  if (GetSol()->IsPrefetching()) {
+    menu.Enable(kIdPrefetch, false);
+    menu.Enable(kIdPrefetchFleet, false);
+  }
+
+  int id = GetPopupMenuSelectionFromUser(menu);
+  if (id != kIdPrefetch && id != kIdPrefetchFleet) return;
+
+  if (GetSol()->PrefetchRaces(id == kIdPrefetchFleet))
+    SetTitle(_("Sailonline - prefetching races..."));
+}
+
+void SailonlineUi::OnDcListContextMenu(wxContextMenuEvent& event) {
+  // The actions change the DCs of the race shown on the DC page
+  enum {
+    kIdRoute = wxID_HIGHEST + 1,
+    kIdRobustness,
+    kIdTiming,
+    kIdSweep,
+    kIdUndo,
+    kIdRedo,
+    kIdKeep,
+    kIdCompare,
+    kIdRestore
+  };
+
+  wxMenu menu;
+  menu.Append(kIdRoute, _("Route through course waypoints"));
+  menu.Append(kIdRobustness, _("Test DCs against forecast errors"));
+  menu.Append(kIdTiming, _("Move DCs for the earliest arrival at the next "
+                           "waypoint"));
+  menu.Append(kIdSweep, _("Sweep start times"));
+  wxMenu* versions = new wxMenu;
+  versions->Append(kIdUndo, _("Undo DC change"));
+  versions->Append(kIdRedo, _("Redo DC change"));
+  versions->AppendSeparator();
+  versions->Append(kIdKeep, _("Keep DCs for comparison..."));
+  versions->Append(kIdCompare, _("Compare kept DCs"));
+  versions->Append(kIdRestore, _("Restore kept DCs..."));
+  menu.AppendSubMenu(versions, _("DC versions"));
+  if (m_prace == nullptr) {
+    menu.Enable(kIdRoute, false);
+    menu.Enable(kIdRobustness, false);
+    menu.Enable(kIdTiming, false);
+    menu.Enable(kIdSweep, false);
+  }
+  const PlanHistory* history =
+      m_prace != nullptr ? &m_prace->GetHistory() : nullptr;
+  menu.Enable(kIdUndo, history != nullptr && history->CanUndo());
+  menu.Enable(kIdRedo, history != nullptr && history->CanRedo());
+  menu.Enable(kIdKeep, history != nullptr);
+  menu.Enable(kIdCompare, history != nullptr && !history->GetKept().empty());
+  menu.Enable(kIdRestore, history != nullptr && !history->GetKept().empty());
+
+  int id = GetPopupMenuSelectionFromUser(menu);
+  if (id == kIdRoute) {
+    OnRouteCourse();
+    return;
+  }
+  if (id == kIdRobustness) {
+    OnTestRobustness();
+    return;
+  }
+  if (id == kIdTiming) {
+    OnOptimizeTiming();
+    return;
+  }
+  if (id == kIdSweep) {
+    OnSweepStart();
+    return;
+  }
+  if (id == kIdUndo || id == kIdRedo) {
+    OnUndoPlan(id == kIdRedo);
+    return;
+  }
+  if (id == kIdKeep) {
+    OnKeepPlan();
+    return;
+  }
+  if (id == kIdCompare) {
+    OnComparePlans();
+    return;
+  }
+  if (id == kIdRestore) OnRestorePlan();
+}
+
+void SailonlineUi::OnRouteCourse() {
+  wxBusyCursor wait;
+  if (!m_prace->RouteCourse()) {
+    wxString errors;
+    for (const auto& e : m_prace->GetErrors())
+      errors = errors.append(e).append('\n');
+    wxLogMessage(errors);
+    return;
+  }
+
+  // Show the new DC list, changing the page fills it
+  if (m_ppanel->m_notebook->GetSelection() == 2) {
+    m_prace->EnrichDcs();
+    FillDcList();
+  } else {
+    m_ppanel->m_notebook->SetSelection(2);
+  }
+}
+
+void SailonlineUi::OnTestRobustness() {
+  static constexpr size_t kSensitiveDcs = 5;
+
+  RobustnessSettings settings;
+  RobustnessResult result;
+  {
+    wxBusyCursor wait;
+    if (!m_prace->TestRobustness(settings, result)) {
+      wxString errors;
+      for (const auto& e : m_prace->GetErrors())
+        errors = errors.append(e).append('\n');
+      wxLogMessage(errors);
+      return;
+    }
+  }
+
+  auto format = [](std::time_t t) {
+    return wxDateTime(t).Format("%Y/%m/%d %H:%M");
+  };
+  wxString report = wxString::Format(
+      _("%d runs with TWS +-%.0f%%, TWD +-%.0f degrees, weather +-%.1f h\n"),
+      static_cast<int>(settings.m_runs), 100.0 * settings.m_speed_sigma,
+      settings.m_direction_sigma, settings.m_time_sigma);
+  for (size_t i = 0; i < result.m_etas.size(); ++i) {
+    const auto& eta = result.m_etas[i];
+    report += wxString::Format(
+        _("Waypoint %d: %s / %s / %s (10/50/90%%), reached in %d runs\n"),
+        static_cast<int>(i + 1), format(eta.m_p10), format(eta.m_p50),
+        format(eta.m_p90), static_cast<int>(eta.m_reached));
+  }
+  report += _("Most sensitive DCs:\n");
+  for (size_t i = 0; i < std::min(kSensitiveDcs, result.m_sensitive.size());
+       ++i) {
+    const auto& leg = result.m_legs[result.m_sensitive[i]];
+    report += wxString::Format(_("%s: spread %.1f nm to %.1f nm\n"),
+                               format(leg.m_time), leg.m_spread_begin,
+                               leg.m_spread_end);
+  }
+
+  wxLogMessage("%s", report);
+  OCPNMessageBox_PlugIn(this, report, _("Robustness of the DCs"), wxOK);
+}
+
+void SailonlineUi::OnOptimizeTiming() {
+  DcTimingResult result;
+  {
+    wxBusyCursor wait;
+    if (!m_prace->OptimizeTiming(DcTimingSettings(), result)) {
+      wxString errors;
+      for (const auto& e : m_prace->GetErrors())
+        errors = errors.append(e).append('\n');
+      wxLogMessage(errors);
+      return;
+    }
+  }
+  wxLogMessage("Race %s: %d DCs moved, ETA at the next waypoint %+.1f min%s",
+               m_prace->m_id, static_cast<int>(result.m_changed),
+               (result.m_eta_after - result.m_eta_before) / 60.0,
+               result.m_reached ? "" : " (not reached)");
+
+  // Show the new DC list, changing the page fills it
+  if (m_ppanel->m_notebook->GetSelection() == 2)
+    FillDcList();
+  else
+    m_ppanel->m_notebook->SetSelection(2);
+}
+
+void SailonlineUi::OnSweepStart() {
+  static constexpr std::time_t kWindow = 3 * 24 * 3600;
+
+  std::vector<Departure> departures;
+  {
+    wxBusyCursor wait;
+    if (!m_prace->SweepStart(StartSweepSettings(), kWindow, departures)) {
+      wxString errors;
+      for (const auto& e : m_prace->GetErrors())
+        errors = errors.append(e).append('\n');
+      wxLogMessage(errors);
+      return;
+    }
+  }
+
+  // ETA versus start time, the best start marked
+  size_t best = StartSweep::GetBest(departures);
+  wxString report;
+  for (size_t i = 0; i < departures.size(); ++i) {
+    const auto& departure = departures[i];
+    report += wxDateTime(departure.m_time).Format("%Y/%m/%d %H:%M  ");
+    if (std::isnan(departure.m_arrival)) {
+      report += _("no arrival\n");
+      continue;
+    }
+    report += wxString::Format(
+        "%s  %.1f h%s\n",
+        wxDateTime(static_cast<time_t>(departure.m_arrival))
+            .Format("%Y/%m/%d %H:%M"),
+        departure.GetDuration() / 3600.0, i == best ? "  <" : "");
+  }
+  wxLogMessage("%s", report);
+
+  if (best == departures.size()) {
+    OCPNMessageBox_PlugIn(this, _("No departure arrives"),
+                          _("Start times"), wxOK);
+    return;
+  }
+  OCPNMessageBox_PlugIn(
+      this,
+      wxString::Format(_("Best start %s, %.1f h (%d departures, see log)"),
+                       wxDateTime(departures[best].m_time)
+                           .Format("%Y/%m/%d %H:%M"),
+                       departures[best].GetDuration() / 3600.0,
+                       static_cast<int>(departures.size())),
+      _("Start times"), wxOK);
+}
+
+void SailonlineUi::OnUndoPlan(bool redo) {
+  bool changed = redo ? m_prace->RedoPlan() : m_prace->UndoPlan();
+  if (!changed) return;
+
+  // Show the DC list, changing the page fills it
+  if (m_ppanel->m_notebook->GetSelection() == 2)
+    FillDcList();
+  else
+    m_ppanel->m_notebook->SetSelection(2);
+}
+
+void SailonlineUi::OnKeepPlan() {
+  wxString name = wxGetTextFromUser(
+      _("Name of the DCs to keep"), _("Keep DCs"),
+      wxString::Format(
+          _("Plan %d"),
+          static_cast<int>(m_prace->GetHistory().GetKept().size() + 1)),
+      this);
+  if (name.IsEmpty()) return;
+
+  m_prace->KeepPlan(name.ToStdString());
+}
+
+void SailonlineUi::OnComparePlans() {
+  // Nm, as for the robustness test
+  static constexpr double kRadius = 1.0;
+
+  std::vector<std::vector<double>> etas;
+  {
+    wxBusyCursor wait;
+    if (!m_prace->ComparePlans(kRadius, etas)) {
+      wxString errors;
+      for (const auto& e : m_prace->GetErrors())
+        errors = errors.append(e).append('\n');
+      wxLogMessage(errors);
+      return;
+    }
+  }
+
+  const PlanHistory& history = m_prace->GetHistory();
+  const auto& kept = history.GetKept();
+  auto format = [](double t) {
+    if (std::isnan(t)) return wxString(_("not reached"));
+    return wxDateTime(static_cast<std::time_t>(t)).Format("%Y/%m/%d %H:%M");
+  };
+  wxString report;
+  for (size_t i = 0; i < etas.size(); ++i) {
+    const PlanSnapshot& plan =
+        i == 0 ? history.GetCurrent() : kept[i - 1].second;
+    report += wxString::Format(
+        _("%s (%d DCs):\n"),
+        i == 0 ? wxString(_("Current DCs")) : wxString(kept[i - 1].first),
+        static_cast<int>(plan.GetSize()));
+    for (size_t j = 0; j < etas[i].size(); ++j) {
+      report += wxString::Format(_("  Waypoint %d: %s"),
+                                 static_cast<int>(j + 1), format(etas[i][j]));
+      // Later is positive
+      if (i > 0 && !std::isnan(etas[i][j]) && !std::isnan(etas[0][j]))
+        report += wxString::Format(_(" (%+.0f min)"),
+                                   (etas[i][j] - etas[0][j]) / 60.0);
+      report += '\n';
+    }
+  }
+
+  wxLogMessage("%s", report);
+  OCPNMessageBox_PlugIn(this, report, _("Comparison of the DCs"), wxOK);
+}
+
+void SailonlineUi::OnRestorePlan() {
+  wxArrayString names;
+  for (const auto& kept : m_prace->GetHistory().GetKept())
+    names.Add(kept.first);
+  int i = wxGetSingleChoiceIndex(_("DCs to restore"), _("Restore DCs"), names,
+                                 this);
+  if (i < 0 || !m_prace->RestorePlan(i)) return;
+
+  // Show the DC list, changing the page fills it
+  if (m_ppanel->m_notebook->GetSelection() == 2)
+    FillDcList();
+  else
+    m_ppanel->m_notebook->SetSelection(2);
+}
+
+void SailonlineUi::OnPrefetchDone() {
+  SetTitle(_("Sailonline"));
+
+  wxString errors;
+  for (const auto& e : GetSol()->GetErrors())
+    errors = errors.append(e).append('\n');
+  if (!errors.IsEmpty()) wxLogMessage(errors);
+
+  // Pick up the prefetched data, but keep the DCs being edited
+  if (m_prace == nullptr) return;
+  auto prace = GetSol()->GetRace(m_prace->m_id);
+  if (prace == nullptr) return;
+  prace->CopyPlan(*m_prace);
+  m_prace = std::move(prace);
+}
+
 void SailonlineUi::OnPageChanged(wxBookCtrlEvent& event) {
   if (m_prace == nullptr) return;
 
@@ -276,8 +659,37 @@ void SailonlineUi::OnPageChanged(wxBookCtrlEvent& event) {
 
 void SailonlineUi::OnPolarDownload(wxCommandEvent& event) {}
 
-void SailonlineUi::OnDcDownload(wxCommandEvent& event) {}
-void SailonlineUi::OnDcUpload(wxCommandEvent& event) {}
+void SailonlineUi::OnDcDownload(wxCommandEvent& event) {
+  if (m_prace == nullptr || !m_dc_server_sync) return;
+
+  wxBusyCursor wait;
+  // DCs are planned against the server clock, the user should know its offset
+  const ClockSync& clock = m_prace->GetClock();
+  if (m_prace->DownloadDcs() && clock.HasOffset())
+    SetTitle(wxString::Format(_("Sailonline - server clock %+.1f s (%.1f s)"),
+                              clock.GetOffset(), clock.GetUncertainty()));
+  wxString errors;
+  for (const auto& e : m_prace->GetErrors())
+    errors = errors.append(e).append('\n');
+  if (!errors.IsEmpty()) wxLogMessage(errors);
+
+  FillDcList();
+}
+
+void SailonlineUi::OnDcUpload(wxCommandEvent& event) {
+  if (m_prace == nullptr || !m_dc_server_sync) return;
+
+  wxBusyCursor wait;
+  if (m_prace->UploadDcs())
+    SetTitle(wxString::Format(_("Sailonline - DCs confirmed after %.0f ms"),
+                              m_prace->GetUploadLatency()));
+  wxString errors;
+  for (const auto& e : m_prace->GetErrors())
+    errors = errors.append(e).append('\n');
+  if (!errors.IsEmpty()) wxLogMessage(errors);
+
+  FillDcList();
+}
 
 void SailonlineUi::FillDcList() {
   // TODO Error message
@@ -285,16 +697,17 @@ void SailonlineUi::FillDcList() {
 
   m_ppanel->m_pdclist->DeleteAllItems();
 
-  m_prace->EnrichDcs();
-  auto dcs = m_prace->GetDcs();
+  // Enriched by whoever changed the DCs
+  const auto& dcs = m_prace->GetDcs();
+  const auto& ledger = m_prace->GetLedger();
   auto previous_dc = dcs.begin();
 
   for (auto dc = dcs.begin(); dc != dcs.end(); ++dc) {
     wxListItem item;
     long index = m_ppanel->m_pdclist->InsertItem(
         m_ppanel->m_pdclist->GetItemCount(), item);
-    m_ppanel->m_pdclist->SetItem(index, 0,
-                                 dc->m_timestamp.Format("%Y/%m/%d %H:%M:%S"));
+    m_ppanel->m_pdclist->SetItem(
+        index, 0, wxDateTime(dc->m_timestamp).Format("%Y/%m/%d %H:%M:%S"));
     m_ppanel->m_pdclist->SetItem(index, 1, dc->m_is_twa ? "twa" : "cc");
     m_ppanel->m_pdclist->SetItem(index, 2,
                                  wxString::Format("%03.3f", dc->m_course));
@@ -311,45 +724,122 @@ void SailonlineUi::FillDcList() {
         index, 6, wxString::Format("%03.3f", dc->m_perf_begin * 100));
     m_ppanel->m_pdclist->SetItem(
         index, 7, wxString::Format("%03.3f", dc->m_perf_end * 100));
+    // DCs before the boat state are not sailed any more
+    if (const auto* entry = ledger.Find(dc->m_timestamp)) {
+      m_ppanel->m_pdclist->SetItem(
+          index, 8, wxString::Format("%.3f", entry->GetLoss()));
+      m_ppanel->m_pdclist->SetItem(
+          index, 9, wxString::Format("%.0f", entry->GetLossSeconds()));
+    }
 
     previous_dc = dc;
   }
+  if (!ledger.GetEntries().empty()) {
+    long index = m_ppanel->m_pdclist->InsertItem(
+        m_ppanel->m_pdclist->GetItemCount(), _("Total"));
+    m_ppanel->m_pdclist->SetItem(
+        index, 8, wxString::Format("%.3f", ledger.GetTotalLoss()));
+    m_ppanel->m_pdclist->SetItem(
+        index, 9, wxString::Format("%.0f", ledger.GetTotalLossSeconds()));
+  }
 
   for (int i = 0; i < m_ppanel->m_pdclist->GetColumnCount(); ++i)
     m_ppanel->m_pdclist->SetColumnWidth(i, wxLIST_AUTOSIZE);
+
+  // Get ready for the upload while the DCs are looked at. Most errors are in
+  // the DCs, the upload reports them again
+  if (m_dc_server_sync && m_prace->HasServerDcs() && !m_prace->PrepareUpload())
+    for (const auto& e : m_prace->GetErrors()) wxLogMessage("%s", e);
+
+  // Poll the boat state more often before the next DC
+  if (m_boat_poller != nullptr) {
+    std::time_t now = m_prace->GetClock().Now();
+    auto next_dc = std::find_if(dcs.begin(), dcs.end(), [now](const Dc& dc) {
+      return dc.m_timestamp > now;
+    });
+    m_boat_poller->SetNextDc(next_dc == dcs.end() ? 0 : next_dc->m_timestamp);
+    for (const auto& e : m_boat_poller->GetErrors()) wxLogMessage("%s", e);
+  }
+  if (m_weather_poller != nullptr)
+    for (const auto& e : m_weather_poller->GetErrors()) wxLogMessage("%s", e);
+}
+
+void SailonlineUi::StartBoatPolling() {
+  std::string url = m_prace->GetBoatUrl();
+  if (url.empty()) {
+    for (const auto& e : m_prace->GetErrors()) wxLogMessage("%s", e);
+    return;
+  }
+
+  if (m_boat_poller == nullptr)
+    m_boat_poller = std::make_unique<BoatPoller>(GetSol()->GetClock());
+  if (m_boat_poller->IsRunning() && m_boat_poller->GetUrl() == url) return;
+  // States arriving after a change of race are dropped
+  std::string id = m_prace->m_id;
+  m_boat_poller->Start(url, [this, id](const SolXml::BoatState& state) {
+    if (m_prace != nullptr && m_prace->m_id == id) OnBoatState(state);
+  });
+}
+
+void SailonlineUi::StartWeatherPolling() {
+  std::string url = m_prace->GetWeatherInfoUrl();
+  if (url.empty()) {
+    for (const auto& e : m_prace->GetErrors()) wxLogMessage("%s", e);
+    return;
+  }
+
+  if (m_weather_poller == nullptr)
+    m_weather_poller = std::make_unique<WeatherPoller>(GetSol()->GetClock());
+  if (m_weather_poller->IsRunning() && m_weather_poller->GetUrl() == url)
+    return;
+  // Forecasts arriving after a change of race are dropped
+  std::string id = m_prace->m_id;
+  m_weather_poller->Start(
+      url, m_prace->GetCacheDir(), m_prace->GetWeatherUrl(),
+      [this, id](const SolXml::WeatherInfo& info,
+                 std::shared_ptr<const WindGrid> weather) {
+        if (m_prace != nullptr && m_prace->m_id == id)
+          OnWeather(info, std::move(weather));
+      });
+}
+
+void SailonlineUi::OnWeather(const SolXml::WeatherInfo& info,
+                             std::shared_ptr<const WindGrid> weather) {
+  m_prace->SetWeather(info, std::move(weather));
+  FillDcList();
+}
+
+void SailonlineUi::OnBoatState(const SolXml::BoatState& state) {
+  wxLogMessage("Boat state of race %s at %s", m_prace->m_id,
+               SolTime::FormatUtc(state.m_time));
+  m_prace->SetBoatState(state);
+  const auto& drift = m_prace->GetDrift();
+  if (drift.m_exceeded)
+    SetTitle(wxString::Format(
+        _("Sailonline - %.2f nm off the plan, performance %+.1f %%"),
+        drift.m_distance, drift.m_performance * 100.0));
+  FillDcList();
 }
 
 void SailonlineUi::OnDcFromTrack(wxCommandEvent& event) {
   if (m_prace == nullptr) return;
 
-  FromTrackDialog dlg(this);
+  FromTrackDialog dlg(this, m_track_catalogue);
 
   if (dlg.ShowModal() == wxID_OK) {
     wxString track_guid = dlg.GetSelectedTrack();
     auto ptrack = GetTrack_Plugin(track_guid);
     if (ptrack == nullptr) return;
+    m_track_catalogue.Update(*ptrack);
 
     if (ptrack->pWaypointList->size() < 2) return;
 
-    auto first_waypoint = ptrack->pWaypointList->begin();
-    auto& dcs = m_prace->GetDcs();
-    dcs.clear();
-
-    for (auto waypoint = first_waypoint;
-         waypoint != ptrack->pWaypointList->end(); ++waypoint) {
-      if (waypoint == first_waypoint) continue;
-
-      double bearing, distance;
-      auto wp = *waypoint;
-      auto first_wp = *first_waypoint;
-      DistanceBearingMercator_Plugin(wp->m_lat, wp->m_lon, first_wp->m_lat,
-                                     first_wp->m_lon, &bearing, &distance);
-
-      dcs.emplace_back(Dc{first_wp->m_CreateTime, first_wp->m_lat,
-                          first_wp->m_lon, bearing, false});
-
-      first_waypoint = waypoint;
-    }
+    std::vector<TrackPoint> track;
+    track.reserve(ptrack->pWaypointList->size());
+    for (const auto* wp : *ptrack->pWaypointList)
+      track.push_back({wp->m_CreateTime.GetTicks(), wp->m_lat, wp->m_lon});
+    m_prace->CompileDcs(track);
+    m_prace->EnrichDcs();
 
     FillDcList();
   }
@@ -366,6 +856,7 @@ void SailonlineUi::OnDcModify(wxCommandEvent& event) {
 
   m_prace->SimplifyDcs();
   m_prace->OptimizeManeuvers();
+  m_prace->EnrichDcs();
 
   FillDcList();
 }
@@ -373,19 +864,8 @@ void SailonlineUi::OnDcModify(wxCommandEvent& event) {
 void SailonlineUi::OnCopyDcs(wxCommandEvent& event) {
   if (m_prace == nullptr) return;
 
-  wxString dc_list;
-  const auto& dcs = m_prace->GetDcs();
-
-  for (const auto& dc : dcs) {
-    wxString timestamp = dc.m_timestamp.Format("%Y/%m/%d %H:%M:%S");
-    wxString coursetype = (dc.m_is_twa ? "twa" : "cc");
-    wxString course =
-        wxString::Format("%03.3f", dc.m_is_twa ? dc.m_twa : dc.m_course);
-
-    wxString line;
-    line.Printf("%s %s %s %c", timestamp, coursetype, course, '\n');
-    dc_list.Append(std::move(line));
-  }
+  // The format sol-dc and DcFile::ParseDcList() read, times in UTC
+  wxString dc_list = DcFile::FormatDcList(m_prace->GetDcs());
 
   if (wxTheClipboard->Open()) {
     wxTheClipboard->SetData(
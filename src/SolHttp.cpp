@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+
+#include <curl/curl.h>
+
+#include "ClockSync.h"
+#include "SolHttp.h"
+
+namespace {
+/// Value of the header line if it has the given (lower case) name
+bool header_value(const std::string& line, const std::string& name,
+                  std::string& value) {
+  // Header names are case insensitive
+  auto same = [](char a, char b) {
+    return a == std::tolower(static_cast<unsigned char>(b));
+  };
+  if (line.size() <= name.size() ||
+      !std::equal(name.begin(), name.end(), line.begin(), same))
+    return false;
+
+  size_t first = line.find_first_not_of(" \t", name.size());
+  size_t last = line.find_last_not_of(" \t\r\n");
+  if (first == std::string::npos || last < first) return false;
+  value = line.substr(first, last - first + 1);
+  return true;
+}
+}  // namespace
+
+namespace SolHttp {
+
+size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+  size_t realsize = size * nitems;
+  std::string line(buffer, realsize);
+  Headers* headers = static_cast<Headers*>(userp);
+
+  std::string value;
+  if (header_value(line, "etag:", value)) {
+    headers->m_etag = value;
+  } else if (header_value(line, "date:", value)) {
+    headers->m_date = curl_getdate(value.c_str(), nullptr);
+  }
+  return realsize;
+}
+
+void SampleClock(CURL* curl, double local_start, const Headers& headers,
+                 ClockSync& clock) {
+  if (headers.m_date < 0) return;
+
+  // The request was sent after connecting, the answer started with the
+  // first byte. Without these, the whole transfer bounds the server time
+  double sent = 0.0, answered = 0.0, total = 0.0;
+  curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &sent);
+  curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &answered);
+  curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+  if (answered <= 0.0 || answered < sent) {
+    sent = 0.0;
+    answered = total;
+  }
+
+  clock.AddSample(headers.m_date, local_start + sent, local_start + answered);
+}
+}  // namespace SolHttp
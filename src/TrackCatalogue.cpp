@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <set>
+
+#include <wx/wx.h>
+
+#include <ocpn_plugin.h>
+
+#include "TrackCatalogue.h"
+
+void TrackCatalogue::Refresh() {
+  wxArrayString guids = GetTrackGUIDArray();
+  std::set<wxString> current(guids.begin(), guids.end());
+
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+    if (current.count(it->first) == 0)
+      it = m_entries.erase(it);
+    else
+      ++it;
+
+  // Map nodes don't move, so the pointers stay valid until erased
+  m_order.clear();
+  m_order.reserve(guids.size());
+  for (const auto& guid : guids) {
+    Entry& entry = m_entries[guid];
+    if (entry.m_guid.IsEmpty()) {
+      entry.m_guid = guid;
+      entry.m_name = guid;
+    }
+    m_order.push_back(&entry);
+  }
+  m_next_pending = 0;
+  while (HasPending() && m_order[m_next_pending]->m_loaded) ++m_next_pending;
+}
+
+bool TrackCatalogue::LoadNext() {
+  // Entries may have been updated meanwhile
+  while (HasPending() && m_order[m_next_pending]->m_loaded) ++m_next_pending;
+  if (!HasPending()) return false;
+
+  Entry& entry = m_entries[m_order[m_next_pending]->m_guid];
+  auto ptrack = GetTrack_Plugin(entry.m_guid);
+  if (ptrack != nullptr) Summarize(*ptrack, entry);
+  entry.m_loaded = true;  // Also if the track vanished meanwhile
+  ++m_next_pending;
+
+  return true;
+}
+
+void TrackCatalogue::Update(const PlugIn_Track& track) {
+  auto it = m_entries.find(track.m_GUID);
+  if (it == m_entries.end()) return;
+
+  Summarize(track, it->second);
+  it->second.m_loaded = true;
+}
+
+const TrackCatalogue::Entry& TrackCatalogue::GetEntry(size_t i) const {
+  return *m_order[i];
+}
+
+wxString TrackCatalogue::GetLabel(const Entry& entry) {
+  if (!entry.m_loaded) return entry.m_name + _(" (loading...)");
+
+  wxString label = wxString::Format(_("%s (%d points"), entry.m_name,
+                                    static_cast<int>(entry.m_points));
+  if (entry.m_begin.IsValid() && entry.m_end.IsValid())
+    label << ", " << entry.m_begin.Format("%Y/%m/%d %H:%M") << " - "
+          << entry.m_end.Format("%Y/%m/%d %H:%M");
+  return label << ")";
+}
+
+void TrackCatalogue::Summarize(const PlugIn_Track& track, Entry& entry) {
+  entry.m_name = track.m_NameString.IsEmpty() ? track.m_GUID
+                                              : track.m_NameString;
+  entry.m_points = track.pWaypointList->GetCount();
+  entry.m_begin = entry.m_end = wxDateTime();
+  if (entry.m_points > 0) {
+    entry.m_begin = track.pWaypointList->GetFirst()->GetData()->m_CreateTime;
+    entry.m_end = track.pWaypointList->GetLast()->GetData()->m_CreateTime;
+  }
+}
@@ -0,0 +1,241 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <chrono>
+
+#include <wx/filename.h>
+
+#include <curl/curl.h>
+
+#include "ClockSync.h"
+#include "SolHttp.h"
+#include "WeatherPoller.h"
+#include "WindGrid.h"
+
+namespace {
+size_t curl_append_cb(void* contents, size_t size, size_t nmemb,
+                      void* userp) {
+  size_t realsize = size * nmemb;
+  static_cast<std::string*>(userp)->append(static_cast<const char*>(contents),
+                                           realsize);
+  return realsize;
+}
+
+int curl_cancel_cb(void* clientp, curl_off_t, curl_off_t, curl_off_t,
+                   curl_off_t) {
+  const auto& cancelled = *static_cast<std::function<bool()>*>(clientp);
+  return cancelled && cancelled() ? 1 : 0;
+}
+
+/// Set the options common to all requests of the poller
+void setup(CURL* curl, const std::string& url) {
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_append_cb);
+}
+}  // namespace
+
+WeatherPoller::WeatherPoller(std::shared_ptr<ClockSync> clock)
+    : m_clock(std::move(clock)) {}
+
+WeatherPoller::~WeatherPoller() {
+  // Pending handler calls are discarded together with this handler
+  Stop();
+}
+
+std::vector<std::string> WeatherPoller::GetErrors() {
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::swap(m_errors, result);
+  return result;
+}
+
+void WeatherPoller::Start(const std::string& url, const std::string& cache_dir,
+                          const std::string& known_url, Handler handler) {
+  Stop();
+
+  m_url = url;
+  m_cache_dir = cache_dir;
+  m_known_url = known_url;
+  m_handler = handler;
+  m_stop = false;
+  m_thread = std::thread([this]() { Run(); });
+}
+
+void WeatherPoller::Stop() {
+  if (!m_thread.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wakeup.notify_all();
+  m_thread.join();
+}
+
+std::shared_ptr<const WindGrid> WeatherPoller::LoadForecast(
+    const std::string& url, const std::string& cache_dir,
+    std::vector<std::string>& errors, std::function<bool()> cancelled) {
+  // Forecasts are never changed once published, so the cache is named after
+  // the weather XML and valid forever
+  wxFileName cache(cache_dir, "");
+  cache.SetName(wxFileName(url.substr(url.find_last_of('/') + 1)).GetName());
+  cache.SetExt("bin");
+  std::string cache_path = cache.GetFullPath().ToStdString();
+
+  auto weather = std::make_shared<WindGrid>();
+  if (cache.FileExists() && weather->LoadBinary(cache_path)) return weather;
+  weather->GetErrors();  // Download again
+
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    errors.emplace_back("Curl error: curl_easy_init() failed");
+    return nullptr;
+  }
+  setup(curl, url);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 300L);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, curl_cancel_cb);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, (void*)&cancelled);
+  std::string xml;
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&xml);
+  CURLcode result = curl_easy_perform(curl);
+  long status = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+  curl_easy_cleanup(curl);
+  if (result != CURLE_OK) {
+    errors.emplace_back("Curl error: " + std::to_string(result));
+    return nullptr;
+  }
+  if (status < 200 || status >= 300) {
+    errors.emplace_back("HTTP error " + std::to_string(status) +
+                        " for the weather " + url);
+    return nullptr;
+  }
+
+  if (!weather->Parse(xml)) {
+    for (auto& e : weather->GetErrors()) errors.emplace_back(std::move(e));
+    return nullptr;
+  }
+  // Still usable without the cache
+  if (!weather->SaveBinary(cache_path))
+    for (auto& e : weather->GetErrors()) errors.emplace_back(std::move(e));
+
+  return weather;
+}
+
+void WeatherPoller::Run() {
+  // Note: curl_global_init() is called by class Sailonline
+  CURL* curl = curl_easy_init();
+  if (curl == nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back("Curl error: curl_easy_init() failed");
+    return;
+  }
+
+  // One connection for all polls
+  setup(curl, m_url);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, SolHttp::HeaderCallback);
+
+  std::string etag, last_text;
+  while (true) {
+    Poll(curl, etag, last_text);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(
+                        static_cast<long>(kInterval * 1000.0));
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_wakeup.wait_until(lock, deadline, [this]() { return m_stop; }))
+      break;
+  }
+
+  curl_easy_cleanup(curl);
+}
+
+bool WeatherPoller::Poll(CURL* curl, std::string& etag,
+                         std::string& last_text) {
+  // Nothing but the status is transferred if the info is unchanged
+  struct curl_slist* headers = nullptr;
+  if (!etag.empty())
+    headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  SolHttp::Headers response_headers;
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)&response_headers);
+  std::string text;
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&text);
+
+  double local_start = ClockSync::LocalNow();
+  CURLcode result = curl_easy_perform(curl);
+  long status = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(headers);
+
+  std::string error;
+  if (result != CURLE_OK) {
+    error = "Curl error: " + std::to_string(result);
+  } else if (status != 304 && (status < 200 || status >= 300)) {
+    error = "HTTP error " + std::to_string(status) + " for the weather info";
+  }
+  if (!error.empty()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back(error);
+    return false;
+  }
+
+  SolHttp::SampleClock(curl, local_start, response_headers, *m_clock);
+  if (status == 304 || text == last_text) return true;
+
+  SolXml::WeatherInfo info;
+  if (!SolXml::ParseWeatherInfo(text, info, error)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_errors.emplace_back(error);
+    return false;
+  }
+  if (info.m_url == m_known_url) {
+    etag = response_headers.m_etag;
+    last_text = text;
+    return true;
+  }
+
+  std::vector<std::string> errors;
+  auto weather = LoadForecast(info.m_url, m_cache_dir, errors, [this]() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stop;
+  });
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& e : errors) m_errors.emplace_back(std::move(e));
+  }
+  // Tried again with the next poll
+  if (weather == nullptr) return false;
+  etag = response_headers.m_etag;
+  last_text = text;
+  m_known_url = info.m_url;
+
+  CallAfter([this, info, weather]() {
+    if (m_handler) m_handler(info, weather);
+  });
+  return true;
+}
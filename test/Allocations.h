@@ -0,0 +1,34 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _ALLOCATIONS_H_
+#define _ALLOCATIONS_H_
+
+#include <cstddef>
+
+// Heap allocations of the benchmarks, counted by the replacement of the
+// global operator new in Allocations.cpp. The replacement lives in its own
+// translation unit, so that the compiler doesn't inline it into callers and
+// pair the malloc() of one with the free() of the other
+namespace Allocations {
+/// Calls of operator new so far
+size_t GetCount();
+}  // namespace Allocations
+
+#endif
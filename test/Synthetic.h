@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#ifndef _SYNTHETIC_H_
+#define _SYNTHETIC_H_
+
+// Deterministic wind field, polar and DC lists for the benchmarks
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <string>
+
+#include "Dc.h"
+#include "Providers.h"
+#include "SolTime.h"
+
+namespace Synthetic {
+static constexpr double kDegToRad = M_PI / 180.0;
+
+/// 2026-01-01 12:00:00 UTC
+static constexpr std::time_t kStart = 1767268800;
+
+/// A slowly veering westerly with a speed gradient over latitude
+class WindField : public WindProvider {
+public:
+  std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                        double lon) const override {
+    double hours = (t - kStart) / 3600.0;
+    double tws = 14.0 + 4.0 * std::sin(lat * kDegToRad * 10.0) +
+                 3.0 * std::cos(hours / 12.0 * M_PI);
+    double twd = 270.0 + 30.0 * std::sin(hours / 36.0 * M_PI) + 0.1 * lon;
+    return {tws, twd};
+  }
+};
+
+/// Boat speed rises with TWS and peaks on a beam reach, with a dead zone below
+/// 30 degrees TWA
+class BoatPolar : public PolarProvider {
+public:
+  double GetSpeedThroughWater(double tws, double twa) const override {
+    twa = std::fabs(twa);
+    if (twa < 30.0) return 0.0;
+    return std::min(tws, 25.0) * (0.45 + 0.35 * std::sin(twa * kDegToRad));
+  }
+
+  std::pair<double, double> GetBoatOptimalAngles(double tws) const override {
+    return {40.0 + 0.3 * tws, 150.0 + 0.5 * tws};
+  }
+};
+
+/// Discards the track
+class NullTrack : public TrackSink {
+public:
+  void AddTrackPoint(std::time_t t, double lat, double lon) override {}
+};
+
+/// DC list with legs of ten minutes, in groups of three almost identical
+/// courses that SimplifyDcs() can join, alternating between tacks so that
+/// OptimizeManeuvers() has work to do. Every fourth DC is a TWA.
+inline std::list<Dc> MakeDcs(size_t count) {
+  std::list<Dc> dcs;
+  std::time_t timestamp = kStart;
+  double lat = 45.0;
+  double lon = -10.0;
+
+  for (size_t i = 0; i < count; ++i) {
+    bool starboard = (i / 3) % 2 == 0;
+    bool is_twa = i % 4 == 3;
+    double course = is_twa ? (starboard ? 50.0 : -50.0) + (i % 3) * 0.3
+                           : (starboard ? 220.0 : 320.0) + (i % 3) * 0.5;
+    dcs.emplace_back(timestamp, lat, lon, course, is_twa);
+
+    timestamp += 600;
+    lat += starboard ? -0.01 : 0.01;
+    lon -= 0.02;
+  }
+
+  return dcs;
+}
+
+/// Weather XML as served by sailonline.org (see WindGrid) with the wind of
+/// WindField on a 0.5 degree grid around the DCs of MakeDcs(), one frame per
+/// three hours
+inline std::string MakeWeatherXml(size_t frames) {
+  static constexpr size_t kLatPoints = 61, kLonPoints = 81;
+  static constexpr double kLatStart = 30.0, kLonStart = -40.0;
+  static constexpr double kIncrement = 0.5;
+  static constexpr double kKnotsToMs = 1852.0 / 3600.0;
+  WindField wind;
+  char number[32];
+
+  std::string xml = "<?xml version=\"1.0\"?>\n<MeteoData><MeteoDataSet>";
+  xml += "<lat_n_points>" + std::to_string(kLatPoints) + "</lat_n_points>";
+  xml += "<lon_n_points>" + std::to_string(kLonPoints) + "</lon_n_points>";
+  xml += "<lat_start>30</lat_start><lon_start>-40</lon_start>";
+  xml += "<lat_increment>0.5</lat_increment><lon_increment>0.5</lon_increment>";
+  xml += "<frames>";
+  for (size_t frame = 0; frame < frames; ++frame) {
+    std::time_t t = kStart + frame * 3 * 3600;
+    std::string u, v;
+    for (size_t lat = 0; lat < kLatPoints; ++lat) {
+      for (size_t lon = 0; lon < kLonPoints; ++lon) {
+        auto [tws, twd] = wind.GetWindData(t, kLatStart + lat * kIncrement,
+                                           kLonStart + lon * kIncrement);
+        char separator = lon + 1 < kLonPoints ? ' ' : ';';
+        std::snprintf(number, sizeof(number), "%.2f%c",
+                      -tws * kKnotsToMs * std::sin(twd * kDegToRad),
+                      separator);
+        u += number;
+        std::snprintf(number, sizeof(number), "%.2f%c",
+                      -tws * kKnotsToMs * std::cos(twd * kDegToRad),
+                      separator);
+        v += number;
+      }
+    }
+    xml += "<frame target_time=\"" + SolTime::FormatUtc(t) + "\"><U>" + u +
+           "</U><V>" + v + "</V></frame>";
+  }
+  xml += "</frames></MeteoDataSet></MeteoData>\n";
+
+  return xml;
+}
+}  // namespace Synthetic
+
+#endif
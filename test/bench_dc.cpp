@@ -0,0 +1,322 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "Allocations.h"
+#include "DcFile.h"
+#include "DcModel.h"
+#include "DcTiming.h"
+#include "DriftMonitor.h"
+#include "PerformanceLedger.h"
+#include "PlanHistory.h"
+#include "Robustness.h"
+#include "StartSweep.h"
+#include "Synthetic.h"
+#include "ThreadPool.h"
+
+namespace {
+const Synthetic::WindField g_wind;
+const Synthetic::BoatPolar g_polar;
+
+/// Count the DCs as items, reported as DCs per second, and set allocs/DC
+void set_counters(benchmark::State& state, size_t allocations) {
+  double dcs = static_cast<double>(state.iterations() * state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["allocs/DC"] = static_cast<double>(allocations) / dcs;
+}
+
+/// Dense route (ten minutes between points) compiled into DCs
+void BM_CompileDcs(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> source = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(source);
+  DcFile::TrackRecorder route;
+  model.MakeTrack(source, route);
+
+  std::list<Dc> dcs;
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state)
+    model.CompileDcs(route.m_track, DcModel::kRouteTolerance, dcs);
+  set_counters(state, Allocations::GetCount() - allocations);
+  state.counters["DCs out"] = static_cast<double>(dcs.size());
+}
+
+void BM_EnrichDcs(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) model.EnrichDcs(dcs);
+  set_counters(state, Allocations::GetCount() - allocations);
+}
+
+void BM_SimplifyDcs(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> enriched = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(enriched);
+
+  size_t allocations = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::list<Dc> dcs = enriched;
+    state.ResumeTiming();
+    size_t before = Allocations::GetCount();
+    model.SimplifyDcs(dcs);
+    allocations += Allocations::GetCount() - before;
+  }
+  set_counters(state, allocations);
+}
+
+void BM_OptimizeManeuvers(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> enriched = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(enriched);
+
+  size_t allocations = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::list<Dc> dcs = enriched;
+    state.ResumeTiming();
+    size_t before = Allocations::GetCount();
+    model.OptimizeManeuvers(dcs);
+    allocations += Allocations::GetCount() - before;
+  }
+  set_counters(state, allocations);
+}
+
+void BM_MakeTrack(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+  Synthetic::NullTrack track;
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) model.MakeTrack(dcs, track);
+  set_counters(state, Allocations::GetCount() - allocations);
+}
+
+/// MakeTrack() with the ledger of the maneuver losses in the same pass
+void BM_MakeLedger(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+  Synthetic::NullTrack track;
+  PerformanceLedger ledger(&track);
+  model.MakeTrack(dcs, ledger);
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) {
+    ledger.Clear();
+    model.MakeTrack(dcs, ledger);
+  }
+  set_counters(state, Allocations::GetCount() - allocations);
+  state.counters["loss s"] = ledger.GetTotalLossSeconds();
+}
+
+/// Autosave of an enriched plan: binary and text export
+void BM_SavePlan(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DcFile::FormatDcPlan(dcs));
+    benchmark::DoNotOptimize(DcFile::FormatDcList(dcs, true));
+  }
+  set_counters(state, Allocations::GetCount() - allocations);
+  state.counters["bytes/DC"] =
+      static_cast<double>(DcFile::FormatDcPlan(dcs).size()) / state.range(0);
+}
+
+/// Loading the plan on race selection
+void BM_LoadPlan(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+  std::string data = DcFile::FormatDcPlan(dcs);
+  std::string error;
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) DcFile::ParseDcPlan(data, dcs, error);
+  set_counters(state, Allocations::GetCount() - allocations);
+}
+
+/// Edits of one DC each, committed to the undo history. Reports the DCs
+/// stored per edit, which stay far below the length of the plan
+void BM_PlanCommit(benchmark::State& state) {
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  PlanHistory history;
+  history.Commit(dcs);
+
+  size_t edits = 0;
+  auto dc = dcs.begin();
+  for (auto _ : state) {
+    if (++dc == dcs.end()) dc = dcs.begin();
+    (dc->m_is_twa ? dc->m_twa : dc->m_course) += 1.0;
+    history.Commit(dcs);
+    ++edits;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["stored DCs/edit"] =
+      static_cast<double>(history.GetStoredDcs() - state.range(0)) /
+      std::min(edits, PlanHistory::kMaxUndo);
+}
+
+/// Boat states in the middle of the plan. Either the boat sails as projected
+/// (lookup only), or every state is off the projection (simulation of the
+/// remaining DCs)
+void BM_DriftUpdate(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+  // Sailing at the TWA of the first DC, whatever the wind in the middle
+  const Dc& first = dcs.front();
+  DcModel::Anchor anchor{first.m_timestamp, first.m_lat_start,
+                         first.m_lon_start, first.m_course, first.m_twa,
+                         true, 1.0};
+  DriftMonitor monitor;
+  monitor.SetPlan(model, dcs, anchor);
+
+  auto projection = monitor.GetProjection();
+  const TrackPoint& middle = projection[projection.size() / 2];
+  DcModel::Anchor actual = anchor;
+  actual.m_time = middle.m_time + 60;
+  actual.m_lat = middle.m_lat;
+  actual.m_lon = middle.m_lon;
+  bool on_projection = state.range(1) != 0;
+  monitor.Update(model, dcs, actual);
+
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) {
+    if (!on_projection) actual.m_lat = -actual.m_lat;
+    benchmark::DoNotOptimize(monitor.Update(model, dcs, actual));
+  }
+  set_counters(state, Allocations::GetCount() - allocations);
+}
+
+/// Timing of a plan with a DC every ten minutes, for the earliest arrival at
+/// the end of its track. The candidates run on all cores
+void BM_DcTiming(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(state.range(0));
+  model.EnrichDcs(dcs);
+  DcModel::Plan planned;
+  model.MakePlan(dcs, planned);
+  DcFile::TrackRecorder recorder;
+  model.MakeTrack(planned, recorder);
+  const TrackPoint& target = recorder.m_track[recorder.m_track.size() - 2];
+
+  ThreadPool pool;
+  DcTiming timing(g_wind, g_polar, DcTimingSettings(), &pool);
+  DcTimingResult result;
+  for (auto _ : state) {
+    state.PauseTiming();
+    DcModel::Plan plan = planned;
+    state.ResumeTiming();
+    timing.Optimize(plan, target.m_lat, target.m_lon, result);
+  }
+  state.counters["gain s"] = result.m_eta_before - result.m_eta_after;
+  state.counters["moved"] = static_cast<double>(result.m_changed);
+  state.counters["simulations"] = static_cast<double>(result.m_simulations);
+}
+
+/// A one day plan (144 DCs) as template for departures every 30 minutes over
+/// three days, on all cores
+void BM_StartSweepDcs(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(144);
+  model.EnrichDcs(dcs);
+  DcModel::Plan plan;
+  model.MakePlan(dcs, plan);
+  DcFile::TrackRecorder recorder;
+  model.MakeTrack(plan, recorder);
+  const TrackPoint& target = recorder.m_track[recorder.m_track.size() - 2];
+
+  ThreadPool pool;
+  StartSweep sweep(g_wind, g_polar, StartSweepSettings(), &pool);
+  std::vector<Departure> departures;
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state)
+    sweep.SweepDcs(plan, Synthetic::kStart, Synthetic::kStart + 3 * 86400,
+                   target.m_lat, target.m_lon, departures);
+  state.SetItemsProcessed(state.iterations() * departures.size());
+  state.counters["allocs/departure"] =
+      static_cast<double>(Allocations::GetCount() - allocations) /
+      (state.iterations() * departures.size());
+  size_t best = StartSweep::GetBest(departures);
+  state.counters["best hours"] = departures[best].GetDuration() / 3600.0;
+}
+
+/// Monte Carlo runs of a three day plan (432 DCs) on all cores, with a
+/// waypoint every day
+void BM_Robustness(benchmark::State& state) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(432);
+  model.EnrichDcs(dcs);
+  DcModel::Plan plan;
+  model.MakePlan(dcs, plan);
+  DcFile::TrackRecorder recorder;
+  model.MakeTrack(plan, recorder);
+  std::vector<std::pair<double, double>> waypoints;
+  for (size_t i = 144; i < recorder.m_track.size(); i += 144)
+    waypoints.emplace_back(recorder.m_track[i].m_lat,
+                           recorder.m_track[i].m_lon);
+
+  ThreadPool pool;
+  RobustnessSettings settings;
+  settings.m_runs = state.range(0);
+  Robustness robustness(g_wind, g_polar, settings, &pool);
+  RobustnessResult result;
+  size_t allocations = Allocations::GetCount();
+  for (auto _ : state) robustness.Evaluate(plan, waypoints, result);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["allocs/run"] =
+      static_cast<double>(Allocations::GetCount() - allocations) /
+      (state.iterations() * state.range(0));
+  state.counters["reached"] =
+      static_cast<double>(result.m_etas.front().m_reached);
+}
+}  // namespace
+
+BENCHMARK(BM_CompileDcs)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_EnrichDcs)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_SimplifyDcs)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_OptimizeManeuvers)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_MakeTrack)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_MakeLedger)->Arg(10)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMicrosecond);
+BENCHMARK(BM_SavePlan)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadPlan)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PlanCommit)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DriftUpdate)
+    ->ArgsProduct({{10, 1000, 100000}, {1, 0}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DcTiming)->Arg(36)->Arg(144)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartSweepDcs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Robustness)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Geodesy.h"
+#include "Leaderboard.h"
+#include "Synthetic.h"
+#include "TraceStore.h"
+
+namespace {
+/// Points of a track with the positions of MakeDcs()
+struct Track {
+  std::vector<double> m_lat, m_lon, m_brg, m_dist;
+
+  explicit Track(size_t n) : m_brg(n), m_dist(n) {
+    for (const auto& dc : Synthetic::MakeDcs(n)) {
+      m_lat.push_back(dc.m_lat_start);
+      m_lon.push_back(dc.m_lon_start);
+    }
+  }
+};
+
+/// Segments of a track one at a time
+void BM_TrackSingle(benchmark::State& state) {
+  Track track(state.range(0));
+  for (auto _ : state) {
+    for (size_t i = 0; i + 1 < track.m_lat.size(); ++i)
+      Geodesy::DistanceBearingMercator(
+          track.m_lat[i + 1], track.m_lon[i + 1], track.m_lat[i],
+          track.m_lon[i], &track.m_brg[i], &track.m_dist[i]);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// The same segments in one batch
+void BM_TrackBatch(benchmark::State& state) {
+  Track track(state.range(0));
+  for (auto _ : state) {
+    Geodesy::TrackDistanceBearingMercator(track.m_lat.size(),
+                                          track.m_lat.data(),
+                                          track.m_lon.data(),
+                                          track.m_brg.data(),
+                                          track.m_dist.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Fleet refreshes of a race across the Atlantic with five waypoints: the
+/// boats are spread over the course and sail 0.1 nm per refresh. Every
+/// refresh ranks the top ten
+void BM_Leaderboard(benchmark::State& state) {
+  const std::vector<std::pair<double, double>> course = {
+      {50.0, -5.0}, {45.0, -20.0}, {40.0, -35.0}, {30.0, -50.0},
+      {25.0, -65.0}};
+  const size_t n = state.range(0);
+  std::vector<int64_t> ids(n);
+  std::vector<double> lat(n), lon(n);
+  for (size_t i = 0; i < n; ++i) {
+    // Golden ratio spacing along the course, and up to 30 nm off it
+    double along = std::fmod(i * 0.618034, 1.0) * (course.size() - 1);
+    size_t leg = static_cast<size_t>(along);
+    double f = along - leg;
+    ids[i] = 100000 + i;
+    lat[i] = course[leg].first + f * (course[leg + 1].first -
+                                      course[leg].first) +
+             0.5 * std::sin(i * 1.3);
+    lon[i] = course[leg].second +
+             f * (course[leg + 1].second - course[leg].second);
+  }
+
+  Leaderboard leaderboard(course);
+  leaderboard.Update(n, ids.data(), lat.data(), lon.data());
+  std::vector<Leaderboard::Entry> top;
+  for (auto _ : state) {
+    for (auto& l : lon) l -= 0.1 / 60.0 / std::cos(40.0 * Geodesy::kDegToRad);
+    leaderboard.Update(n, ids.data(), lat.data(), lon.data());
+    leaderboard.GetTop(10, top);
+    benchmark::DoNotOptimize(top.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Playback of the traces of a fleet over two weeks, one point per boat and
+/// ten minutes, the boats sailing 8 to 12 kn and changing course every six
+/// hours. Every frame interpolates the positions of all boats one minute
+/// later
+void BM_TracePlayback(benchmark::State& state) {
+  static constexpr size_t kPoints = 14 * 24 * 6;
+  static constexpr std::time_t kInterval = 600;
+  const size_t n = state.range(0);
+  TraceStore store;
+  for (size_t i = 0; i < n; ++i) {
+    double lat = 40.0 + 0.01 * i, lon = -10.0;
+    double speed = 8.0 + 4.0 * std::fmod(i * 0.618034, 1.0);
+    double course = 0.0;
+    for (size_t j = 0; j < kPoints; ++j) {
+      if (j % 36 == 0) course = std::fmod(200.0 + 37.0 * (i + j / 36), 90.0);
+      double nm = speed * kInterval / 3600.0;
+      lat += nm / 60.0 * std::cos(course * Geodesy::kDegToRad);
+      lon += nm / 60.0 * std::sin(course * Geodesy::kDegToRad) /
+             std::cos(lat * Geodesy::kDegToRad);
+      store.Append(i, {static_cast<std::time_t>(Synthetic::kStart +
+                                                j * kInterval),
+                       lat, lon});
+    }
+  }
+
+  std::time_t t = Synthetic::kStart;
+  double lat, lon;
+  for (auto _ : state) {
+    t += 60;
+    if (t >= Synthetic::kStart + static_cast<std::time_t>(kPoints - 1) *
+                                     kInterval)
+      t = Synthetic::kStart;
+    for (size_t i = 0; i < n; ++i) {
+      store.GetPosition(i, t, lat, lon);
+      benchmark::DoNotOptimize(lat);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_point"] =
+      static_cast<double>(store.GetEncodedSize()) / (n * kPoints);
+}
+}  // namespace
+
+BENCHMARK(BM_TrackSingle)->Arg(10)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackBatch)->Arg(10)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Leaderboard)->Arg(10)->Arg(5000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TracePlayback)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "Router.h"
+#include "StartSweep.h"
+#include "Synthetic.h"
+#include "ThreadPool.h"
+
+namespace {
+/// Route over range(0) nm due south, a beam reach in the synthetic westerly,
+/// on range(1) threads (0: one per core)
+void BM_Route(benchmark::State& state) {
+  const Synthetic::WindField wind;
+  const Synthetic::BoatPolar polar;
+  ThreadPool pool(state.range(1) == 0 ? std::thread::hardware_concurrency()
+                                      : state.range(1) - 1);
+  Router router(wind, polar, RouterSettings(), &pool);
+
+  const TrackPoint start{Synthetic::kStart, 45.0, -30.0};
+  const std::vector<std::pair<double, double>> waypoints{
+      {45.0 - state.range(0) / 60.0, -30.0}};
+  std::vector<RoutePoint> route;
+  for (auto _ : state) {
+    if (!router.Route(start, waypoints, route)) {
+      state.SkipWithError("Waypoint not reached");
+      break;
+    }
+  }
+
+  state.counters["isochrones"] = static_cast<double>(route.size());
+  state.counters["hours"] =
+      std::difftime(route.back().m_time, route.front().m_time) / 3600.0;
+}
+
+/// Routes over 100 nm due south, departing every three hours for range(0)
+/// days, on all cores
+void BM_StartSweepRoutes(benchmark::State& state) {
+  const Synthetic::WindField wind;
+  const Synthetic::BoatPolar polar;
+  ThreadPool pool;
+  StartSweepSettings settings;
+  settings.m_interval = 3 * 3600;
+  StartSweep sweep(wind, polar, settings, &pool);
+
+  const std::vector<std::pair<double, double>> waypoints{
+      {45.0 - 100.0 / 60.0, -30.0}};
+  std::vector<Departure> departures;
+  for (auto _ : state)
+    sweep.SweepRoutes(45.0, -30.0, waypoints, Synthetic::kStart,
+                      Synthetic::kStart + state.range(0) * 86400,
+                      departures);
+
+  size_t best = StartSweep::GetBest(departures);
+  state.SetItemsProcessed(state.iterations() * departures.size());
+  state.counters["best hours"] =
+      best < departures.size() ? departures[best].GetDuration() / 3600.0
+                               : NAN;
+}
+}  // namespace
+
+BENCHMARK(BM_Route)
+    ->Args({100, 1})
+    ->Args({1000, 1})
+    ->Args({1000, 0})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartSweepRoutes)->Arg(1)->Unit(benchmark::kMillisecond);
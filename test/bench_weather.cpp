@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "SolFile.h"
+#include "Synthetic.h"
+#include "WindGrid.h"
+
+namespace {
+/// Weather XML of a race parsed into a grid, as on the first download of a
+/// forecast
+void BM_WeatherParse(benchmark::State& state) {
+  std::string xml = Synthetic::MakeWeatherXml(state.range(0));
+  for (auto _ : state) {
+    WindGrid grid;
+    if (!grid.Parse(xml)) state.SkipWithError("Parse failed");
+    benchmark::DoNotOptimize(grid);
+  }
+  state.SetBytesProcessed(state.iterations() * xml.size());
+}
+
+/// The same grid mapped from the binary cache, as on every later use
+void BM_WeatherLoadBinary(benchmark::State& state) {
+  WindGrid grid;
+  grid.Parse(Synthetic::MakeWeatherXml(state.range(0)));
+  std::string path = "sailonline_bench_weather.bin";
+  if (!grid.SaveBinary(path)) state.SkipWithError("SaveBinary failed");
+  for (auto _ : state) {
+    WindGrid cached;
+    if (!cached.LoadBinary(path)) state.SkipWithError("LoadBinary failed");
+    benchmark::DoNotOptimize(cached);
+  }
+  std::remove(path.c_str());
+}
+
+/// Points spread over the grid and the forecast, in time order like the
+/// points of a track
+struct WindPoints {
+  std::vector<std::time_t> m_t;
+  std::vector<double> m_lat, m_lon, m_tws, m_twd;
+
+  explicit WindPoints(size_t n)
+      : m_t(n), m_lat(n), m_lon(n), m_tws(n), m_twd(n) {
+    for (size_t i = 0; i < n; ++i) {
+      m_t[i] = Synthetic::kStart + i * (24 * 3600) / n;
+      m_lat[i] = 30.5 + (i * 7919 % 2900) / 100.0;
+      m_lon[i] = -39.5 + (i * 104729 % 3900) / 100.0;
+    }
+  }
+};
+
+const WindGrid& weather() {
+  static const WindGrid grid = []() {
+    WindGrid g;
+    g.Parse(Synthetic::MakeWeatherXml(10));
+    return g;
+  }();
+  return grid;
+}
+
+/// One lookup per point, as by the DC algorithms
+void BM_WindSingle(benchmark::State& state) {
+  WindPoints points(state.range(0));
+  for (auto _ : state)
+    for (size_t i = 0; i < points.m_t.size(); ++i)
+      benchmark::DoNotOptimize(weather().GetWindData(
+          points.m_t[i], points.m_lat[i], points.m_lon[i]));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// All points at once with the kernel level of the second argument
+void BM_WindBatch(benchmark::State& state) {
+  auto level = static_cast<WindKernel::Level>(state.range(1));
+  if (level > WindKernel::GetBestLevel()) {
+    state.SkipWithError("Not supported by the CPU");
+    return;
+  }
+  WindGrid grid = weather();
+  grid.SetKernelLevel(level);
+  state.SetLabel(WindKernel::GetName(level));
+  WindPoints points(state.range(0));
+  for (auto _ : state) {
+    grid.GetWindDataBatch(points.m_t.size(), points.m_t.data(),
+                          points.m_lat.data(), points.m_lon.data(),
+                          points.m_tws.data(), points.m_twd.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_WeatherParse)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WeatherLoadBinary)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_WindSingle)->Arg(10)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_WindBatch)
+    ->ArgsProduct({{10, 100000},
+                   {static_cast<int>(WindKernel::Level::kScalar),
+                    static_cast<int>(WindKernel::Level::kSse41),
+                    static_cast<int>(WindKernel::Level::kAvx2)}})
+    ->Unit(benchmark::kMicrosecond);
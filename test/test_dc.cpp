@@ -0,0 +1,491 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// Unit tests of the DC files, the performance ledger, the plan history, the
+// drift monitor and the DC timing
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DcFile.h"
+#include "DcModel.h"
+#include "DcTiming.h"
+#include "DriftMonitor.h"
+#include "PerformanceLedger.h"
+#include "PlanHistory.h"
+#include "SolFile.h"
+#include "Synthetic.h"
+
+namespace {
+const Synthetic::WindField g_wind;
+const Synthetic::BoatPolar g_polar;
+
+/// 10 kn from the north everywhere
+class SteadyWind : public WindProvider {
+public:
+  std::pair<double, double> GetWindData(std::time_t t, double lat,
+                                        double lon) const override {
+    return {10.0, 0.0};
+  }
+};
+
+/// 6 kn at any wind and angle
+class SteadyPolar : public PolarProvider {
+public:
+  double GetSpeedThroughWater(double tws, double twa) const override {
+    return 6.0;
+  }
+  std::pair<double, double> GetBoatOptimalAngles(double tws) const override {
+    return {45.0, 150.0};
+  }
+};
+
+void ExpectSameDcs(const std::list<Dc>& expected, const std::list<Dc>& actual,
+                   bool positions) {
+  ASSERT_EQ(expected.size(), actual.size());
+  auto a = actual.begin();
+  for (const auto& e : expected) {
+    EXPECT_EQ(e.m_timestamp, a->m_timestamp);
+    EXPECT_EQ(e.m_is_twa, a->m_is_twa);
+    EXPECT_NEAR(e.m_is_twa ? e.m_twa : e.m_course,
+                a->m_is_twa ? a->m_twa : a->m_course, 1e-9);
+    if (positions) {
+      EXPECT_NEAR(e.m_lat_start, a->m_lat_start, 1e-6);
+      EXPECT_NEAR(e.m_lon_start, a->m_lon_start, 1e-6);
+    }
+    ++a;
+  }
+}
+
+TEST(DcFile, ListIsUtc) {
+  std::list<Dc> dcs;
+  std::string error;
+  ASSERT_TRUE(DcFile::ParseDcList("# Comment\n\n2026/01/01 12:00:00 cc 180\n"
+                                  "2026/01/01 12:10:00 twa -45 44.5 -10.25\n",
+                                  dcs, error))
+      << error;
+  ASSERT_EQ(dcs.size(), 2u);
+  EXPECT_EQ(dcs.front().m_timestamp, Synthetic::kStart);
+  EXPECT_FALSE(dcs.front().m_is_twa);
+  EXPECT_EQ(dcs.front().m_course, 180.0);
+  EXPECT_EQ(dcs.front().m_lat_start, -1.0);
+  EXPECT_EQ(dcs.back().m_timestamp, Synthetic::kStart + 600);
+  EXPECT_TRUE(dcs.back().m_is_twa);
+  EXPECT_EQ(dcs.back().m_twa, -45.0);
+  EXPECT_EQ(dcs.back().m_lat_start, 44.5);
+  EXPECT_EQ(dcs.back().m_lon_start, -10.25);
+
+  EXPECT_FALSE(DcFile::ParseDcList("2026/01/01 12:00:00 xx 180\n", dcs, error));
+  EXPECT_FALSE(error.empty());
+}
+
+TEST(DcFile, ListRoundTrip) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(20);
+  model.EnrichDcs(dcs);
+
+  std::list<Dc> parsed;
+  std::string error;
+  ASSERT_TRUE(DcFile::ParseDcList(DcFile::FormatDcList(dcs, true), parsed,
+                                  error))
+      << error;
+  ExpectSameDcs(dcs, parsed, true);
+}
+
+TEST(DcFile, PlanRoundTrip) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(20);
+  model.EnrichDcs(dcs);
+  std::string plan = DcFile::FormatDcPlan(dcs);
+
+  std::list<Dc> parsed;
+  std::string error;
+  ASSERT_TRUE(DcFile::ParseDcPlan(plan, parsed, error)) << error;
+  ExpectSameDcs(dcs, parsed, true);
+
+  // Every truncation is detected
+  for (size_t size = 0; size < plan.size(); size += 7)
+    EXPECT_FALSE(DcFile::ParseDcPlan(plan.substr(0, size), parsed, error));
+  plan[0] = 'X';
+  EXPECT_FALSE(DcFile::ParseDcPlan(plan, parsed, error));
+}
+
+TEST(DcFile, GpxRoundTrip) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(10);
+  model.EnrichDcs(dcs);
+  DcFile::TrackRecorder recorder;
+  model.MakeTrack(dcs, recorder);
+
+  std::vector<TrackPoint> track;
+  std::string error;
+  ASSERT_TRUE(DcFile::ParseGpxTrack(
+      DcFile::FormatGpxTrack(recorder.m_track, "test"), track, error))
+      << error;
+  ASSERT_EQ(track.size(), recorder.m_track.size());
+  for (size_t i = 0; i < track.size(); ++i) {
+    EXPECT_EQ(track[i].m_time, recorder.m_track[i].m_time);
+    EXPECT_NEAR(track[i].m_lat, recorder.m_track[i].m_lat, 1e-6);
+    EXPECT_NEAR(track[i].m_lon, recorder.m_track[i].m_lon, 1e-6);
+  }
+}
+
+TEST(SolFile, BackgroundWriterWritesLastVersion) {
+  std::string path = testing::TempDir() + "sol_background_writer.txt";
+  {
+    SolFile::BackgroundWriter writer;
+    for (int i = 0; i < 100; ++i) writer.Write(path, std::to_string(i));
+    writer.Flush();
+    EXPECT_TRUE(writer.GetErrors().empty());
+    std::string contents;
+    ASSERT_TRUE(SolFile::Read(path, contents));
+    EXPECT_EQ(contents, "99");
+    writer.Write(path, "100");
+  }
+  // The destructor writes what is queued
+  std::string contents;
+  ASSERT_TRUE(SolFile::Read(path, contents));
+  EXPECT_EQ(contents, "100");
+  std::remove(path.c_str());
+}
+
+TEST(SolFile, ConcurrentWritesOfOneFile) {
+  // E.g. two races with the same boat exporting its polar
+  std::string path = testing::TempDir() + "sol_concurrent.txt";
+  std::atomic<int> failed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      std::string contents(10000, static_cast<char>('a' + t));
+      std::string error;
+      for (int i = 0; i < 50; ++i)
+        if (!SolFile::WriteAtomic(path, contents, error)) ++failed;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(failed, 0);
+
+  std::string contents;
+  ASSERT_TRUE(SolFile::Read(path, contents));
+  ASSERT_EQ(contents.size(), 10000u);
+  EXPECT_EQ(contents, std::string(10000, contents[0]));
+  std::remove(path.c_str());
+}
+
+TEST(SolFile, CreatesDirectories) {
+  std::string dir = testing::TempDir() + "sol_dirs";
+  std::string path = dir + "/a/b/file.txt";
+  ASSERT_TRUE(SolFile::CreateDirectories(dir + "/a/b"));
+  // Existing directories are fine
+  ASSERT_TRUE(SolFile::CreateDirectories(dir + "/a/b/"));
+  std::string error;
+  ASSERT_TRUE(SolFile::WriteAtomic(path, "x", error));
+  // A file is not a directory
+  EXPECT_FALSE(SolFile::CreateDirectories(path));
+  std::remove(path.c_str());
+  std::remove((dir + "/a/b").c_str());
+  std::remove((dir + "/a").c_str());
+  std::remove(dir.c_str());
+}
+
+TEST(PerformanceLedger, ManeuversLoseDistance) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(12);
+  model.EnrichDcs(dcs);
+  PerformanceLedger ledger;
+  model.MakeTrack(dcs, ledger);
+
+  ASSERT_EQ(ledger.GetEntries().size(), dcs.size());
+  EXPECT_GT(ledger.GetTotalLoss(), 0.0);
+  for (const auto& entry : ledger.GetEntries()) {
+    EXPECT_GE(entry.GetLoss(), -1e-9);
+    EXPECT_LE(entry.m_sailed, entry.m_ideal + 1e-9);
+  }
+  // The tack between the third and the fourth DC costs
+  const PerformanceLedger::Entry* tack =
+      ledger.Find(Synthetic::kStart + 3 * 600);
+  ASSERT_NE(tack, nullptr);
+  EXPECT_LT(tack->m_performance, 1.0);
+  EXPECT_GT(tack->GetLoss(), 0.0);
+  EXPECT_EQ(ledger.Find(Synthetic::kStart + 1), nullptr);
+}
+
+TEST(PerformanceLedger, NoManeuversLoseNothing) {
+  SteadyWind wind;
+  SteadyPolar polar;
+  DcModel model(wind, polar);
+  // Legs that are not multiples of the simulation step, all at TWA 90
+  std::list<Dc> dcs;
+  for (std::time_t t : {0, 45, 104})
+    dcs.emplace_back(Synthetic::kStart + t, 45.0, -10.0, 90.0, true);
+  model.EnrichDcs(dcs);
+  PerformanceLedger ledger;
+  model.MakeTrack(dcs, ledger);
+
+  ASSERT_EQ(ledger.GetEntries().size(), 3u);
+  EXPECT_NEAR(ledger.GetEntries()[0].m_sailed, 6.0 * 45.0 / 3600.0, 1e-12);
+  EXPECT_NEAR(ledger.GetEntries()[1].m_sailed, 6.0 * 59.0 / 3600.0, 1e-12);
+  EXPECT_NEAR(ledger.GetTotalLoss(), 0.0, 1e-12);
+}
+
+TEST(PerformanceLedger, SameTimeDcsMakeEmptyLeg) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(6);
+  // A second DC at the time of the third, the first of them is overridden
+  auto third = std::next(dcs.begin(), 2);
+  dcs.insert(third, Dc(third->m_timestamp, third->m_lat_start,
+                       third->m_lon_start, 180.0, false));
+  model.EnrichDcs(dcs);
+  PerformanceLedger ledger;
+  model.MakeTrack(dcs, ledger);
+
+  ASSERT_EQ(ledger.GetEntries().size(), dcs.size());
+  const auto& empty = ledger.GetEntries()[2];
+  EXPECT_EQ(empty.m_sailed, 0.0);
+  EXPECT_EQ(empty.m_ideal, 0.0);
+  EXPECT_GT(ledger.GetEntries()[3].m_sailed, 0.0);
+}
+
+TEST(PlanHistory, UndoRedo) {
+  PlanHistory history;
+  std::list<Dc> a = Synthetic::MakeDcs(50);
+  std::list<Dc> b = a;
+  std::next(b.begin(), 20)->m_course += 10.0;
+
+  EXPECT_TRUE(history.Commit(a));
+  EXPECT_FALSE(history.CanUndo());
+  EXPECT_FALSE(history.Commit(a));
+  EXPECT_TRUE(history.Commit(b));
+  ASSERT_TRUE(history.CanUndo());
+
+  std::list<Dc> dcs;
+  ASSERT_TRUE(history.Undo(dcs));
+  ExpectSameDcs(a, dcs, true);
+  EXPECT_FALSE(history.CanUndo());
+  ASSERT_TRUE(history.Redo(dcs));
+  ExpectSameDcs(b, dcs, true);
+  EXPECT_FALSE(history.Redo(dcs));
+
+  // An edit after an undo drops the redo
+  ASSERT_TRUE(history.Undo(dcs));
+  b.pop_back();
+  EXPECT_TRUE(history.Commit(b));
+  EXPECT_FALSE(history.CanRedo());
+}
+
+TEST(PlanHistory, PositionsArePlanned) {
+  PlanHistory history;
+  std::list<Dc> dcs = Synthetic::MakeDcs(50);
+  EXPECT_TRUE(history.Commit(dcs));
+
+  // The first DC follows the boat, its position is no edit
+  dcs.front().m_lat_start += 0.1;
+  EXPECT_FALSE(history.Commit(dcs));
+  std::list<Dc> current;
+  history.GetCurrent().GetDcs(current);
+  ExpectSameDcs(dcs, current, true);
+
+  // The position of a later DC is
+  std::next(dcs.begin(), 30)->m_lon_start += 0.1;
+  EXPECT_TRUE(history.Commit(dcs));
+  std::list<Dc> previous;
+  ASSERT_TRUE(history.Undo(previous));
+  EXPECT_NEAR(std::next(previous.begin(), 30)->m_lon_start,
+              std::next(dcs.begin(), 30)->m_lon_start - 0.1, 1e-9);
+}
+
+TEST(PlanHistory, KeepAndRestore) {
+  PlanHistory history;
+  std::list<Dc> a = Synthetic::MakeDcs(30);
+  std::list<Dc> b = Synthetic::MakeDcs(40);
+  history.Commit(a);
+  history.Keep("a");
+  history.Commit(b);
+  history.Keep("b");
+  history.Keep("a");  // Replaces the first one
+  ASSERT_EQ(history.GetKept().size(), 2u);
+
+  std::list<Dc> dcs;
+  ASSERT_TRUE(history.Restore(1, dcs));
+  ExpectSameDcs(b, dcs, false);
+  EXPECT_FALSE(history.Restore(2, dcs));
+}
+
+TEST(PlanHistory, EditsShareChunks) {
+  PlanHistory history;
+  std::list<Dc> dcs = Synthetic::MakeDcs(1000);
+  history.Commit(dcs);
+  for (int i = 0; i < 10; ++i) {
+    std::next(dcs.begin(), 100 * i + 50)->m_course += 1.0;
+    history.Commit(dcs);
+  }
+  // Every edit stores a few chunks, not the whole plan
+  EXPECT_LT(history.GetStoredDcs(), 2000u);
+}
+
+/// An hour due east at 6 kn, the boat starts at the first DC
+class DriftTest : public ::testing::Test {
+protected:
+  SteadyWind m_wind;
+  SteadyPolar m_polar;
+  DcModel m_model{m_wind, m_polar};
+  std::list<Dc> m_dcs;
+  DcModel::Anchor m_start;
+
+  void SetUp() override {
+    for (int i = 0; i < 6; ++i)
+      m_dcs.emplace_back(Synthetic::kStart + i * 600, 45.0, -10.0, 90.0,
+                         false);
+    m_model.EnrichDcs(m_dcs);
+    m_start = {Synthetic::kStart, 45.0, -10.0, 90.0, 90.0, false, 1.0};
+  }
+
+  /// The state on the projection of monitor at t, moved north by nm
+  static DcModel::Anchor OnProjection(const DriftMonitor& monitor,
+                                      std::time_t t, double nm,
+                                      const DcModel::Anchor& start) {
+    auto projection = monitor.GetProjection();
+    auto next = std::find_if(
+        projection.begin(), projection.end(),
+        [t](const TrackPoint& point) { return point.m_time >= t; });
+    EXPECT_TRUE(next != projection.end() && next->m_time == t);
+    DcModel::Anchor actual = start;
+    actual.m_time = t;
+    actual.m_lat = next->m_lat + nm / 60.0;
+    actual.m_lon = next->m_lon;
+    return actual;
+  }
+};
+
+TEST_F(DriftTest, SimulatesOnlyOffTheProjection) {
+  DriftMonitor monitor;
+  monitor.SetPlan(m_model, m_dcs, m_start);
+  EXPECT_EQ(monitor.GetSimulations(), 1u);
+
+  // Sailing as projected is a lookup
+  for (int i = 1; i <= 3; ++i) {
+    auto drift = monitor.Update(
+        m_model, m_dcs,
+        OnProjection(monitor, m_start.m_time + i * 600, 0.0, m_start));
+    EXPECT_NEAR(drift.m_distance, 0.0, 1e-6);
+    EXPECT_FALSE(drift.m_exceeded);
+  }
+  EXPECT_EQ(monitor.GetSimulations(), 1u);
+
+  // Off the projection the DCs are simulated from the actual state
+  auto actual = OnProjection(monitor, m_start.m_time + 2400, 0.2, m_start);
+  auto drift = monitor.Update(m_model, m_dcs, actual);
+  EXPECT_NEAR(drift.m_distance, 0.2, 1e-3);
+  EXPECT_FALSE(drift.m_exceeded);
+  EXPECT_EQ(monitor.GetSimulations(), 2u);
+  EXPECT_EQ(monitor.GetProjection().front().m_time, actual.m_time);
+  EXPECT_NEAR(monitor.GetProjection().front().m_lat, actual.m_lat, 1e-9);
+
+  // The new projection is followed, still 0.2 nm off the plan
+  drift = monitor.Update(
+      m_model, m_dcs,
+      OnProjection(monitor, m_start.m_time + 3000, 0.0, m_start));
+  EXPECT_NEAR(drift.m_distance, 0.2, 1e-3);
+  EXPECT_EQ(monitor.GetSimulations(), 2u);
+}
+
+TEST_F(DriftTest, ExceedsTheLimits) {
+  DriftMonitor monitor(0.5, 0.02);
+  monitor.SetPlan(m_model, m_dcs, m_start);
+  std::time_t t = m_start.m_time + 1800;
+
+  EXPECT_FALSE(
+      monitor.Update(m_model, m_dcs, OnProjection(monitor, t, 0.4, m_start))
+          .m_exceeded);
+  monitor.SetPlan(m_model, m_dcs, m_start);
+  EXPECT_TRUE(
+      monitor.Update(m_model, m_dcs, OnProjection(monitor, t, 0.6, m_start))
+          .m_exceeded);
+
+  monitor.SetPlan(m_model, m_dcs, m_start);
+  auto actual = OnProjection(monitor, t, 0.0, m_start);
+  actual.m_performance = 0.99;
+  auto drift = monitor.Update(m_model, m_dcs, actual);
+  EXPECT_NEAR(drift.m_performance, -0.01, 1e-9);
+  EXPECT_FALSE(drift.m_exceeded);
+  actual.m_performance = 0.97;
+  EXPECT_TRUE(monitor.Update(m_model, m_dcs, actual).m_exceeded);
+
+  // Not covered by the plan
+  actual.m_time = m_start.m_time + 86400;
+  drift = monitor.Update(m_model, m_dcs, actual);
+  EXPECT_TRUE(std::isnan(drift.m_distance));
+  EXPECT_FALSE(drift.m_exceeded);
+}
+
+TEST(DcTiming, KeepsTheDcsUpToTheMinimumTime) {
+  DcModel model(g_wind, g_polar);
+  std::list<Dc> dcs = Synthetic::MakeDcs(36);
+  model.EnrichDcs(dcs);
+  DcModel::Plan planned;
+  model.MakePlan(dcs, planned);
+  DcFile::TrackRecorder recorder;
+  model.MakeTrack(planned, recorder);
+  const TrackPoint& target = recorder.m_track[recorder.m_track.size() - 2];
+
+  // Without a bound the early DCs move as well
+  DcTimingSettings settings;
+  settings.m_max_course_change = 10.0;
+  DcModel::Plan plan = planned;
+  DcTimingResult result;
+  DcTiming unbounded(g_wind, g_polar, settings);
+  ASSERT_TRUE(unbounded.Optimize(plan, target.m_lat, target.m_lon, result));
+  std::time_t min_time = Synthetic::kStart + 12 * 600;
+  bool moved = false;
+  auto leg = plan.m_legs.begin();
+  for (const auto& dc : planned.m_legs) {
+    if (dc.m_timestamp <= min_time)
+      moved = moved || leg->m_timestamp != dc.m_timestamp ||
+              leg->m_course != dc.m_course || leg->m_twa != dc.m_twa;
+    ++leg;
+  }
+  EXPECT_TRUE(moved);
+
+  settings.m_min_time = min_time;
+  plan = planned;
+  DcTiming timing(g_wind, g_polar, settings);
+  ASSERT_TRUE(timing.Optimize(plan, target.m_lat, target.m_lon, result));
+  EXPECT_GT(result.m_changed, 0u);
+  ASSERT_EQ(plan.m_legs.size(), planned.m_legs.size());
+  leg = plan.m_legs.begin();
+  for (const auto& dc : planned.m_legs) {
+    if (dc.m_timestamp <= min_time) {
+      EXPECT_EQ(leg->m_timestamp, dc.m_timestamp);
+      EXPECT_EQ(leg->m_course, dc.m_course);
+      EXPECT_EQ(leg->m_twa, dc.m_twa);
+    } else {
+      EXPECT_GT(leg->m_timestamp, min_time);
+    }
+    ++leg;
+  }
+}
+}  // namespace
@@ -0,0 +1,229 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// Unit tests of the leaderboard and the trace store of the fleet
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Geodesy.h"
+#include "Leaderboard.h"
+#include "TraceStore.h"
+
+namespace {
+/// Nm per degree of a great circle
+static constexpr double kDegreeNm =
+    Geodesy::kEarthRadiusNm * Geodesy::kDegToRad;
+
+/// Two legs of 60 nm east along the equator
+const std::vector<std::pair<double, double>> kCourse = {
+    {0.0, 0.0}, {0.0, 1.0}, {0.0, 2.0}};
+
+void Update(Leaderboard& leaderboard, std::vector<int64_t> ids,
+            std::vector<double> lat, std::vector<double> lon) {
+  leaderboard.Update(ids.size(), ids.data(), lat.data(), lon.data());
+}
+
+TEST(Leaderboard, RanksByDistanceToFinish) {
+  Leaderboard leaderboard(kCourse);
+  Update(leaderboard, {1, 2, 3}, {0.0, 0.0, 0.1}, {1.5, 0.5, 1.8});
+  ASSERT_EQ(leaderboard.GetSize(), 3u);
+
+  std::vector<Leaderboard::Entry> top;
+  leaderboard.GetTop(3, top);
+  ASSERT_EQ(top.size(), 3u);
+  EXPECT_EQ(top[0].m_id, 3);
+  EXPECT_EQ(top[0].m_next, 2u);
+  EXPECT_NEAR(top[0].m_dtf,
+              Geodesy::DistanceGreatCircle(0.0, 2.0, 0.1, 1.8), 1e-6);
+  EXPECT_EQ(top[1].m_id, 1);
+  EXPECT_NEAR(top[1].m_dtf, 0.5 * kDegreeNm, 1e-6);
+  // Still on the first leg, the second one is added
+  EXPECT_EQ(top[2].m_id, 2);
+  EXPECT_EQ(top[2].m_next, 1u);
+  EXPECT_NEAR(top[2].m_dtf, 1.5 * kDegreeNm, 1e-6);
+
+  EXPECT_EQ(leaderboard.GetRank(0.0), 1u);
+  EXPECT_EQ(leaderboard.GetRank(60.0), 3u);
+  EXPECT_EQ(leaderboard.GetRank(1000.0), 4u);
+  EXPECT_EQ(leaderboard.GetNextWaypoint(0.0, 0.5), 1u);
+  EXPECT_NEAR(leaderboard.GetDtf(0.0, 0.5, 1), 1.5 * kDegreeNm, 1e-6);
+}
+
+TEST(Leaderboard, BoatsOnlyAdvance) {
+  Leaderboard leaderboard(kCourse);
+  std::vector<Leaderboard::Entry> top;
+  Update(leaderboard, {1}, {0.0}, {0.5});
+  leaderboard.GetTop(1, top);
+  EXPECT_EQ(top[0].m_next, 1u);
+
+  // Beyond the line across the first leg, 1.2 nm north of the waypoint
+  Update(leaderboard, {1}, {0.02}, {1.001});
+  leaderboard.GetTop(1, top);
+  EXPECT_EQ(top[0].m_next, 2u);
+  // Back on the first leg, the waypoint stays rounded
+  Update(leaderboard, {1}, {0.0}, {0.9});
+  leaderboard.GetTop(1, top);
+  EXPECT_EQ(top[0].m_next, 2u);
+  EXPECT_NEAR(top[0].m_dtf, 1.1 * kDegreeNm, 1e-6);
+}
+
+TEST(Leaderboard, FinishedBoatsRankByFinish) {
+  Leaderboard leaderboard(kCourse);
+  Update(leaderboard, {1, 2, 3}, {0.0, 0.0, 0.0}, {1.9, 1.95, 1.0});
+  // Boat 1 finishes first, boat 2 later but closer to the finish line
+  Update(leaderboard, {1, 2, 3}, {0.0, 0.0, 0.0}, {2.01, 1.98, 1.5});
+  Update(leaderboard, {1, 2, 3}, {0.0, 0.0, 0.0}, {2.5, 2.001, 1.6});
+
+  std::vector<Leaderboard::Entry> top;
+  leaderboard.GetTop(3, top);
+  ASSERT_EQ(top.size(), 3u);
+  EXPECT_EQ(top[0].m_id, 1);
+  EXPECT_EQ(top[0].m_dtf, 0.0);
+  EXPECT_EQ(top[0].m_next, kCourse.size());
+  EXPECT_EQ(top[1].m_id, 2);
+  EXPECT_EQ(top[1].m_dtf, 0.0);
+  EXPECT_EQ(top[2].m_id, 3);
+  EXPECT_EQ(leaderboard.GetRank(0.0), 3u);
+}
+
+TEST(Leaderboard, SmallMovesMatchTheDistance) {
+  Leaderboard leaderboard(
+      {{50.0, -5.0}, {45.0, -20.0}, {40.0, -35.0}, {30.0, -50.0}});
+  double lat = 49.0, lon = -6.0;
+  std::vector<Leaderboard::Entry> top;
+  // Sines and cosines are carried over hundreds of updates
+  for (int i = 0; i < 500; ++i) {
+    lat -= 0.002 + 0.001 * std::sin(i * 0.1);
+    lon -= 0.004;
+    Update(leaderboard, {7}, {lat}, {lon});
+  }
+  leaderboard.GetTop(1, top);
+  ASSERT_EQ(top.size(), 1u);
+  EXPECT_NEAR(top[0].m_dtf, leaderboard.GetDtf(lat, lon, top[0].m_next),
+              1e-6);
+}
+
+/// Points every ten minutes for ten hours, on a course that changes every
+/// hour, with a gap of an hour in the middle
+std::vector<TrackPoint> MakeTrace(double lat, double lon) {
+  std::vector<TrackPoint> trace;
+  std::time_t t = 1767268800;
+  for (int i = 0; i < 200; ++i) {
+    trace.push_back({t, lat, lon});
+    t += i == 100 ? 3600 : 600;
+    lat += 0.01 * std::sin(i / 6 * 0.7);
+    lon -= 0.015;
+  }
+  return trace;
+}
+
+void ExpectSameTrace(const std::vector<TrackPoint>& expected,
+                     const std::vector<TrackPoint>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].m_time, actual[i].m_time);
+    EXPECT_NEAR(expected[i].m_lat, actual[i].m_lat, TraceStore::kResolution);
+    EXPECT_NEAR(expected[i].m_lon, actual[i].m_lon, TraceStore::kResolution);
+  }
+}
+
+TEST(TraceStore, KeepsThePoints) {
+  TraceStore store;
+  auto a = MakeTrace(45.0, -10.0);
+  auto b = MakeTrace(-30.0, 179.0);
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_TRUE(store.Append(1002, a[i]));
+    EXPECT_TRUE(store.Append(17, b[i]));
+  }
+  // Overlapping refreshes are skipped
+  EXPECT_FALSE(store.Append(17, b[150]));
+  EXPECT_EQ(store.GetBoats(), std::vector<int64_t>({17, 1002}));
+  EXPECT_EQ(store.GetPointCount(17), b.size());
+
+  std::time_t first, last;
+  ASSERT_TRUE(store.GetTimeRange(1002, first, last));
+  EXPECT_EQ(first, a.front().m_time);
+  EXPECT_EQ(last, a.back().m_time);
+  EXPECT_FALSE(store.GetTimeRange(5, first, last));
+
+  std::vector<TrackPoint> points;
+  store.GetTrace(1002, a.front().m_time, a.back().m_time, points);
+  ExpectSameTrace(a, points);
+  // A range across blocks, bounds included
+  points.clear();
+  store.GetTrace(17, b[60].m_time, b[130].m_time, points);
+  ExpectSameTrace(std::vector<TrackPoint>(b.begin() + 60, b.begin() + 131),
+                  points);
+
+  // About three bytes per point
+  EXPECT_LT(store.GetEncodedSize(), 5 * 2 * a.size());
+}
+
+TEST(TraceStore, InterpolatesPositions) {
+  TraceStore store;
+  auto trace = MakeTrace(45.0, -10.0);
+  for (const auto& point : trace) store.Append(3, point);
+
+  double lat, lon;
+  for (size_t i : {0, 63, 64, 100, 150}) {
+    const TrackPoint& from = trace[i];
+    const TrackPoint& to = trace[i + 1];
+    std::time_t t = from.m_time + (to.m_time - from.m_time) / 4;
+    ASSERT_TRUE(store.GetPosition(3, t, lat, lon)) << i;
+    EXPECT_NEAR(lat, from.m_lat + 0.25 * (to.m_lat - from.m_lat),
+                TraceStore::kResolution);
+    EXPECT_NEAR(lon, from.m_lon + 0.25 * (to.m_lon - from.m_lon),
+                TraceStore::kResolution);
+  }
+  ASSERT_TRUE(store.GetPosition(3, trace.back().m_time, lat, lon));
+  EXPECT_NEAR(lat, trace.back().m_lat, TraceStore::kResolution);
+  EXPECT_FALSE(store.GetPosition(3, trace.front().m_time - 1, lat, lon));
+  EXPECT_FALSE(store.GetPosition(3, trace.back().m_time + 1, lat, lon));
+  EXPECT_FALSE(store.GetPosition(4, trace.front().m_time, lat, lon));
+}
+
+TEST(TraceStore, FileRoundTrip) {
+  TraceStore store;
+  auto trace = MakeTrace(45.0, -10.0);
+  for (const auto& point : trace) store.Append(3, point);
+  std::string path = testing::TempDir() + "sol_traces.bin";
+  ASSERT_TRUE(store.Save(path)) << store.GetErrors().front();
+
+  TraceStore loaded;
+  ASSERT_TRUE(loaded.Load(path));
+  EXPECT_EQ(loaded.GetEncodedSize(), store.GetEncodedSize());
+  std::vector<TrackPoint> points;
+  loaded.GetTrace(3, trace.front().m_time, trace.back().m_time, points);
+  ExpectSameTrace(trace, points);
+  // Appending continues the loaded trace
+  TrackPoint next = trace.back();
+  next.m_time += 600;
+  EXPECT_TRUE(loaded.Append(3, next));
+  EXPECT_EQ(loaded.GetPointCount(3), trace.size() + 1);
+  std::remove(path.c_str());
+}
+}  // namespace
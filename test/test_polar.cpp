@@ -0,0 +1,144 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// Unit tests of the polar and its caches
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Polar.h"
+#include "SolFile.h"
+
+namespace {
+static constexpr double kMsToKnots = 3600.0 / 1852.0;
+
+SolXml::Vpp MakeVpp() {
+  SolXml::Vpp vpp;
+  vpp.m_tws_splined = "0 5 10";
+  vpp.m_twa_splined = "0 90 180";
+  vpp.m_bs_splined = "0 0 0; 0 6 10; 0 4 8;";
+  return vpp;
+}
+
+TEST(Polar, Interpolates) {
+  Polar polar;
+  ASSERT_TRUE(polar.Parse(MakeVpp()));
+  ASSERT_EQ(polar.GetTws().size(), 3u);
+  EXPECT_NEAR(polar.GetTws()[2], 10.0 * kMsToKnots, 1e-12);
+
+  EXPECT_DOUBLE_EQ(polar.GetSpeedThroughWater(5.0 * kMsToKnots, 90.0), 6.0);
+  EXPECT_DOUBLE_EQ(polar.GetSpeedThroughWater(5.0 * kMsToKnots, -90.0), 6.0);
+  EXPECT_DOUBLE_EQ(polar.GetSpeedThroughWater(7.5 * kMsToKnots, 135.0), 7.0);
+  // Clamped beyond the strongest wind
+  EXPECT_DOUBLE_EQ(polar.GetSpeedThroughWater(50.0, 90.0), 10.0);
+  EXPECT_EQ(polar.GetSpeedThroughWater(-1.0, 90.0), -1.0);
+}
+
+TEST(Polar, RejectsMalformedData) {
+  Polar polar;
+  SolXml::Vpp vpp = MakeVpp();
+  vpp.m_bs_splined = "0 0 0; 0 6; 0 4 8";
+  EXPECT_FALSE(polar.Parse(vpp));
+  EXPECT_TRUE(polar.IsEmpty());
+  EXPECT_EQ(polar.GetErrors().size(), 1u);
+
+  vpp = MakeVpp();
+  vpp.m_twa_splined = "0 90 90";
+  EXPECT_FALSE(polar.Parse(vpp));
+  vpp = MakeVpp();
+  vpp.m_tws_splined = "0 5 x";
+  EXPECT_FALSE(polar.Parse(vpp));
+  vpp = MakeVpp();
+  vpp.m_tws_splined = "0 5 10.0.0";
+  EXPECT_FALSE(polar.Parse(vpp));
+}
+
+TEST(Polar, ParsesNumbersLikeStrtod) {
+  Polar polar;
+  SolXml::Vpp vpp = MakeVpp();
+  vpp.m_tws_splined = "0 5e0 1.0E1";
+  vpp.m_twa_splined = "-0 +90 180.000";
+  vpp.m_bs_splined =
+      "0 0 0; 0 6.1 10.00000000000000000001; 0 .4e1 0.0000000000000000008e19;";
+  ASSERT_TRUE(polar.Parse(vpp));
+  EXPECT_NEAR(polar.GetTws()[1], 5.0 * kMsToKnots, 1e-12);
+  EXPECT_EQ(polar.GetTwa()[1], 90.0);
+  EXPECT_EQ(polar.GetTwa()[2], 180.0);
+  EXPECT_EQ(polar.GetBs(1, 1), std::strtod("6.1", nullptr));
+  EXPECT_EQ(polar.GetBs(1, 2), 10.0);
+  EXPECT_EQ(polar.GetBs(2, 1), 4.0);
+  EXPECT_EQ(polar.GetBs(2, 2), 8.0);
+}
+
+TEST(Polar, WritesCsv) {
+  Polar polar;
+  SolXml::Vpp vpp = MakeVpp();
+  vpp.m_tws_splined = "0 1852 3704";  // 3600 and 7200 knots
+  vpp.m_bs_splined = "0 0.5 1.25; 0 6 10; 0 4 8;";
+  ASSERT_TRUE(polar.Parse(vpp));
+  std::string path = testing::TempDir() + "sol_polar.csv";
+  ASSERT_TRUE(polar.WriteCsv(path));
+
+  std::string csv;
+  ASSERT_TRUE(SolFile::Read(path, csv));
+  EXPECT_EQ(csv,
+            "twa/tws;0;3600;7200\n0;0;0.5;1.25\n90;0;6;10\n180;0;4;8\n");
+  std::remove(path.c_str());
+}
+
+TEST(Polar, BinaryCacheRoundTrip) {
+  Polar polar;
+  ASSERT_TRUE(polar.Parse(MakeVpp()));
+  std::string path = testing::TempDir() + "sol_polar.bin";
+  ASSERT_TRUE(polar.SaveBinary(path));
+
+  Polar cached;
+  ASSERT_TRUE(cached.LoadBinary(path));
+  EXPECT_EQ(cached.GetTws(), polar.GetTws());
+  EXPECT_EQ(cached.GetTwa(), polar.GetTwa());
+  for (size_t i_twa = 0; i_twa < polar.GetTwa().size(); ++i_twa)
+    for (size_t i_tws = 0; i_tws < polar.GetTws().size(); ++i_tws)
+      EXPECT_EQ(cached.GetBs(i_twa, i_tws), polar.GetBs(i_twa, i_tws));
+
+  // A damaged cache is rejected
+  std::string data;
+  ASSERT_TRUE(SolFile::Read(path, data));
+  std::string error;
+  ASSERT_TRUE(SolFile::WriteAtomic(path, data.substr(0, data.size() - 1),
+                                   error));
+  EXPECT_FALSE(cached.LoadBinary(path));
+  EXPECT_EQ(cached.GetErrors().size(), 1u);
+
+  // So is one of another byte order, the mark follows magic and version
+  const uint32_t swapped = 0x04030201;
+  std::memcpy(&data[12], &swapped, sizeof(swapped));
+  ASSERT_TRUE(SolFile::WriteAtomic(path, data, error));
+  EXPECT_FALSE(cached.LoadBinary(path));
+  std::vector<std::string> errors = cached.GetErrors();
+  ASSERT_EQ(errors.size(), 1u);
+  EXPECT_NE(errors[0].find("byte order"), std::string::npos);
+  std::remove(path.c_str());
+}
+}  // namespace
@@ -0,0 +1,184 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// Unit tests of the DC synchronization against recorded responses of the DC
+// list in the format of SolApi::kSolDcListUrl
+
+#include <ctime>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DcSync.h"
+#include "SolTime.h"
+#include "SolXml.h"
+
+namespace {
+// Unsorted, as the server does not promise an order
+const char* kServerDcs =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<dcs>\n"
+    "  <dc><id>1702</id><time>2026/05/01 18:00:00</time>"
+    "<type>twa</type><value>-135.5</value></dc>\n"
+    "  <dc><id>1701</id><time>2026/05/01 12:00:00</time>"
+    "<type>cc</type><value>245</value></dc>\n"
+    "  <dc><id>1703</id><time>2026/05/02 06:30:00</time>"
+    "<type>cc</type><value>180</value></dc>\n"
+    "</dcs>\n";
+
+// The same list after an edit in the web client: 1702 changed, 1703
+// deleted, 1704 added
+const char* kServerDcsEdited =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<dcs>\n"
+    "  <dc><id>1701</id><time>2026/05/01 12:00:00</time>"
+    "<type>cc</type><value>245</value></dc>\n"
+    "  <dc><id>1702</id><time>2026/05/01 18:00:00</time>"
+    "<type>twa</type><value>-140</value></dc>\n"
+    "  <dc><id>1704</id><time>2026/05/02 09:00:00</time>"
+    "<type>twa</type><value>60</value></dc>\n"
+    "</dcs>\n";
+
+std::time_t Utc(const std::string& text) {
+  std::time_t t = 0;
+  EXPECT_TRUE(SolTime::ParseUtc(text, t)) << text;
+  return t;
+}
+
+std::vector<SolXml::ServerDc> Parse(const std::string& xml) {
+  std::vector<SolXml::ServerDc> dcs;
+  std::string error;
+  EXPECT_TRUE(SolXml::ParseDcList(xml, dcs, error)) << error;
+  return dcs;
+}
+
+TEST(DcSync, ParsesServerList) {
+  auto dcs = Parse(kServerDcs);
+  ASSERT_EQ(dcs.size(), 3u);
+  EXPECT_EQ(dcs[0].m_id, "1701");
+  EXPECT_EQ(dcs[0].m_time, Utc("2026/05/01 12:00:00"));
+  EXPECT_FALSE(dcs[0].m_is_twa);
+  EXPECT_EQ(dcs[0].m_value, 245.0);
+  EXPECT_EQ(dcs[1].m_id, "1702");
+  EXPECT_TRUE(dcs[1].m_is_twa);
+  EXPECT_EQ(dcs[1].m_value, -135.5);
+  EXPECT_EQ(dcs[2].m_id, "1703");
+
+  EXPECT_TRUE(Parse("<dcs/>").empty());
+}
+
+TEST(DcSync, RejectsInvalidDcs) {
+  std::vector<SolXml::ServerDc> dcs;
+  std::string error;
+  EXPECT_FALSE(SolXml::ParseDcList(
+      "<dcs><dc><id>1</id><time>2026/05/01 12:00:00</time><type>gybe</type>"
+      "<value>1</value></dc></dcs>",
+      dcs, error));
+  EXPECT_NE(error.find("Invalid DC 1"), std::string::npos);
+  EXPECT_FALSE(SolXml::ParseDcList(
+      "<dcs><dc><id>2</id><time>tomorrow</time><type>cc</type>"
+      "<value>1</value></dc></dcs>",
+      dcs, error));
+}
+
+TEST(DcSync, AppliesServerChanges) {
+  auto before = Parse(kServerDcs);
+  auto after = Parse(kServerDcsEdited);
+  auto changes = DcSync::Diff(before, after);
+  ASSERT_EQ(changes.size(), 3u);
+  EXPECT_EQ(changes[0].m_kind, DcSync::Change::kModified);
+  EXPECT_EQ(changes[0].m_dc.m_id, "1702");
+  EXPECT_EQ(changes[1].m_kind, DcSync::Change::kRemoved);
+  EXPECT_EQ(changes[1].m_dc.m_id, "1703");
+  EXPECT_EQ(changes[2].m_kind, DcSync::Change::kAdded);
+  EXPECT_EQ(changes[2].m_dc.m_id, "1704");
+
+  // The local list has the first download and a DC planned locally
+  std::list<Dc> dcs;
+  DcSync::Apply(DcSync::Diff({}, before), dcs);
+  ASSERT_EQ(dcs.size(), 3u);
+  dcs.front().m_lat_start = 50.0;
+  dcs.front().m_lon_start = -4.0;
+  dcs.emplace_back(Utc("2026/05/03 00:00:00"), 51.0, -5.0, 90.0, false);
+
+  auto first = DcSync::Apply(changes, dcs);
+  ASSERT_EQ(dcs.size(), 4u);
+  // Enrichment is outdated from the DC before the first change
+  ASSERT_TRUE(first == dcs.begin());
+  EXPECT_EQ(dcs.front().m_lat_start, 50.0);
+  auto dc = std::next(dcs.begin());
+  EXPECT_TRUE(dc->m_is_twa);
+  EXPECT_EQ(dc->m_twa, -140.0);
+  EXPECT_EQ(dc->m_lat_start, -1.0);
+  ++dc;
+  EXPECT_EQ(dc->m_timestamp, Utc("2026/05/02 09:00:00"));
+  EXPECT_EQ(dc->m_twa, 60.0);
+  ++dc;
+  EXPECT_EQ(dc->m_course, 90.0);
+  EXPECT_EQ(dc->m_lat_start, -1.0);
+
+  // Nothing changes on a download of the same list
+  EXPECT_TRUE(DcSync::Apply(DcSync::Diff(after, after), dcs) == dcs.end());
+}
+
+TEST(DcSync, PlansUploadAgainstServerList) {
+  auto server = Parse(kServerDcs);
+  std::list<Dc> dcs;
+  DcSync::Apply(DcSync::Diff({}, server), dcs);
+  // Changed locally: the TWA of the second DC and a new DC at the end
+  std::next(dcs.begin())->m_twa = -120.0;
+  dcs.emplace_back(Utc("2026/05/03 00:00:00"), -1.0, -1.0, 90.0, false);
+
+  // The first DC was executed already
+  std::time_t now = Utc("2026/05/01 13:00:00");
+  std::vector<SolXml::ServerDc> planned;
+  std::string error;
+  ASSERT_TRUE(DcSync::ToServer(dcs, now, planned, error)) << error;
+  ASSERT_EQ(planned.size(), 3u);
+
+  // The executed DC 1701 is not deleted on the server
+  auto changes = DcSync::DiffUpload(server, planned, now);
+  ASSERT_EQ(changes.size(), 2u);
+  // Changed DCs keep the ID on the server
+  EXPECT_EQ(changes[0].m_kind, DcSync::Change::kModified);
+  EXPECT_EQ(changes[0].m_dc.m_id, "1702");
+  EXPECT_EQ(changes[0].m_dc.m_value, -120.0);
+  EXPECT_EQ(changes[1].m_kind, DcSync::Change::kAdded);
+  EXPECT_TRUE(changes[1].m_dc.m_id.empty());
+  // Future DCs deleted locally are deleted on the server
+  std::vector<SolXml::ServerDc> remaining(planned.begin() + 1, planned.end());
+  changes = DcSync::DiffUpload(server, remaining, now);
+  for (const auto& change : changes) {
+    if (change.m_kind != DcSync::Change::kRemoved) continue;
+    EXPECT_GT(change.m_dc.m_time, now) << change.m_dc.m_id;
+  }
+  ASSERT_FALSE(changes.empty());
+  EXPECT_EQ(changes[0].m_kind, DcSync::Change::kRemoved);
+  EXPECT_EQ(changes[0].m_dc.m_id, "1702");
+
+  // SOL takes one DC per second
+  dcs.emplace_back(Utc("2026/05/03 00:00:00"), -1.0, -1.0, 95.0, false);
+  EXPECT_FALSE(DcSync::ToServer(dcs, now, planned, error));
+  dcs.pop_back();
+  dcs.back().m_course = 360.0;
+  EXPECT_FALSE(DcSync::ToServer(dcs, now, planned, error));
+}
+}  // namespace
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// Unit tests of the wind grid and its batch kernels
+
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Synthetic.h"
+#include "WindGrid.h"
+#include "WindKernel.h"
+
+namespace {
+/// Points around the DCs of Synthetic::MakeDcs(), a few outside the grid or
+/// the forecast
+struct Points {
+  std::vector<std::time_t> m_t;
+  std::vector<double> m_lat, m_lon;
+
+  explicit Points(size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      m_t.push_back(Synthetic::kStart - 3600 + i * 97);
+      m_lat.push_back(45.0 + 2.0 * std::sin(i * 0.37));
+      m_lon.push_back(-20.0 + 22.0 * std::cos(i * 0.11));
+    }
+  }
+};
+
+WindGrid MakeGrid() {
+  WindGrid grid;
+  EXPECT_TRUE(grid.Parse(Synthetic::MakeWeatherXml(8)));
+  return grid;
+}
+
+TEST(WindKernel, LevelsMatchScalar) {
+  WindGrid grid = MakeGrid();
+  static constexpr size_t kN = 1003;  // Not a multiple of the vector width
+  Points points(kN);
+  std::vector<double> tws0(kN), twd0(kN), tws(kN), twd(kN);
+  grid.SetKernelLevel(WindKernel::Level::kScalar);
+  grid.GetWindDataBatch(kN, points.m_t.data(), points.m_lat.data(),
+                        points.m_lon.data(), tws0.data(), twd0.data());
+
+  for (auto level : {WindKernel::Level::kSse41, WindKernel::Level::kAvx2}) {
+    if (level > WindKernel::GetBestLevel()) continue;
+    SCOPED_TRACE(WindKernel::GetName(level));
+    grid.SetKernelLevel(level);
+    grid.GetWindDataBatch(kN, points.m_t.data(), points.m_lat.data(),
+                          points.m_lon.data(), tws.data(), twd.data());
+    EXPECT_EQ(tws, tws0);
+    EXPECT_EQ(twd, twd0);
+  }
+}
+
+TEST(WindGrid, BatchMatchesSinglePoints) {
+  WindGrid grid = MakeGrid();
+  static constexpr size_t kN = 200;
+  Points points(kN);
+  std::vector<double> tws(kN), twd(kN);
+  grid.GetWindDataBatch(kN, points.m_t.data(), points.m_lat.data(),
+                        points.m_lon.data(), tws.data(), twd.data());
+
+  size_t inside = 0;
+  for (size_t i = 0; i < kN; ++i) {
+    auto [s, d] = grid.GetWindData(points.m_t[i], points.m_lat[i],
+                                   points.m_lon[i]);
+    EXPECT_EQ(s, tws[i]);
+    EXPECT_EQ(d, twd[i]);
+    if (s >= 0.0) ++inside;
+  }
+  EXPECT_GT(inside, kN / 2);
+  EXPECT_LT(inside, kN);
+}
+
+TEST(WindGrid, FollowsTheForecast) {
+  WindGrid grid = MakeGrid();
+  Synthetic::WindField wind;
+  // On the grid points and frames, up to the rounding of the XML
+  for (std::time_t t : {Synthetic::kStart, Synthetic::kStart + 6 * 3600}) {
+    for (double lat : {40.0, 45.5}) {
+      auto [tws, twd] = grid.GetWindData(t, lat, -10.0);
+      auto [e_tws, e_twd] = wind.GetWindData(t, lat, -10.0);
+      EXPECT_NEAR(tws, e_tws, 0.05);
+      EXPECT_NEAR(twd, e_twd, 0.5);
+    }
+  }
+  EXPECT_EQ(grid.GetWindData(Synthetic::kStart, 10.0, -10.0).first, -1.0);
+  EXPECT_EQ(grid.GetWindData(Synthetic::kStart - 1, 45.0, -10.0).first, -1.0);
+}
+
+TEST(WindGrid, BinaryCacheRoundTrip) {
+  WindGrid grid = MakeGrid();
+  std::string path = testing::TempDir() + "sol_weather.bin";
+  ASSERT_TRUE(grid.SaveBinary(path));
+  {
+    WindGrid cached;
+    ASSERT_TRUE(cached.LoadBinary(path));
+    EXPECT_EQ(cached.GetStartTime(), grid.GetStartTime());
+    EXPECT_EQ(cached.GetEndTime(), grid.GetEndTime());
+    Points points(100);
+    for (size_t i = 0; i < 100; ++i)
+      EXPECT_EQ(cached.GetWindData(points.m_t[i], points.m_lat[i],
+                                   points.m_lon[i]),
+                grid.GetWindData(points.m_t[i], points.m_lat[i],
+                                 points.m_lon[i]));
+  }
+  std::remove(path.c_str());
+}
+
+TEST(WindGrid, ParsesInAnyLocale) {
+  WindGrid expected = MakeGrid();
+  std::string xml = Synthetic::MakeWeatherXml(8);
+  // The application may run with a decimal comma, like wxWidgets sets it
+  std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+  bool comma = false;
+  for (const char* name :
+       {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "de_DE"}) {
+    if (std::setlocale(LC_NUMERIC, name) != nullptr &&
+        std::strcmp(std::localeconv()->decimal_point, ",") == 0) {
+      comma = true;
+      break;
+    }
+  }
+  if (!comma) {
+    std::setlocale(LC_NUMERIC, previous.c_str());
+    GTEST_SKIP() << "No locale with a decimal comma installed";
+  }
+
+  WindGrid grid;
+  bool parsed = grid.Parse(xml);
+  std::setlocale(LC_NUMERIC, previous.c_str());
+  ASSERT_TRUE(parsed);
+  Points points(100);
+  for (size_t i = 0; i < 100; ++i)
+    EXPECT_EQ(grid.GetWindData(points.m_t[i], points.m_lat[i],
+                               points.m_lon[i]),
+              expected.GetWindData(points.m_t[i], points.m_lat[i],
+                                   points.m_lon[i]));
+}
+}  // namespace
@@ -0,0 +1,356 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Jan Rheinlnder                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************/
+
+// sol-dc: Batch processing of DC lists without OpenCPN.
+//
+// For every input (DC list or GPX track) the DCs are enriched with wind and
+// boat data, simplified, optimized for maneuvers and simulated, exactly as
+// the "Modify" and "To track" buttons of the plugin do. The resulting DC list
+// (in the format of the "Copy DCs" button) and the simulated track (GPX) are
+// written to the output directory. With a target the DC times are optimized
+// for the earliest arrival there (see DcTiming). Inputs are processed in
+// parallel.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DcFile.h"
+#include "DcModel.h"
+#include "DcTiming.h"
+#include "PerformanceLedger.h"
+#include "Polar.h"
+#include "SolFile.h"
+#include "SolXml.h"
+#include "ThreadPool.h"
+#include "WindGrid.h"
+
+namespace {
+const char* kUsage =
+    "Usage: sol-dc [options] (-r RACEINFO -w WEATHER INPUT...)...\n"
+    "\n"
+    "Inputs are DC lists (\"YYYY/MM/DD HH:MM:SS cc|twa <value> [lat lon]\","
+    " UTC)\n"
+    "or GPX tracks (*.gpx). Each input uses the race info and weather file\n"
+    "given before it on the command line.\n"
+    "\n"
+    "  -r, --raceinfo FILE  Race information (auth_raceinfo_<id>.xml)\n"
+    "  -w, --weather FILE   Weather data of the race (weather_<id>_*.xml)\n"
+    "  -s, --start LAT,LON  Start position for DC lists without positions\n"
+    "  -o, --output DIR     Output directory (default: current directory)\n"
+    "  -t, --tolerance NM   Maximum distance of the DCs from a GPX track\n"
+    "                       (default: 0.5)\n"
+    "      --target LAT,LON Move the DCs for the earliest arrival there\n"
+    "  -j, --jobs N         Number of worker threads (default: all cores)\n"
+    "      --no-simplify    Don't join legs with almost identical courses\n"
+    "      --no-optimize    Don't optimize tacks and jibes\n"
+    "  -h, --help           Show this help\n";
+
+/// Race information and weather shared by all inputs of a race. Immutable
+/// once loaded, so the workers can use it without locking
+struct RaceData {
+  Polar m_polar;
+  WindGrid m_wind;
+};
+
+struct Job {
+  std::string m_input;
+  std::shared_ptr<const RaceData> m_race;
+  bool m_has_start;
+  double m_start_lat;
+  double m_start_lon;
+};
+
+/// Target of the DC timing optimizer
+struct Target {
+  bool m_enabled = false;
+  double m_lat = 0.0;
+  double m_lon = 0.0;
+};
+
+struct Result {
+  bool m_ok = false;
+  std::string m_message;
+};
+
+/// File name of path without directory and extension
+std::string get_stem(const std::string& path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name =
+      slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+bool has_extension(const std::string& path, const std::string& extension) {
+  return path.size() > extension.size() &&
+         path.compare(path.size() - extension.size(), extension.size(),
+                      extension) == 0 &&
+         path.find_first_of("/\\", path.size() - extension.size()) ==
+             std::string::npos;
+}
+
+std::shared_ptr<const RaceData> load_race(const std::string& raceinfo_path,
+                                          const std::string& weather_path,
+                                          std::string& error) {
+  auto race = std::make_shared<RaceData>();
+  std::string contents;
+
+  if (!SolFile::Read(raceinfo_path, contents)) {
+    error = "Could not read " + raceinfo_path;
+    return nullptr;
+  }
+  SolXml::RaceInfo info;
+  if (!SolXml::ParseRaceInfo(contents, info, error)) return nullptr;
+  if (!race->m_polar.Parse(info.m_vpp)) {
+    error = race->m_polar.GetErrors().front();
+    return nullptr;
+  }
+
+  if (!SolFile::Read(weather_path, contents)) {
+    error = "Could not read " + weather_path;
+    return nullptr;
+  }
+  if (!race->m_wind.Parse(contents)) {
+    error = race->m_wind.GetErrors().front();
+    return nullptr;
+  }
+
+  return race;
+}
+
+Result process(const Job& job, const std::string& output_dir, double tolerance,
+               bool simplify, bool optimize, const Target& target) {
+  Result result;
+  std::string contents;
+  if (!SolFile::Read(job.m_input, contents)) {
+    result.m_message = "Could not read file";
+    return result;
+  }
+
+  DcModel model(job.m_race->m_wind, job.m_race->m_polar);
+  std::list<Dc> dcs;
+  std::string error;
+  if (has_extension(job.m_input, ".gpx")) {
+    std::vector<TrackPoint> track;
+    if (!DcFile::ParseGpxTrack(contents, track, error)) {
+      result.m_message = error;
+      return result;
+    }
+    model.CompileDcs(track, tolerance, dcs);
+  } else if (!DcFile::ParseDcList(contents, dcs, error)) {
+    result.m_message = error;
+    return result;
+  }
+  if (dcs.empty()) {
+    result.m_message = "No DCs found";
+    return result;
+  }
+  if (dcs.front().m_lat_start == -1.0 && dcs.front().m_lon_start == -1.0) {
+    if (!job.m_has_start) {
+      result.m_message = "First DC has no position, use --start";
+      return result;
+    }
+    dcs.front().m_lat_start = job.m_start_lat;
+    dcs.front().m_lon_start = job.m_start_lon;
+  }
+  size_t dcs_in = dcs.size();
+
+  model.EnrichDcs(dcs);
+  if (simplify) model.SimplifyDcs(dcs);
+  if (optimize) model.OptimizeManeuvers(dcs);
+  // Inserted DCs need positions and wind data
+  model.EnrichDcs(dcs);
+
+  std::string timing;
+  if (target.m_enabled) {
+    DcModel::Plan plan;
+    model.MakePlan(dcs, plan);
+    DcTiming optimizer(job.m_race->m_wind, job.m_race->m_polar,
+                       DcTimingSettings());
+    DcTimingResult moved;
+    if (optimizer.Optimize(plan, target.m_lat, target.m_lon, moved)) {
+      dcs.swap(plan.m_legs);
+      model.EnrichDcs(dcs);
+      char line[128];
+      std::snprintf(line, sizeof(line), ", %zu DCs moved, ETA %+.1f min%s",
+                    moved.m_changed,
+                    (moved.m_eta_after - moved.m_eta_before) / 60.0,
+                    moved.m_reached ? "" : " (target not reached)");
+      timing = line;
+    }
+  }
+
+  DcFile::TrackRecorder recorder;
+  PerformanceLedger ledger(&recorder);
+  model.MakeTrack(dcs, ledger);
+
+  std::string stem = get_stem(job.m_input);
+  std::string dc_path = output_dir + "/" + stem + ".dcs.txt";
+  std::string gpx_path = output_dir + "/" + stem + ".gpx";
+  if (!SolFile::WriteAtomic(dc_path, DcFile::FormatDcList(dcs), error) ||
+      !SolFile::WriteAtomic(gpx_path,
+                            DcFile::FormatGpxTrack(recorder.m_track, stem),
+                            error)) {
+    result.m_message = error;
+    return result;
+  }
+
+  result.m_ok = true;
+  result.m_message = std::to_string(dcs_in) + " DCs in, " +
+                     std::to_string(dcs.size()) + " DCs out -> " +
+                     dc_path + ", " + gpx_path + timing;
+  char loss[64];
+  std::snprintf(loss, sizeof(loss), ", maneuvers cost %.2f nm (%.1f min)",
+                ledger.GetTotalLoss(), ledger.GetTotalLossSeconds() / 60.0);
+  result.m_message += loss;
+  return result;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string output_dir = ".";
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  double tolerance = DcModel::kRouteTolerance;
+  bool simplify = true, optimize = true;
+  bool has_start = false;
+  double start_lat = 0.0, start_lon = 0.0;
+  Target target;
+  std::string raceinfo_path, weather_path;
+  std::map<std::pair<std::string, std::string>,
+           std::shared_ptr<const RaceData>>
+      races;
+  std::vector<Job> queue;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << arg << "\n" << kUsage;
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+
+    if (arg == "-h" || arg == "--help") {
+      std::cout << kUsage;
+      return 0;
+    } else if (arg == "-r" || arg == "--raceinfo") {
+      raceinfo_path = value();
+    } else if (arg == "-w" || arg == "--weather") {
+      weather_path = value();
+    } else if (arg == "-o" || arg == "--output") {
+      output_dir = value();
+    } else if (arg == "-j" || arg == "--jobs") {
+      jobs = std::max(1, std::atoi(value().c_str()));
+    } else if (arg == "-t" || arg == "--tolerance") {
+      tolerance = std::atof(value().c_str());
+      if (tolerance <= 0.0) {
+        std::cerr << "Invalid tolerance " << argv[i] << "\n";
+        return 2;
+      }
+    } else if (arg == "-s" || arg == "--start") {
+      std::string start = value();
+      has_start = std::sscanf(start.c_str(), "%lf,%lf", &start_lat,
+                              &start_lon) == 2;
+      if (!has_start) {
+        std::cerr << "Invalid start position " << start << "\n";
+        return 2;
+      }
+    } else if (arg == "--target") {
+      std::string position = value();
+      target.m_enabled = std::sscanf(position.c_str(), "%lf,%lf",
+                                     &target.m_lat, &target.m_lon) == 2;
+      if (!target.m_enabled) {
+        std::cerr << "Invalid target " << position << "\n";
+        return 2;
+      }
+    } else if (arg == "--no-simplify") {
+      simplify = false;
+    } else if (arg == "--no-optimize") {
+      optimize = false;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option " << arg << "\n" << kUsage;
+      return 2;
+    } else {
+      if (raceinfo_path.empty() || weather_path.empty()) {
+        std::cerr << arg << ": race info and weather file required\n"
+                  << kUsage;
+        return 2;
+      }
+
+      // Every race is loaded only once, however many inputs it has
+      auto& race = races[{raceinfo_path, weather_path}];
+      if (race == nullptr) {
+        std::string error;
+        race = load_race(raceinfo_path, weather_path, error);
+        if (race == nullptr) {
+          std::cerr << raceinfo_path << ", " << weather_path << ": " << error
+                    << "\n";
+          return 1;
+        }
+      }
+      queue.push_back({arg, race, has_start, start_lat, start_lon});
+    }
+  }
+
+  if (queue.empty()) {
+    std::cerr << kUsage;
+    return 2;
+  }
+
+  // Outputs are named after the inputs and must not overwrite each other
+  std::set<std::string> stems;
+  for (const auto& job : queue) {
+    if (!stems.insert(get_stem(job.m_input)).second) {
+      std::cerr << job.m_input << ": duplicate input name\n";
+      return 2;
+    }
+  }
+
+  if (!SolFile::CreateDirectories(output_dir)) {
+    std::cerr << "Could not create " << output_dir << "\n";
+    return 1;
+  }
+
+  // Results are reported in input order after all inputs are processed
+  std::vector<Result> results(queue.size());
+  ThreadPool pool(std::min<size_t>(jobs, queue.size()) - 1);
+  pool.ParallelFor(queue.size(), [&](size_t i) {
+    results[i] =
+        process(queue[i], output_dir, tolerance, simplify, optimize, target);
+  });
+
+  int status = 0;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    (results[i].m_ok ? std::cout : std::cerr)
+        << queue[i].m_input << ": " << results[i].m_message << "\n";
+    if (!results[i].m_ok) status = 1;
+  }
+
+  return status;
+}